@@ -18,6 +18,13 @@ var utf8 = require('utf8');
 var isIOS = require('react-native').Platform.OS === 'ios';
 var isWindows = require('react-native').Platform.OS === 'windows'; // To accommodate Windows
 
+// The Windows module delivers its events in batches, about one per frame; hand each to its listeners
+if (isWindows) {
+  RNFS_NativeEventEmitter.addListener('RNFSEventBatch', (events) => {
+    events.forEach((event) => RNFS_NativeEventEmitter.emit(event.name, event.body));
+  });
+}
+
 var RNFSFileTypeRegular = RNFSManager.RNFSFileTypeRegular;
 var RNFSFileTypeDirectory = RNFSManager.RNFSFileTypeDirectory;
 
@@ -30,13 +37,58 @@ var getJobId = () => {
 
 var normalizeFilePath = (path: string) => (path.startsWith('file://') ? path.slice(7) : path);
 
+// The part of a file operation's options that the Windows module takes: its job for `cancelJob` and its I/O priority
+var windowsOptions = (options: any) => {
+  var result = {};
+  if (options && typeof options === 'object') {
+    if (typeof options.jobId === 'number') result.jobId = options.jobId;
+    if (typeof options.priority === 'string') result.priority = options.priority;
+  }
+  return result;
+};
+
 type MkdirOptions = {
   NSURLIsExcludedFromBackupKey?: boolean; // iOS only
   NSFileProtectionKey?: string; // IOS only
+  priority?: 'interactive' | 'normal' | 'background'; // (Windows only) I/O scheduler lane, default is 'normal'
 };
 
 type FileOptions = {
   NSFileProtectionKey?: string; // IOS only
+  jobId?: number; // (Windows only) Lets `cancelJob` stop the copy
+  priority?: 'interactive' | 'normal' | 'background'; // (Windows only) I/O scheduler lane, default is 'normal'
+};
+
+type JobOptions = {
+  jobId?: number; // (Windows only) Lets `cancelJob` stop the operation
+  priority?: 'interactive' | 'normal' | 'background'; // (Windows only) I/O scheduler lane, default is 'normal'
+};
+
+type OpenWriteOptions = {
+  append?: boolean;      // Write after the current contents instead of truncating the file
+  bufferSize?: number;   // Bytes gathered before they are written to the file, default 1 MB
+  idleTimeout?: number;  // Milliseconds without a call before the session is closed for you, default 60000
+  priority?: 'interactive' | 'normal' | 'background'; // I/O scheduler lane, default is 'normal'
+};
+
+type CloseWriteOptions = {
+  fsync?: boolean;       // Flush the file to the disk before resolving
+};
+
+type CloseWriteResult = {
+  bytesWritten: number;
+};
+
+type OpenReadOptions = {
+  chunkSize?: number;    // Bytes per chunk, default 256 KB
+  readAhead?: number;    // Chunks read ahead of the one taken, default 2
+  idleTimeout?: number;  // Milliseconds without a call before the session is closed for you, default 60000
+  priority?: 'interactive' | 'normal' | 'background'; // I/O scheduler lane of reads you wait for, default is 'normal'
+};
+
+type ReadChunkResult = {
+  data: string;
+  eof: boolean;          // No chunk follows this one
 };
 
 type ReadDirItem = {
@@ -49,6 +101,30 @@ type ReadDirItem = {
   isDirectory: () => boolean;   // Is the file a directory?
 };
 
+type ReadDirOptions = {
+  columnar?: boolean; // (Windows only) Resolve with one array per field instead of an item per entry
+  fields?: Array<'name' | 'path' | 'size' | 'mtime' | 'ctime' | 'type'>; // (Windows only) Only read these fields, default is all of them
+};
+
+type ReadDirColumns = {
+  count: number;       // Number of entries
+  names?: string[];
+  paths?: string[];
+  sizes?: number[];    // Size in bytes
+  mtimes?: number[];   // Last modified date, in seconds since the epoch
+  ctimes?: number[];   // Created date, in seconds since the epoch
+  types?: number[];    // RNFSFileTypeDirectory or RNFSFileTypeRegular
+};
+
+type StatBatchResult = {
+  count: number;       // Number of paths, each array has an element per path in the same order
+  exists: boolean[];   // The other fields are 0 for a path that does not exist
+  sizes?: number[];
+  mtimes?: number[];
+  ctimes?: number[];
+  types?: number[];
+};
+
 type StatResult = {
   name: ?string;     // The name of the item TODO: why is this not documented?
   path: string;     // The absolute path to the item
@@ -76,9 +152,41 @@ type DownloadFileOptions = {
   begin?: (res: DownloadBeginCallbackResult) => void;
   progress?: (res: DownloadProgressCallbackResult) => void;
   resumable?: () => void;    // only supported on iOS yet
-  connectionTimeout?: number; // only supported on Android yet
-  readTimeout?: number;       // supported on Android and iOS
+  connectionTimeout?: number; // supported on Android and Windows
+  readTimeout?: number;       // supported on Android, iOS and Windows
   backgroundTimeout?: number; // Maximum time (in milliseconds) to download an entire resource (iOS only, useful for timing out background downloads)
+  checksum?: DownloadChecksum; // Verify the downloaded bytes while writing them (Windows only)
+  decompress?: 'gzip' | 'deflate' | 'auto'; // Decompress the response body before writing it to `toFile` (Windows only)
+  preallocate?: boolean;    // Reserve the announced Content-Length on disk before writing, default is true (Windows only)
+  cache?: boolean;          // Revalidate a stored copy with If-None-Match/If-Modified-Since and reuse it on 304 (Windows only)
+  maxBytesPerSecond?: number; // Limit the download rate of this job, see `setBandwidthLimit` (Windows only)
+  priority?: 'interactive' | 'normal' | 'background'; // HTTP client pool to use, see `configureHttpClient` (Windows only)
+  retry?: RetryOptions;     // Retry failed attempts, resuming from the last byte received when possible (Windows only)
+};
+
+type RetryOptions = {
+  maxAttempts?: number;     // Attempts in total, including the first, default 3
+  initialDelay?: number;    // Milliseconds before the first retry, doubling for each further one, default 500
+  maxDelay?: number;        // Longest wait between attempts, default 30000; a longer Retry-After ends the retries
+  retryableStatusCodes?: number[]; // Default [408, 429, 500, 502, 503, 504]
+};
+
+type HttpClientOptions = {
+  priority?: 'interactive' | 'normal' | 'background'; // Pool to configure, default is 'normal'
+  maxConnectionsPerServer?: number;
+  httpVersion?: '1.1' | '2';  // Highest HTTP version to negotiate
+  bypassCache?: boolean;      // Skip the system HTTP cache
+  keepAlive?: boolean;        // Reuse connections between requests
+};
+
+type AppendCoalescingOptions = {
+  maxDelay?: number;          // Milliseconds an append may wait for others to share its write
+  maxBytes?: number;          // Largest write appends are merged into
+};
+
+type DownloadChecksum = {
+  algorithm: string;  // One of the algorithms supported by `hash`
+  expected: string;   // The expected hex digest of the downloaded file
 };
 
 type DownloadBeginCallbackResult = {
@@ -92,12 +200,113 @@ type DownloadProgressCallbackResult = {
   jobId: number;          // The download job ID, required if one wishes to cancel the download. See `stopDownload`.
   contentLength: number;  // The total size in bytes of the download resource
   bytesWritten: number;   // The number of bytes written to the file so far
+  bytesRead?: number;     // The number of bytes received so far, before decompression (Windows only)
 };
 
 type DownloadResult = {
   jobId: number;          // The download job ID, required if one wishes to cancel the download. See `stopDownload`.
   statusCode: number;     // The HTTP status code
   bytesWritten: number;   // The number of bytes written to the file
+  bytesRead?: number;     // The number of bytes received, before decompression (Windows only)
+  fromCache?: boolean;    // Whether the file was served from the download cache (Windows only)
+  attempts?: number;      // Requests made, including retries (Windows only)
+};
+
+type FetchToMemoryOptions = {
+  fromUrl: string;          // URL to fetch
+  headers?: Headers;        // An object of headers to be passed to the server
+  maxSize?: number;         // Largest body accepted in bytes, default 10 MiB
+  encoding?: 'base64' | 'utf8'; // Encoding of `body` in the result, default 'base64'
+  readTimeout?: number;     // Default is 15000ms
+  connectionTimeout?: number; // Default is 5000ms
+  maxBytesPerSecond?: number; // Limit the rate of this job, see `setBandwidthLimit`
+  priority?: 'interactive' | 'normal' | 'background'; // HTTP client pool to use, see `configureHttpClient`
+  retry?: RetryOptions;     // Retry failed requests, see `downloadFile`
+};
+
+type FetchResult = {
+  jobId: number;          // The job ID, which `stopDownload` accepts
+  statusCode: number;     // The HTTP status code
+  headers: Headers;       // The HTTP response headers from the server
+  body: string;           // The response body in the requested encoding
+  bytesRead: number;      // The number of bytes received
+  attempts: number;       // Requests made, including retries
+};
+
+type DownloadCacheStats = {
+  hits: number;           // Downloads answered with 304 and served from the cache
+  misses: number;         // Cached downloads that had to be transferred
+  bytesServed: number;    // Bytes copied out of the cache instead of downloaded
+};
+
+type DownloadCacheOptions = {
+  folder?: string;        // Absolute path of the folder the cache keeps its files in, '' for the default
+};
+
+type UploadJournalOptions = {
+  folder?: string;        // Absolute path of the folder resumable uploads are journaled in, '' for the default
+};
+
+type OperationStats = {
+  calls: number;          // Calls that finished since the last reset
+  inFlight: number;       // Calls still running
+  errors: number;         // Calls that were rejected
+  errorCodes: { [code: string]: number }; // Rejections by code, such as ENOENT or CANCELLED
+  bytesIn: number;        // Bytes read from files or received
+  bytesOut: number;       // Bytes written to files or sent
+  meanMs: number;
+  p50Ms: number;          // Upper bound of the latency bucket holding the median call
+  p99Ms: number;
+  histogram: number[];    // Calls per latency bucket: under 1 µs, then [2^(i-1), 2^i) µs
+};
+
+type IoLaneStats = {
+  scheduled: number;      // Calls admitted since the last reset
+  queued: number;         // Calls waiting for a slot right now
+  meanWaitMs: number;
+  p50WaitMs: number;      // Upper bound of the wait bucket holding the median call
+  p99WaitMs: number;
+  maxWaitMs: number;
+};
+
+type EventStats = {
+  posted: number;         // Begin and progress events raised by transfers
+  superseded: number;     // Progress events dropped for a newer one of the same job before delivery
+  delivered: number;
+  batches: number;        // Bridge calls that carried the delivered events
+};
+
+type SessionStats = {
+  open: number;
+  opened: number;
+  expired: number;        // Closed for being idle rather than by closeRead or closeWrite
+};
+
+type AppendStats = {
+  appends: number;
+  writes: number;         // Writes the appends were merged into
+  bytes: number;
+  pending: number;        // Files with appends not written yet
+};
+
+type Stats = {
+  since: number;          // When the counters were last reset, in milliseconds since 1970
+  operations: { [method: string]: OperationStats };
+  io: {
+    workers: number;      // File operations that may run at once
+    lanes: { interactive: IoLaneStats; normal: IoLaneStats; background: IoLaneStats };
+  };
+  events: EventStats;
+  writeSessions: SessionStats;
+  readSessions: SessionStats;
+  appends: AppendStats;
+};
+
+type JobInfo = {
+  jobId: number;
+  state: 'queued' | 'running' | 'paused'; // Paused while waiting to retry
+  bytesTransferred: number;
+  bytesExpected: number;  // 0 while unknown
 };
 
 type UploadFileOptions = {
@@ -107,6 +316,16 @@ type UploadFileOptions = {
   headers?: Headers;        // An object of headers to be passed to the server
   fields?: Fields;          // An object of fields to be passed to the server
   method?: string;          // Default is 'POST', supports 'POST' and 'PUT'
+  progressInterval?: number; // (Windows only) Minimum milliseconds between progress events, default 100
+  resumable?: boolean;      // (Windows only) Upload each file with the tus resumable upload protocol, default false
+  chunkSize?: number;       // (Windows only) Bytes sent per request in resumable uploads, default 4 MiB, at most 64 MiB
+  parallel?: boolean;       // (Windows only) Send each file as its own request, default false
+  maxConcurrent?: number;   // (Windows only) Requests in flight for parallel uploads, default 4
+  retries?: number;         // (Windows only) Extra attempts per file for parallel uploads, default 0
+  compress?: 'gzip';        // (Windows only) Compress the request body while it is sent
+  maxBytesPerSecond?: number; // (Windows only) Limit the upload rate of this job, see `setBandwidthLimit`
+  priority?: 'interactive' | 'normal' | 'background'; // (Windows only) HTTP client pool to use, see `configureHttpClient`
+  retry?: RetryOptions;     // (Windows only) Retry failed requests, see `downloadFile`
   beginCallback?: (res: UploadBeginCallbackResult) => void; // deprecated
   progressCallback?: (res: UploadProgressCallbackResult) => void; // deprecated
   begin?: (res: UploadBeginCallbackResult) => void;
@@ -116,8 +335,10 @@ type UploadFileOptions = {
 type UploadFileItem = {
   name: string;       // Name of the file, if not defined then filename is used
   filename: string;   // Name of file
-  filepath: string;   // Path to file
+  filepath?: string;  // Path to file, unless `data` is given
   filetype: string;   // The mimetype of the file to be uploaded, if not defined it will get mimetype from `filepath` extension
+  data?: string;      // (Windows only) Contents to send instead of reading `filepath`
+  encoding?: 'base64' | 'utf8'; // (Windows only) Encoding of `data`, default 'base64'
 };
 
 type UploadBeginCallbackResult = {
@@ -128,6 +349,9 @@ type UploadProgressCallbackResult = {
   jobId: number;                      // The upload job ID, required if one wishes to cancel the upload. See `stopUpload`.
   totalBytesExpectedToSend: number;   // The total number of bytes that will be sent to the server
   totalBytesSent: number;             // The number of bytes sent to the server
+  fileIndex?: number;                 // (Windows only) Parallel uploads: index of the file this event is about
+  fileBytesExpectedToSend?: number;   // (Windows only) Parallel uploads: size of that file
+  fileBytesSent?: number;             // (Windows only) Parallel uploads: bytes of that file sent so far
 };
 
 type UploadResult = {
@@ -135,6 +359,20 @@ type UploadResult = {
   statusCode: number;   // The HTTP status code
   headers: Headers;     // The HTTP response headers from the server
   body: string;         // The HTTP response body
+  uploadUrls?: string[]; // (Windows only) Resumable uploads: the upload URL of each file
+  files?: UploadFileResult[]; // (Windows only) Parallel uploads: the outcome of each file
+  attempts?: number;    // (Windows only) Requests made, including retries
+  retries?: number;     // (Windows only) Resumable uploads: chunks sent again after a failure
+};
+
+type UploadFileResult = {
+  index: number;        // Position of the file in `options.files`
+  filepath: string;
+  attempts: number;     // Requests made for this file
+  statusCode?: string;  // The HTTP status code of the last attempt
+  headers?: string;     // The HTTP response headers of the last attempt
+  body?: string;        // The HTTP response body of the last attempt
+  error?: string;       // Set when no response was received
 };
 
 type FSInfoResult = {
@@ -207,9 +445,9 @@ var RNFS = {
   },
 
   // Windows workaround for slow copying of large folders of files
-  copyFolder(filepath: string, destPath: string): Promise<void> {
+  copyFolder(filepath: string, destPath: string, options: JobOptions = {}): Promise<void> {
     if(isWindows) {
-      return RNFSManager.copyFolder(normalizeFilePath(filepath), normalizeFilePath(destPath));
+      return RNFSManager.copyFolder(normalizeFilePath(filepath), normalizeFilePath(destPath), windowsOptions(options));
     }
   },
 
@@ -229,7 +467,10 @@ var RNFS = {
     return RNFSManager.getAllExternalFilesDirs();
   },
 
-  unlink(filepath: string): Promise<void> {
+  unlink(filepath: string, options: JobOptions = {}): Promise<void> {
+    if (isWindows) {
+      return RNFSManager.unlink(normalizeFilePath(filepath), windowsOptions(options)).then(() => void 0);
+    }
     return RNFSManager.unlink(normalizeFilePath(filepath)).then(() => void 0);
   },
 
@@ -249,15 +490,82 @@ var RNFS = {
     return RNFSManager.isResumable(jobId);
   },
 
+  // Windows-only
+  getDownloadCacheStats(): Promise<DownloadCacheStats> {
+    return RNFSManager.getDownloadCacheStats();
+  },
+
+  // Windows-only
+  configureDownloadCache(options: DownloadCacheOptions): Promise<void> {
+    if (typeof options !== 'object') throw new Error('configureDownloadCache: Invalid value for argument `options`');
+    if (options.folder !== undefined && typeof options.folder !== 'string') throw new Error('configureDownloadCache: Invalid value for property `folder`');
+    return RNFSManager.configureDownloadCache({ folder: options.folder || '' });
+  },
+
+  // Windows-only
+  configureUploadJournal(options: UploadJournalOptions): Promise<void> {
+    if (typeof options !== 'object') throw new Error('configureUploadJournal: Invalid value for argument `options`');
+    if (options.folder !== undefined && typeof options.folder !== 'string') throw new Error('configureUploadJournal: Invalid value for property `folder`');
+    return RNFSManager.configureUploadJournal({ folder: options.folder || '' });
+  },
+
+  // Windows-only
+  getStats(): Promise<Stats> {
+    return RNFSManager.getStats();
+  },
+
+  // Windows-only
+  resetStats(): Promise<void> {
+    return RNFSManager.resetStats();
+  },
+
+  // Windows-only
+  getJobs(): Promise<JobInfo[]> {
+    return RNFSManager.getJobs();
+  },
+
+  // Windows-only
+  configureHttpClient(options: HttpClientOptions): Promise<void> {
+    if (typeof options !== 'object') throw new Error('configureHttpClient: Invalid value for argument `options`');
+    return RNFSManager.configureHttpClient(options);
+  },
+
+  // Windows-only
+  configureAppendCoalescing(options: AppendCoalescingOptions): Promise<void> {
+    if (typeof options !== 'object') throw new Error('configureAppendCoalescing: Invalid value for argument `options`');
+    return RNFSManager.configureAppendCoalescing(options);
+  },
+
+  // Windows-only
+  setBandwidthLimit(maxBytesPerSecond: number, jobId?: number): Promise<void> {
+    if (typeof maxBytesPerSecond !== 'number' || maxBytesPerSecond < 0) throw new Error('setBandwidthLimit: Invalid value for argument `maxBytesPerSecond`');
+    var options = jobId === undefined ? { maxBytesPerSecond } : { maxBytesPerSecond, jobId };
+    return RNFSManager.setBandwidthLimit(options);
+  },
+
   stopUpload(jobId: number): void {
     RNFSManager.stopUpload(jobId);
   },
 
+  // Windows-only
+  cancelJob(jobId: number): void {
+    RNFSManager.cancelJob(jobId);
+  },
+
   completeHandlerIOS(jobId: number): void {
     return RNFSManager.completeHandlerIOS(jobId);
   },
 
-  readDir(dirpath: string): Promise<ReadDirItem[]> {
+  readDir(dirpath: string, options?: ReadDirOptions): Promise<ReadDirItem[] | ReadDirColumns> {
+    if (isWindows) {
+      var readDirOptions = {};
+      if (options && options.columnar) readDirOptions.columnar = true;
+      if (options && options.fields) readDirOptions.fields = options.fields;
+      if (readDirOptions.columnar) {
+        return RNFSManager.readDir(normalizeFilePath(dirpath), readDirOptions);
+      }
+      return readDirGeneric(dirpath, (path) => RNFSManager.readDir(path, readDirOptions));
+    }
     return readDirGeneric(dirpath, RNFSManager.readDir);
   },
 
@@ -287,6 +595,9 @@ var RNFS = {
 
   // Node style version (lowercase d). Returns just the names
   readdir(dirpath: string): Promise<string[]> {
+    if (isWindows) {
+      return RNFSManager.readDir(normalizeFilePath(dirpath), { columnar: true, fields: ['name'] }).then(columns => columns.names);
+    }
     return RNFS.readDir(normalizeFilePath(dirpath)).then(files => {
       return files.map(file => file.name);
     });
@@ -299,6 +610,13 @@ var RNFS = {
     })
   },
 
+  // Windows-only
+  statBatch(filepaths: string[], options?: ReadDirOptions): Promise<StatBatchResult> {
+    var statOptions = {};
+    if (options && options.fields) statOptions.fields = options.fields;
+    return RNFSManager.statBatch(filepaths.map(normalizeFilePath), statOptions);
+  },
+
   stat(filepath: string): Promise<StatResult> {
     return RNFSManager.stat(normalizeFilePath(filepath)).then((result) => {
       return {
@@ -315,6 +633,9 @@ var RNFS = {
   },
 
   readFile(filepath: string, encodingOrOptions?: any): Promise<string> {
+    if (isWindows) {
+      return readFileGeneric(filepath, encodingOrOptions, (path) => RNFSManager.readFile(path, windowsOptions(encodingOrOptions)));
+    }
     return readFileGeneric(filepath, encodingOrOptions, RNFSManager.readFile);
   },
 
@@ -364,7 +685,10 @@ var RNFS = {
     return readFileGeneric(filename, encodingOrOptions, RNFSManager.readFileRes);
   },
 
-  hash(filepath: string, algorithm: string): Promise<string> {
+  hash(filepath: string, algorithm: string, options: JobOptions = {}): Promise<string> {
+    if (isWindows) {
+      return RNFSManager.hash(normalizeFilePath(filepath), algorithm, windowsOptions(options));
+    }
     return RNFSManager.hash(normalizeFilePath(filepath), algorithm);
   },
 
@@ -492,6 +816,62 @@ var RNFS = {
     return RNFSManager.write(normalizeFilePath(filepath), b64, position).then(() => void 0);
   },
 
+  // Windows-only
+  openWrite(filepath: string, options: OpenWriteOptions = {}): Promise<number> {
+    return RNFSManager.openWrite(normalizeFilePath(filepath), options);
+  },
+
+  // Windows-only
+  writeChunk(sessionId: number, contents: string, encoding?: string): Promise<void> {
+    var b64;
+
+    if (!encoding || encoding === 'utf8') {
+      b64 = base64.encode(utf8.encode(contents));
+    } else if (encoding === 'ascii') {
+      b64 = base64.encode(contents);
+    } else if (encoding === 'base64') {
+      b64 = contents;
+    } else {
+      throw new Error('Invalid encoding type "' + encoding + '"');
+    }
+
+    return RNFSManager.writeChunk(sessionId, b64).then(() => void 0);
+  },
+
+  // Windows-only
+  closeWrite(sessionId: number, options: CloseWriteOptions = {}): Promise<CloseWriteResult> {
+    return RNFSManager.closeWrite(sessionId, options);
+  },
+
+  // Windows-only
+  openRead(filepath: string, options: OpenReadOptions = {}): Promise<number> {
+    return RNFSManager.openRead(normalizeFilePath(filepath), options);
+  },
+
+  // Windows-only
+  readChunk(sessionId: number, encoding?: string): Promise<ReadChunkResult> {
+    return RNFSManager.readChunk(sessionId).then((chunk) => {
+      var data;
+
+      if (!encoding || encoding === 'utf8') {
+        data = utf8.decode(base64.decode(chunk.data));
+      } else if (encoding === 'ascii') {
+        data = base64.decode(chunk.data);
+      } else if (encoding === 'base64') {
+        data = chunk.data;
+      } else {
+        throw new Error('Invalid encoding type "' + String(encoding) + '"');
+      }
+
+      return { data: data, eof: chunk.eof };
+    });
+  },
+
+  // Windows-only
+  closeRead(sessionId: number): Promise<void> {
+    return RNFSManager.closeRead(sessionId).then(() => void 0);
+  },
+
   downloadFile(options: DownloadFileOptions): { jobId: number, promise: Promise<DownloadResult> } {
     if (typeof options !== 'object') throw new Error('downloadFile: Invalid value for argument `options`');
     if (typeof options.fromUrl !== 'string') throw new Error('downloadFile: Invalid value for property `fromUrl`');
@@ -503,6 +883,13 @@ var RNFS = {
     if (options.readTimeout && typeof options.readTimeout !== 'number') throw new Error('downloadFile: Invalid value for property `readTimeout`');
     if (options.connectionTimeout && typeof options.connectionTimeout !== 'number') throw new Error('downloadFile: Invalid value for property `connectionTimeout`');
     if (options.backgroundTimeout && typeof options.backgroundTimeout !== 'number') throw new Error('downloadFile: Invalid value for property `backgroundTimeout`');
+    if (options.checksum && typeof options.checksum !== 'object') throw new Error('downloadFile: Invalid value for property `checksum`');
+    if (options.decompress && typeof options.decompress !== 'string') throw new Error('downloadFile: Invalid value for property `decompress`');
+    if (options.preallocate !== undefined && typeof options.preallocate !== 'boolean') throw new Error('downloadFile: Invalid value for property `preallocate`');
+    if (options.cache && typeof options.cache !== 'boolean') throw new Error('downloadFile: Invalid value for property `cache`');
+    if (options.maxBytesPerSecond && typeof options.maxBytesPerSecond !== 'number') throw new Error('downloadFile: Invalid value for property `maxBytesPerSecond`');
+    if (options.priority && typeof options.priority !== 'string') throw new Error('downloadFile: Invalid value for property `priority`');
+    if (options.retry && typeof options.retry !== 'object') throw new Error('downloadFile: Invalid value for property `retry`');
 
     var jobId = getJobId();
     var subscriptions = [];
@@ -536,6 +923,13 @@ var RNFS = {
       readTimeout: options.readTimeout || 15000,
       connectionTimeout: options.connectionTimeout || 5000,
       backgroundTimeout: options.backgroundTimeout || 3600000, // 1 hour
+      checksum: options.checksum || {},
+      decompress: options.decompress || '',
+      preallocate: options.preallocate !== false,
+      cache: !!options.cache,
+      maxBytesPerSecond: options.maxBytesPerSecond || 0,
+      priority: options.priority || 'normal',
+      retry: options.retry || {},
       hasBeginCallback: options.begin instanceof Function,
       hasProgressCallback: options.progress instanceof Function,
       hasResumableCallback: options.resumable instanceof Function,
@@ -553,6 +947,40 @@ var RNFS = {
     };
   },
 
+  // Windows-only
+  fetchToMemory(options: FetchToMemoryOptions): { jobId: number, promise: Promise<FetchResult> } {
+    if (typeof options !== 'object') throw new Error('fetchToMemory: Invalid value for argument `options`');
+    if (typeof options.fromUrl !== 'string') throw new Error('fetchToMemory: Invalid value for property `fromUrl`');
+    if (options.headers && typeof options.headers !== 'object') throw new Error('fetchToMemory: Invalid value for property `headers`');
+    if (options.maxSize && (typeof options.maxSize !== 'number' || options.maxSize < 0)) throw new Error('fetchToMemory: Invalid value for property `maxSize`');
+    if (options.encoding && typeof options.encoding !== 'string') throw new Error('fetchToMemory: Invalid value for property `encoding`');
+    if (options.readTimeout && typeof options.readTimeout !== 'number') throw new Error('fetchToMemory: Invalid value for property `readTimeout`');
+    if (options.connectionTimeout && typeof options.connectionTimeout !== 'number') throw new Error('fetchToMemory: Invalid value for property `connectionTimeout`');
+    if (options.maxBytesPerSecond && typeof options.maxBytesPerSecond !== 'number') throw new Error('fetchToMemory: Invalid value for property `maxBytesPerSecond`');
+    if (options.priority && typeof options.priority !== 'string') throw new Error('fetchToMemory: Invalid value for property `priority`');
+    if (options.retry && typeof options.retry !== 'object') throw new Error('fetchToMemory: Invalid value for property `retry`');
+
+    var jobId = getJobId();
+
+    var bridgeOptions = {
+      jobId: jobId,
+      fromUrl: options.fromUrl,
+      headers: options.headers || {},
+      maxSize: options.maxSize || 0,
+      encoding: options.encoding || 'base64',
+      readTimeout: options.readTimeout || 15000,
+      connectionTimeout: options.connectionTimeout || 5000,
+      maxBytesPerSecond: options.maxBytesPerSecond || 0,
+      priority: options.priority || 'normal',
+      retry: options.retry || {},
+    };
+
+    return {
+      jobId,
+      promise: RNFSManager.fetchToMemory(bridgeOptions)
+    };
+  },
+
   uploadFiles(options: UploadFileOptions): { jobId: number, promise: Promise<UploadResult> } {
     if (!RNFSManager.uploadFiles) {
       return {
@@ -570,6 +998,14 @@ var RNFS = {
     if (options.headers && typeof options.headers !== 'object') throw new Error('uploadFiles: Invalid value for property `headers`');
     if (options.fields && typeof options.fields !== 'object') throw new Error('uploadFiles: Invalid value for property `fields`');
     if (options.method && typeof options.method !== 'string') throw new Error('uploadFiles: Invalid value for property `method`');
+    if (options.progressInterval && typeof options.progressInterval !== 'number') throw new Error('uploadFiles: Invalid value for property `progressInterval`');
+    if (options.chunkSize && (typeof options.chunkSize !== 'number' || options.chunkSize <= 0)) throw new Error('uploadFiles: Invalid value for property `chunkSize`');
+    if (options.maxConcurrent && (typeof options.maxConcurrent !== 'number' || options.maxConcurrent <= 0)) throw new Error('uploadFiles: Invalid value for property `maxConcurrent`');
+    if (options.retries && (typeof options.retries !== 'number' || options.retries < 0)) throw new Error('uploadFiles: Invalid value for property `retries`');
+    if (options.compress && typeof options.compress !== 'string') throw new Error('uploadFiles: Invalid value for property `compress`');
+    if (options.maxBytesPerSecond && typeof options.maxBytesPerSecond !== 'number') throw new Error('uploadFiles: Invalid value for property `maxBytesPerSecond`');
+    if (options.priority && typeof options.priority !== 'string') throw new Error('uploadFiles: Invalid value for property `priority`');
+    if (options.retry && typeof options.retry !== 'object') throw new Error('uploadFiles: Invalid value for property `retry`');
 
     if (options.begin) {
       subscriptions.push(RNFS_NativeEventEmitter.addListener('UploadBegin', options.begin));
@@ -593,6 +1029,16 @@ var RNFS = {
       headers: options.headers || {},
       fields: options.fields || {},
       method: options.method || 'POST',
+      progressInterval: options.progressInterval || 0,
+      resumable: options.resumable || false,
+      chunkSize: options.chunkSize || 0,
+      parallel: options.parallel || false,
+      maxConcurrent: options.maxConcurrent || 0,
+      retries: options.retries || 0,
+      compress: options.compress || '',
+      maxBytesPerSecond: options.maxBytesPerSecond || 0,
+      priority: options.priority || 'normal',
+      retry: options.retry || {},
       hasBeginCallback: options.begin instanceof Function || options.beginCallback instanceof Function,
       hasProgressCallback: options.progress instanceof Function || options.progressCallback instanceof Function,
     };
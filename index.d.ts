@@ -1,10 +1,45 @@
 type MkdirOptions = {
 	NSURLIsExcludedFromBackupKey?: boolean // iOS only
 	NSFileProtectionKey?: string // IOS only
+	priority?: TransferPriority // I/O scheduler lane, default is 'normal' (Windows only)
 }
 
 type FileOptions = {
 	NSFileProtectionKey?: string // IOS only
+	jobId?: number // Lets `cancelJob` stop the copy (Windows only)
+	priority?: TransferPriority // I/O scheduler lane, default is 'normal' (Windows only)
+}
+
+type JobOptions = {
+	jobId?: number // Lets `cancelJob` stop the operation (Windows only)
+	priority?: TransferPriority // I/O scheduler lane, default is 'normal' (Windows only)
+}
+
+type OpenWriteOptions = {
+	append?: boolean // Write after the current contents instead of truncating the file
+	bufferSize?: number // Bytes gathered before they are written to the file, default 1 MB
+	idleTimeout?: number // Milliseconds without a call before the session is closed for you, default 60000
+	priority?: TransferPriority // I/O scheduler lane, default is 'normal'
+}
+
+type CloseWriteOptions = {
+	fsync?: boolean // Flush the file to the disk before resolving
+}
+
+type CloseWriteResult = {
+	bytesWritten: number
+}
+
+type OpenReadOptions = {
+	chunkSize?: number // Bytes per chunk, default 256 KB
+	readAhead?: number // Chunks read ahead of the one taken, default 2
+	idleTimeout?: number // Milliseconds without a call before the session is closed for you, default 60000
+	priority?: TransferPriority // I/O scheduler lane of reads you wait for, default is 'normal'
+}
+
+type ReadChunkResult = {
+	data: string
+	eof: boolean // No chunk follows this one
 }
 
 type ReadDirItem = {
@@ -17,6 +52,32 @@ type ReadDirItem = {
 	isDirectory: () => boolean // Is the file a directory?
 }
 
+type ReadDirField = 'name' | 'path' | 'size' | 'mtime' | 'ctime' | 'type'
+
+type ReadDirOptions = {
+	columnar?: boolean // Resolve with one array per field instead of an item per entry (Windows only)
+	fields?: ReadDirField[] // Only read these fields, default is all of them (Windows only)
+}
+
+type ReadDirColumns = {
+	count: number // Number of entries
+	names?: string[]
+	paths?: string[]
+	sizes?: number[] // Size in bytes
+	mtimes?: number[] // Last modified date, in seconds since the epoch
+	ctimes?: number[] // Created date, in seconds since the epoch
+	types?: number[] // RNFSFileTypeDirectory or RNFSFileTypeRegular
+}
+
+type StatBatchResult = {
+	count: number // Number of paths, each array has an element per path in the same order
+	exists: boolean[] // The other fields are 0 for a path that does not exist
+	sizes?: number[]
+	mtimes?: number[]
+	ctimes?: number[]
+	types?: number[]
+}
+
 type StatResult = {
 	name: string | undefined // The name of the item TODO: why is this not documented?
 	path: string // The absolute path to the item
@@ -44,9 +105,28 @@ type DownloadFileOptions = {
 	begin?: (res: DownloadBeginCallbackResult) => void
 	progress?: (res: DownloadProgressCallbackResult) => void
 	resumable?: () => void // only supported on iOS yet
-	connectionTimeout?: number // only supported on Android yet
-	readTimeout?: number // supported on Android and iOS
+	connectionTimeout?: number // supported on Android and Windows
+	readTimeout?: number // supported on Android, iOS and Windows
 	backgroundTimeout?: number // Maximum time (in milliseconds) to download an entire resource (iOS only, useful for timing out background downloads)
+	checksum?: DownloadChecksum // Verify the downloaded bytes while writing them (Windows only)
+	decompress?: 'gzip' | 'deflate' | 'auto' // Decompress the response body before writing it to `toFile` (Windows only)
+	preallocate?: boolean // Reserve the announced Content-Length on disk before writing, default is true (Windows only)
+	cache?: boolean // Revalidate a stored copy with If-None-Match/If-Modified-Since and reuse it on 304 (Windows only)
+	maxBytesPerSecond?: number // Limit the download rate of this job, see `setBandwidthLimit` (Windows only)
+	priority?: TransferPriority // HTTP client pool to use, see `configureHttpClient` (Windows only)
+	retry?: RetryOptions // Retry failed attempts, resuming from the last byte received when possible (Windows only)
+}
+
+type RetryOptions = {
+	maxAttempts?: number // Attempts in total, including the first, default 3
+	initialDelay?: number // Milliseconds before the first retry, doubling for each further one, default 500
+	maxDelay?: number // Longest wait between attempts, default 30000; a longer Retry-After ends the retries
+	retryableStatusCodes?: number[] // Default [408, 429, 500, 502, 503, 504]
+}
+
+type DownloadChecksum = {
+	algorithm: string // One of the algorithms supported by `hash`
+	expected: string // The expected hex digest of the downloaded file
 }
 
 type DownloadBeginCallbackResult = {
@@ -60,12 +140,113 @@ type DownloadProgressCallbackResult = {
 	jobId: number // The download job ID, required if one wishes to cancel the download. See `stopDownload`.
 	contentLength: number // The total size in bytes of the download resource
 	bytesWritten: number // The number of bytes written to the file so far
+	bytesRead?: number // The number of bytes received so far, before decompression (Windows only)
 }
 
 type DownloadResult = {
 	jobId: number // The download job ID, required if one wishes to cancel the download. See `stopDownload`.
 	statusCode: number // The HTTP status code
 	bytesWritten: number // The number of bytes written to the file
+	bytesRead?: number // The number of bytes received, before decompression (Windows only)
+	fromCache?: boolean // Whether the file was served from the download cache (Windows only)
+	attempts?: number // Requests made, including retries (Windows only)
+}
+
+type FetchToMemoryOptions = {
+	fromUrl: string // URL to fetch
+	headers?: Headers // An object of headers to be passed to the server
+	maxSize?: number // Largest body accepted in bytes, default 10 MiB
+	encoding?: 'base64' | 'utf8' // Encoding of `body` in the result, default 'base64'
+	readTimeout?: number // Default is 15000ms
+	connectionTimeout?: number // Default is 5000ms
+	maxBytesPerSecond?: number // Limit the rate of this job, see `setBandwidthLimit`
+	priority?: TransferPriority // HTTP client pool to use, see `configureHttpClient`
+	retry?: RetryOptions // Retry failed requests, see `downloadFile`
+}
+
+type FetchResult = {
+	jobId: number // The job ID, which `stopDownload` accepts
+	statusCode: number // The HTTP status code
+	headers: Headers // The HTTP response headers from the server
+	body: string // The response body in the requested encoding
+	bytesRead: number // The number of bytes received
+	attempts: number // Requests made, including retries
+}
+
+type DownloadCacheStats = {
+	hits: number // Downloads answered with 304 and served from the cache
+	misses: number // Cached downloads that had to be transferred
+	bytesServed: number // Bytes copied out of the cache instead of downloaded
+}
+
+type DownloadCacheOptions = {
+	folder?: string // Absolute path of the folder the cache keeps its files in, '' for the default
+}
+
+type UploadJournalOptions = {
+	folder?: string // Absolute path of the folder resumable uploads are journaled in, '' for the default
+}
+
+type OperationStats = {
+	calls: number // Calls that finished since the last reset
+	inFlight: number // Calls still running
+	errors: number // Calls that were rejected
+	errorCodes: { [code: string]: number } // Rejections by code, such as ENOENT or CANCELLED
+	bytesIn: number // Bytes read from files or received
+	bytesOut: number // Bytes written to files or sent
+	meanMs: number
+	p50Ms: number // Upper bound of the latency bucket holding the median call
+	p99Ms: number
+	histogram: number[] // Calls per latency bucket: under 1 µs, then [2^(i-1), 2^i) µs
+}
+
+type IoLaneStats = {
+	scheduled: number // Calls admitted since the last reset
+	queued: number // Calls waiting for a slot right now
+	meanWaitMs: number
+	p50WaitMs: number // Upper bound of the wait bucket holding the median call
+	p99WaitMs: number
+	maxWaitMs: number
+}
+
+type EventStats = {
+	posted: number // Begin and progress events raised by transfers
+	superseded: number // Progress events dropped for a newer one of the same job before delivery
+	delivered: number
+	batches: number // Bridge calls that carried the delivered events
+}
+
+type SessionStats = {
+	open: number
+	opened: number
+	expired: number // Closed for being idle rather than by closeRead or closeWrite
+}
+
+type AppendStats = {
+	appends: number
+	writes: number // Writes the appends were merged into
+	bytes: number
+	pending: number // Files with appends not written yet
+}
+
+type Stats = {
+	since: number // When the counters were last reset, in milliseconds since 1970
+	operations: { [method: string]: OperationStats }
+	io: {
+		workers: number // File operations that may run at once
+		lanes: { interactive: IoLaneStats; normal: IoLaneStats; background: IoLaneStats }
+	}
+	events: EventStats
+	writeSessions: SessionStats
+	readSessions: SessionStats
+	appends: AppendStats
+}
+
+type JobInfo = {
+	jobId: number
+	state: 'queued' | 'running' | 'paused' // Paused while waiting to retry
+	bytesTransferred: number
+	bytesExpected: number // 0 while unknown
 }
 
 type UploadFileOptions = {
@@ -75,6 +256,16 @@ type UploadFileOptions = {
 	headers?: Headers // An object of headers to be passed to the server
 	fields?: Fields // An object of fields to be passed to the server
 	method?: string // Default is 'POST', supports 'POST' and 'PUT'
+	progressInterval?: number // Minimum milliseconds between progress events (Windows only, default 100)
+	resumable?: boolean // Upload each file with the tus resumable upload protocol (Windows only, default false)
+	chunkSize?: number // Bytes sent per request in resumable uploads (Windows only, default 4 MiB, at most 64 MiB)
+	parallel?: boolean // Send each file as its own request (Windows only, default false)
+	maxConcurrent?: number // Requests in flight for parallel uploads (Windows only, default 4)
+	retries?: number // Extra attempts per file for parallel uploads (Windows only, default 0)
+	compress?: 'gzip' // Compress the request body while it is sent (Windows only)
+	maxBytesPerSecond?: number // Limit the upload rate of this job, see `setBandwidthLimit` (Windows only)
+	priority?: TransferPriority // HTTP client pool to use, see `configureHttpClient` (Windows only)
+	retry?: RetryOptions // Retry failed requests, see `downloadFile` (Windows only)
 	beginCallback?: (res: UploadBeginCallbackResult) => void // deprecated
 	progressCallback?: (res: UploadProgressCallbackResult) => void // deprecated
 	begin?: (res: UploadBeginCallbackResult) => void
@@ -84,8 +275,10 @@ type UploadFileOptions = {
 type UploadFileItem = {
 	name: string // Name of the file, if not defined then filename is used
 	filename: string // Name of file
-	filepath: string // Path to file
+	filepath?: string // Path to file, unless `data` is given
 	filetype: string // The mimetype of the file to be uploaded, if not defined it will get mimetype from `filepath` extension
+	data?: string // Contents to send instead of reading `filepath` (Windows only)
+	encoding?: 'base64' | 'utf8' // Encoding of `data`, default 'base64' (Windows only)
 }
 
 type UploadBeginCallbackResult = {
@@ -96,6 +289,9 @@ type UploadProgressCallbackResult = {
 	jobId: number // The upload job ID, required if one wishes to cancel the upload. See `stopUpload`.
 	totalBytesExpectedToSend: number // The total number of bytes that will be sent to the server
 	totalBytesSent: number // The number of bytes sent to the server
+	fileIndex?: number // Parallel uploads: index of the file this event is about (Windows only)
+	fileBytesExpectedToSend?: number // Parallel uploads: size of that file (Windows only)
+	fileBytesSent?: number // Parallel uploads: bytes of that file sent so far (Windows only)
 }
 
 type UploadResult = {
@@ -103,6 +299,20 @@ type UploadResult = {
 	statusCode: number // The HTTP status code
 	headers: Headers // The HTTP response headers from the server
 	body: string // The HTTP response body
+	uploadUrls?: string[] // Resumable uploads: the upload URL of each file (Windows only)
+	files?: UploadFileResult[] // Parallel uploads: the outcome of each file (Windows only)
+	attempts?: number // Requests made, including retries (Windows only)
+	retries?: number // Resumable uploads: chunks sent again after a failure (Windows only)
+}
+
+type UploadFileResult = {
+	index: number // Position of the file in `options.files`
+	filepath: string
+	attempts: number // Requests made for this file
+	statusCode?: string // The HTTP status code of the last attempt
+	headers?: string // The HTTP response headers of the last attempt
+	body?: string // The HTTP response body of the last attempt
+	error?: string // Set when no response was received
 }
 
 type FSInfoResult = {
@@ -124,12 +334,13 @@ export function copyFile(
 export function copyFolder(
 	srcPath: string,
 	destPath: string,
+	options?: JobOptions
 ): Promise<void>
 export function pathForBundle(bundleNamed: string): Promise<string>
 export function pathForGroup(groupName: string): Promise<string>
 export function getFSInfo(): Promise<FSInfoResult>
 export function getAllExternalFilesDirs(): Promise<string[]>
-export function unlink(filepath: string): Promise<void>
+export function unlink(filepath: string, options?: JobOptions): Promise<void>
 export function exists(filepath: string): Promise<boolean>
 
 export function stopDownload(jobId: number): void
@@ -138,11 +349,83 @@ export function resumeDownload(jobId: number): void
 
 export function isResumable(jobId: number): Promise<boolean>
 
+/**
+ * Windows-only
+ */
+export function getDownloadCacheStats(): Promise<DownloadCacheStats>
+
+/**
+ * Windows-only
+ */
+export function configureDownloadCache(options: DownloadCacheOptions): Promise<void>
+
+/**
+ * Windows-only
+ */
+export function configureUploadJournal(options: UploadJournalOptions): Promise<void>
+
+/**
+ * Windows-only
+ */
+export function getStats(): Promise<Stats>
+
+/**
+ * Windows-only
+ */
+export function resetStats(): Promise<void>
+
+/**
+ * Windows-only
+ */
+export function getJobs(): Promise<JobInfo[]>
+
+type TransferPriority = 'interactive' | 'normal' | 'background'
+
+type HttpClientOptions = {
+	priority?: TransferPriority // Pool to configure, default is 'normal'
+	maxConnectionsPerServer?: number
+	httpVersion?: '1.1' | '2' // Highest HTTP version to negotiate
+	bypassCache?: boolean // Skip the system HTTP cache
+	keepAlive?: boolean // Reuse connections between requests
+}
+
+/**
+ * Windows-only
+ */
+export function configureHttpClient(options: HttpClientOptions): Promise<void>
+
+type AppendCoalescingOptions = {
+	maxDelay?: number // Milliseconds an append may wait for others to share its write
+	maxBytes?: number // Largest write appends are merged into
+}
+
+/**
+ * Windows-only
+ */
+export function configureAppendCoalescing(options: AppendCoalescingOptions): Promise<void>
+
+/**
+ * Windows-only
+ */
+export function setBandwidthLimit(maxBytesPerSecond: number, jobId?: number): Promise<void>
+
 export function stopUpload(jobId: number): void
 
+/**
+ * Windows-only
+ */
+export function cancelJob(jobId: number): void
+
 export function completeHandlerIOS(jobId: number): void
 
-export function readDir(dirpath: string): Promise<ReadDirItem[]>
+export function readDir(
+	dirpath: string,
+	options: ReadDirOptions & { columnar: true }
+): Promise<ReadDirColumns>
+export function readDir(
+	dirpath: string,
+	options?: ReadDirOptions
+): Promise<ReadDirItem[]>
 
 /**
  * Android-only
@@ -180,6 +463,14 @@ export function setReadable(
 
 export function stat(filepath: string): Promise<StatResult>
 
+/**
+ * Windows-only
+ */
+export function statBatch(
+	filepaths: string[],
+	options?: { fields?: ReadDirField[] }
+): Promise<StatBatchResult>
+
 export function readFile(
 	filepath: string,
 	encodingOrOptions?: any
@@ -207,7 +498,7 @@ export function readFileRes(
 	encodingOrOptions?: any
 ): Promise<string>
 
-export function hash(filepath: string, algorithm: string): Promise<string>
+export function hash(filepath: string, algorithm: string, options?: JobOptions): Promise<string>
 
 /**
  * Android only
@@ -271,10 +562,63 @@ export function write(
 	encodingOrOptions?: any
 ): Promise<void>
 
+/**
+ * Windows-only
+ */
+export function openWrite(
+	filepath: string,
+	options?: OpenWriteOptions
+): Promise<number>
+
+/**
+ * Windows-only
+ */
+export function writeChunk(
+	sessionId: number,
+	contents: string,
+	encoding?: string
+): Promise<void>
+
+/**
+ * Windows-only
+ */
+export function closeWrite(
+	sessionId: number,
+	options?: CloseWriteOptions
+): Promise<CloseWriteResult>
+
+/**
+ * Windows-only
+ */
+export function openRead(
+	filepath: string,
+	options?: OpenReadOptions
+): Promise<number>
+
+/**
+ * Windows-only
+ */
+export function readChunk(
+	sessionId: number,
+	encoding?: string
+): Promise<ReadChunkResult>
+
+/**
+ * Windows-only
+ */
+export function closeRead(sessionId: number): Promise<void>
+
 export function downloadFile(
 	options: DownloadFileOptions
 ): { jobId: number; promise: Promise<DownloadResult> }
 
+/**
+ * Windows-only
+ */
+export function fetchToMemory(
+	options: FetchToMemoryOptions
+): { jobId: number; promise: Promise<FetchResult> }
+
 export function uploadFiles(
 	options: UploadFileOptions
 ): { jobId: number; promise: Promise<UploadResult> }
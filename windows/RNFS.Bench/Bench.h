@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "ModuleHarness.h"
+
+namespace RNFSBench {
+
+    struct Options
+    {
+        std::string suite{ "transfers" };
+        uint64_t maxSize{ 1ull << 30 };
+        uint64_t maxBridgeSize{ 64ull << 20 };
+        uint32_t maxEntries{ 10000 };
+        uint32_t iterations{ 0 };
+        uint64_t bytesPerSecond{ 0 };
+        std::string out;
+    };
+
+    double cpu_seconds() noexcept;
+    uint64_t peak_working_set() noexcept;
+    uint64_t parse_size(std::string_view text);
+    std::string format_size(uint64_t size);
+
+    // Fragments the file's data is stored in on disk; 0 for data kept in its MFT record, and
+    // nullopt when the volume cannot tell, as on FAT
+    std::optional<uint32_t> extent_count(std::filesystem::path const& path);
+
+    // Fills `path` with `size` bytes of the server's pattern, without holding them all in memory
+    void write_pattern_file(std::filesystem::path const& path, uint64_t size);
+
+    // The `files` option of uploadFiles for a single file
+    React::JSValueArray upload_files(std::filesystem::path const& path);
+
+    // Per-method latencies, see MethodSuite.cpp
+    int run_method_suite(Options const& options);
+
+    // Whether a timed call succeeded; rejections are reported on stderr
+    inline bool succeeded(bool ok) noexcept
+    {
+        return ok;
+    }
+
+    inline bool succeeded(ModuleHarness::Outcome const& outcome)
+    {
+        if (!outcome)
+        {
+            std::fprintf(stderr, "  rejected: %s\n", outcome.value["message"].AsString().c_str());
+        }
+        return outcome.resolved;
+    }
+}
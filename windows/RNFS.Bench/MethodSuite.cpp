@@ -0,0 +1,550 @@
+#include "pch.h"
+#include "Bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <vector>
+#include "LoopbackHttpServer.h"
+
+//
+// Times each call of every method of the module through the builder mock, the
+// path a call from JS takes once it reaches native code, for files from 1 KB to
+// --max-size and directories of 10 to --max-entries entries. Methods that carry
+// file contents across the bridge as base64 (readFile, read, writeFile,
+// appendFile, write and fetchToMemory) stop at --max-bridge-size, as an app
+// would have to hold those strings as well. Work between calls, such as
+// recreating a file that unlink removed, is not timed.
+//
+// Rows with a "pieces" variant move the same bytes 64 KiB per call, so that
+// each pair can be compared: a write session (openWrite, writeChunk,
+// closeWrite) against appendFile, a read session (openRead, readChunk,
+// closeRead) against read at each offset, and appendFile calls issued all at
+// once with and without configureAppendCoalescing merging their writes.
+// Likewise statBatch of a directory's entries is timed against a stat for
+// each of them.
+//
+// The result is one JSON document on stdout, or in --out, with a row per
+// method, variant and size:
+//
+//   { "method": "hash", "variant": "sha256", "size": 1048576, "entries": 0, "runs": 256, "failures": 0,
+//     "p50Ms": 1.92, "p99Ms": 2.41, "meanMs": 1.95, "maxMs": 3.12, "mbPerSecond": 512.8, "opsPerSecond": 512.8,
+//     "peakWorkingSetBytes": 31457280 }
+//
+// The "instrumentation" row times 1000 calls' worth of what getStats records,
+// so its p50 in milliseconds is the microseconds each method spends on it.
+//
+// The "eventBus" row times 1000 progress events of 16 jobs posted and flushed
+// as one batch, which took 1000 bridge calls before events were batched.
+//
+// peakWorkingSetBytes is the peak of the process so far. Rows run from small
+// to large, so the first row with a jump shows which method needed the memory.
+//
+
+namespace {
+
+    using namespace RNFSBench;
+
+    struct Row
+    {
+        std::string method;
+        std::string variant;
+        uint64_t size{ 0 };
+        uint32_t entries{ 0 };
+        uint32_t runs{ 0 };
+        uint32_t failures{ 0 };
+        double p50Ms{ 0 };
+        double p99Ms{ 0 };
+        double meanMs{ 0 };
+        double maxMs{ 0 };
+        double mbPerSecond{ 0 };
+        double opsPerSecond{ 0 };
+        uint64_t peakWorkingSet{ 0 };
+    };
+
+    // Nearest-rank percentile of latencies sorted in ascending order
+    double percentile(std::vector<double> const& sorted, double fraction)
+    {
+        auto rank{ static_cast<size_t>(std::ceil(fraction * sorted.size())) };
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    std::string base64_pattern(uint64_t size)
+    {
+        auto bytes{ LoopbackHttpServer::Pattern(0, static_cast<size_t>(size)) };
+        auto data{ reinterpret_cast<uint8_t const*>(bytes.data()) };
+        auto buffer{ winrt::Windows::Security::Cryptography::CryptographicBuffer::CreateFromByteArray({ data, data + bytes.size() }) };
+        return winrt::to_string(winrt::Windows::Security::Cryptography::CryptographicBuffer::EncodeToBase64String(buffer));
+    }
+
+    std::string u8(std::filesystem::path const& path)
+    {
+        return winrt::to_string(path.wstring());
+    }
+
+    class MethodSuite
+    {
+    public:
+        explicit MethodSuite(Options const& options) : m_options{ options }
+        {
+            std::filesystem::create_directories(m_folder);
+            m_server.KeepBodies(false);
+        }
+
+        ~MethodSuite()
+        {
+            std::error_code ignored;
+            std::filesystem::remove_all(m_folder, ignored);
+        }
+
+        void Run()
+        {
+            Metadata();
+            for (uint64_t size = 1024; size <= m_options.maxSize; size *= 16)
+            {
+                Files(size);
+            }
+            for (uint32_t entries = 10; entries <= m_options.maxEntries; entries *= 10)
+            {
+                Directories(entries);
+            }
+        }
+
+        void Write(FILE* out) const
+        {
+            std::fprintf(out, "{\n  \"suite\": \"methods\",\n  \"maxSize\": %llu,\n  \"maxBridgeSize\": %llu,\n  \"maxEntries\": %u,\n  \"results\": [",
+                static_cast<unsigned long long>(m_options.maxSize), static_cast<unsigned long long>(m_options.maxBridgeSize), m_options.maxEntries);
+            for (size_t i = 0; i < m_rows.size(); ++i)
+            {
+                auto const& row{ m_rows[i] };
+                std::fprintf(out, "%s\n    { \"method\": \"%s\", \"variant\": \"%s\", \"size\": %llu, \"entries\": %u, \"runs\": %u, \"failures\": %u, "
+                    "\"p50Ms\": %.4f, \"p99Ms\": %.4f, \"meanMs\": %.4f, \"maxMs\": %.4f, \"mbPerSecond\": %.2f, \"opsPerSecond\": %.2f, "
+                    "\"peakWorkingSetBytes\": %llu }",
+                    i ? "," : "", row.method.c_str(), row.variant.c_str(), static_cast<unsigned long long>(row.size), row.entries, row.runs, row.failures,
+                    row.p50Ms, row.p99Ms, row.meanMs, row.maxMs, row.mbPerSecond, row.opsPerSecond,
+                    static_cast<unsigned long long>(row.peakWorkingSet));
+            }
+            std::fprintf(out, "\n  ]\n}\n");
+        }
+
+    private:
+        // Enough runs for a p99 on small inputs, a few on large ones
+        uint32_t Runs(uint64_t work) const noexcept
+        {
+            return m_options.iterations ? m_options.iterations
+                : static_cast<uint32_t>(std::clamp<uint64_t>((256ull << 20) / std::max<uint64_t>(work, 1), 5, 500));
+        }
+
+        // Times `run(i)` for each of `runs` calls; `prepare(i)` runs before each call, outside the timing
+        template <typename Prepare, typename Call>
+        void Measure(std::string method, std::string variant, uint64_t size, uint32_t entries, uint64_t bytesPerCall,
+            uint32_t runs, Prepare&& prepare, Call&& run)
+        {
+            Row row{ std::move(method), std::move(variant), size, entries, runs };
+            std::vector<double> latencies;
+            latencies.reserve(runs);
+            for (uint32_t i = 0; i < runs; ++i)
+            {
+                prepare(i);
+                auto start{ std::chrono::steady_clock::now() };
+                row.failures += succeeded(run(i)) ? 0 : 1;
+                latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+
+            std::sort(latencies.begin(), latencies.end());
+            auto totalSeconds{ std::accumulate(latencies.begin(), latencies.end(), 0.0) / 1000 };
+            row.p50Ms = percentile(latencies, 0.50);
+            row.p99Ms = percentile(latencies, 0.99);
+            row.meanMs = totalSeconds * 1000 / runs;
+            row.maxMs = latencies.back();
+            row.opsPerSecond = totalSeconds > 0 ? runs / totalSeconds : 0;
+            row.mbPerSecond = totalSeconds > 0 ? static_cast<double>(bytesPerCall) * runs / (1024 * 1024) / totalSeconds : 0;
+            row.peakWorkingSet = peak_working_set();
+
+            std::fprintf(stderr, "%-22s %-8s %8s %6u entries %6u runs  p50 %9.3f ms  p99 %9.3f ms  %u failed\n",
+                row.method.c_str(), row.variant.c_str(), format_size(row.size).c_str(), row.entries, row.runs,
+                row.p50Ms, row.p99Ms, row.failures);
+            m_rows.push_back(std::move(row));
+        }
+
+        template <typename Call>
+        void Measure(std::string method, std::string variant, uint64_t size, uint32_t entries, uint64_t bytesPerCall,
+            uint32_t runs, Call&& run)
+        {
+            Measure(std::move(method), std::move(variant), size, entries, bytesPerCall, runs, [](uint32_t) {}, std::forward<Call>(run));
+        }
+
+        // Methods whose cost does not depend on a size
+        void Metadata()
+        {
+            auto file{ m_folder / L"metadata.bin" };
+            write_pattern_file(file, 1024);
+            auto runs{ Runs(0) };
+
+            Measure("exists", "file", 0, 0, 0, runs, [&](uint32_t) { return m_harness.Call(L"exists", u8(file)); });
+            Measure("exists", "missing", 0, 0, 0, runs, [&](uint32_t) { return m_harness.Call(L"exists", u8(m_folder / L"missing.bin")); });
+            Measure("stat", "file", 0, 0, 0, runs, [&](uint32_t) { return m_harness.Call(L"stat", u8(file)); });
+            Measure("stat", "directory", 0, 0, 0, runs, [&](uint32_t) { return m_harness.Call(L"stat", u8(m_folder)); });
+            Measure("touch", "", 0, 0, 0, runs, [&](uint32_t i)
+                {
+                    return m_harness.Call(L"touch", u8(file), int64_t{ 1600000000000 } + i, int64_t{ 1600000000000 }, true);
+                });
+
+            auto made{ m_folder / L"made" };
+            Measure("mkdir", "", 0, 0, 0, runs, [&](uint32_t i)
+                {
+                    return m_harness.Call(L"mkdir", u8(made / std::to_wstring(i)), React::JSValueObject{});
+                });
+            std::error_code ignored;
+            std::filesystem::remove_all(made, ignored);
+
+            Measure("getFSInfo", "", 0, 0, 0, runs, [&](uint32_t) { return m_harness.Call(L"getFSInfo"); });
+            Measure("getDownloadCacheStats", "", 0, 0, 0, runs, [&](uint32_t) { return m_harness.Call(L"getDownloadCacheStats"); });
+            Measure("getStats", "", 0, 0, 0, runs, [&](uint32_t) { return m_harness.Call(L"getStats"); });
+            Measure("resetStats", "", 0, 0, 0, runs, [&](uint32_t) { return m_harness.Call(L"resetStats"); });
+
+            // What getStats costs every other method: 1000 recorded calls per run, to compare with the p50 of exists
+            OperationStats stats;
+            Measure("instrumentation", "x1000", 0, 0, 0, runs, [&](uint32_t)
+                {
+                    for (int call = 0; call < 1000; ++call)
+                    {
+                        OperationScope scope{ stats, OperationStats::Operation::Exists };
+                        stats.AddBytes(OperationStats::Operation::Exists, 1, 0);
+                    }
+                    return true;
+                });
+
+            // 16 jobs reporting 1000 progress events between two frames; the bus hands JS one batch of 16
+            uint64_t bridgeCalls{ 0 };
+            EventBus events{ std::chrono::hours{ 1 } };
+            events.SetSink([&bridgeCalls](React::JSValueArray) { ++bridgeCalls; });
+            Measure("eventBus", "16 jobs x1000 progress", 0, 0, 0, runs, [&](uint32_t)
+                {
+                    auto before{ bridgeCalls };
+                    for (int update = 0; update < 1000; ++update)
+                    {
+                        auto job{ update % 16 };
+                        events.PostProgress("DownloadProgress", job, React::JSValueObject{ { "jobId", job }, { "bytesWritten", update } });
+                    }
+                    events.Flush();
+                    return bridgeCalls == before + 1;
+                });
+            Measure("configureHttpClient", "", 0, 0, 0, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"configureHttpClient", React::JSValueObject{ { "priority", "background" } });
+                });
+            Measure("setBandwidthLimit", "", 0, 0, 0, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"setBandwidthLimit", React::JSValueObject{ { "maxBytesPerSecond", 0 } });
+                });
+            Measure("stopDownload", "unknown job", 0, 0, 0, runs, [&](uint32_t)
+                {
+                    m_harness.Call0(L"stopDownload", -1);
+                    return true;
+                });
+            Measure("stopUpload", "unknown job", 0, 0, 0, runs, [&](uint32_t)
+                {
+                    m_harness.Call0(L"stopUpload", -1);
+                    return true;
+                });
+            Measure("cancelJob", "unknown job", 0, 0, 0, runs, [&](uint32_t)
+                {
+                    m_harness.Call0(L"cancelJob", -1);
+                    return true;
+                });
+            Measure("getJobs", "", 0, 0, 0, runs, [&](uint32_t) { return m_harness.Call(L"getJobs"); });
+            Measure("configureAppendCoalescing", "", 0, 0, 0, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"configureAppendCoalescing", React::JSValueObject{ { "maxDelay", 0 } });
+                });
+        }
+
+        void Files(uint64_t size)
+        {
+            auto source{ m_folder / L"source.bin" };
+            auto target{ m_folder / L"target.bin" };
+            auto moved{ m_folder / L"moved.bin" };
+            write_pattern_file(source, size);
+            auto runs{ Runs(size) };
+
+            Measure("hash", "md5", size, 0, size, runs, [&](uint32_t) { return m_harness.Call(L"hash", u8(source), std::string{ "md5" }, React::JSValueObject{}); });
+            Measure("hash", "sha256", size, 0, size, runs, [&](uint32_t) { return m_harness.Call(L"hash", u8(source), std::string{ "sha256" }, React::JSValueObject{}); });
+            Measure("copyFile", "", size, 0, size, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"copyFile", u8(source), u8(target), React::JSValueObject{});
+                });
+
+            // Moves the file back and forth, so every call has a file to move
+            Measure("moveFile", "", size, 0, size, runs, [&](uint32_t i)
+                {
+                    return i % 2 == 0
+                        ? m_harness.Call(L"moveFile", u8(source), u8(moved), React::JSValueObject{})
+                        : m_harness.Call(L"moveFile", u8(moved), u8(source), React::JSValueObject{});
+                });
+            if (std::filesystem::exists(moved))
+            {
+                std::filesystem::rename(moved, source);
+            }
+
+            Measure("unlink", "file", size, 0, 0, runs,
+                [&](uint32_t) { std::filesystem::copy_file(source, target, std::filesystem::copy_options::overwrite_existing); },
+                [&](uint32_t) { return m_harness.Call(L"unlink", u8(target), React::JSValueObject{}); });
+
+            Transfers(size, source, runs);
+
+            if (size > m_options.maxBridgeSize)
+            {
+                return;
+            }
+
+            auto content{ base64_pattern(size) };
+            Measure("readFile", "", size, 0, size, runs, [&](uint32_t) { return m_harness.Call(L"readFile", u8(source), React::JSValueObject{}); });
+            Measure("read", "", size, 0, size, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"read", u8(source), static_cast<uint32_t>(size), uint64_t{ 0 });
+                });
+            Measure("writeFile", "", size, 0, size, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"writeFile", u8(target), content, React::JSValueObject{});
+                });
+            Measure("write", "", size, 0, size, runs, [&](uint32_t) { return m_harness.Call(L"write", u8(target), content, 0); });
+            Measure("appendFile", "", size, 0, size, runs,
+                [&](uint32_t) { std::filesystem::resize_file(target, 0); },
+                [&](uint32_t) { return m_harness.Call(L"appendFile", u8(target), content); });
+
+            Pieces(size, source, target, runs);
+        }
+
+        void Pieces(uint64_t size, std::filesystem::path const& source, std::filesystem::path const& target, uint32_t runs)
+        {
+            auto pieceSize{ std::min<uint64_t>(size, PieceSize) };
+            auto pieces{ static_cast<uint32_t>(size / pieceSize) };
+            auto piece{ base64_pattern(pieceSize) };
+            auto variant{ format_size(pieceSize) + " pieces" };
+
+            Measure("writeChunk", variant, size, 0, size, runs, [&](uint32_t)
+                {
+                    auto opened{ m_harness.Call(L"openWrite", u8(target), React::JSValueObject{}) };
+                    if (!succeeded(opened))
+                    {
+                        return false;
+                    }
+                    auto sessionId{ opened.value.AsInt32() };
+                    bool ok{ true };
+                    for (uint32_t i = 0; i < pieces && ok; ++i)
+                    {
+                        ok = succeeded(m_harness.Call(L"writeChunk", sessionId, piece));
+                    }
+                    return succeeded(m_harness.Call(L"closeWrite", sessionId, React::JSValueObject{})) && ok;
+                });
+            Measure("appendFile", variant, size, 0, size, runs,
+                [&](uint32_t) { std::filesystem::resize_file(target, 0); },
+                [&](uint32_t)
+                {
+                    bool ok{ true };
+                    for (uint32_t i = 0; i < pieces && ok; ++i)
+                    {
+                        ok = succeeded(m_harness.Call(L"appendFile", u8(target), piece));
+                    }
+                    return ok;
+                });
+
+            Measure("readChunk", variant, size, 0, size, runs, [&](uint32_t)
+                {
+                    auto opened{ m_harness.Call(L"openRead", u8(source), React::JSValueObject{ { "chunkSize", static_cast<int64_t>(pieceSize) } }) };
+                    if (!succeeded(opened))
+                    {
+                        return false;
+                    }
+                    auto sessionId{ opened.value.AsInt32() };
+                    bool ok{ true };
+                    for (bool eof = false; ok && !eof;)
+                    {
+                        auto chunk{ m_harness.Call(L"readChunk", sessionId) };
+                        ok = succeeded(chunk);
+                        eof = ok && chunk.value["eof"].AsBoolean();
+                    }
+                    return succeeded(m_harness.Call(L"closeRead", sessionId)) && ok;
+                });
+            Measure("read", variant, size, 0, size, runs, [&](uint32_t)
+                {
+                    bool ok{ true };
+                    for (uint32_t i = 0; i < pieces && ok; ++i)
+                    {
+                        ok = succeeded(m_harness.Call(L"read", u8(source), static_cast<uint32_t>(pieceSize), uint64_t{ i } * pieceSize));
+                    }
+                    return ok;
+                });
+
+            // Every append is in flight before the first finishes, so those queued behind a write can share the next one
+            auto concurrentAppends{ [&](uint32_t)
+                {
+                    std::vector<ModuleHarness::Pending> pending;
+                    pending.reserve(pieces);
+                    for (uint32_t i = 0; i < pieces; ++i)
+                    {
+                        pending.push_back(m_harness.Start(L"appendFile", u8(target), piece));
+                    }
+                    bool ok{ true };
+                    for (auto& call : pending)
+                    {
+                        ok = succeeded(call.Wait()) && ok;
+                    }
+                    return ok;
+                } };
+            m_harness.Call(L"configureAppendCoalescing", React::JSValueObject{ { "maxBytes", 1 } });
+            Measure("appendFile", variant + " uncoalesced", size, 0, size, runs,
+                [&](uint32_t) { std::filesystem::resize_file(target, 0); }, concurrentAppends);
+            m_harness.Call(L"configureAppendCoalescing", React::JSValueObject{ { "maxBytes", static_cast<int64_t>(AppendCoalescer::DefaultMaxBytes) } });
+            Measure("appendFile", variant + " coalesced", size, 0, size, runs,
+                [&](uint32_t) { std::filesystem::resize_file(target, 0); }, concurrentAppends);
+        }
+
+        void Transfers(uint64_t size, std::filesystem::path const& source, uint32_t runs)
+        {
+            LoopbackHttpServer::Resource resource;
+            resource.size = size;
+            auto path{ "/" + std::to_string(size) };
+            m_server.Serve(path, resource);
+
+            auto downloaded{ u8(m_folder / L"download.bin") };
+            Measure("downloadFile", "", size, 0, size, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"downloadFile", React::JSValueObject{
+                        { "jobId", ++m_jobId },
+                        { "fromUrl", m_server.Url(path) },
+                        { "toFile", downloaded },
+                        { "headers", React::JSValueObject{} },
+                        { "progressInterval", 0 },
+                        { "progressDivider", 0 },
+                    });
+                });
+            Measure("uploadFiles", "", size, 0, size, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"uploadFiles", React::JSValueObject{
+                        { "jobId", ++m_jobId },
+                        { "toUrl", m_server.Url("/upload") },
+                        { "files", upload_files(source) },
+                        { "headers", React::JSValueObject{} },
+                        { "fields", React::JSValueObject{} },
+                        { "method", "POST" },
+                    });
+                });
+
+            if (size > m_options.maxBridgeSize)
+            {
+                return;
+            }
+            Measure("fetchToMemory", "", size, 0, size, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"fetchToMemory", React::JSValueObject{
+                        { "jobId", ++m_jobId },
+                        { "fromUrl", m_server.Url(path) },
+                        { "headers", React::JSValueObject{} },
+                        { "maxSize", static_cast<int64_t>(size) },
+                        { "encoding", "base64" },
+                    });
+                });
+        }
+
+        void Directories(uint32_t entries)
+        {
+            auto folder{ m_folder / (L"entries-" + std::to_wstring(entries)) };
+            auto copy{ m_folder / L"copy" };
+            std::filesystem::create_directories(folder);
+            for (uint32_t i = 0; i < entries; ++i)
+            {
+                write_pattern_file(folder / (std::to_wstring(i) + L".bin"), 1024);
+            }
+            auto runs{ Runs(uint64_t{ entries } * 64 * 1024) };
+
+            std::vector<std::string> paths;
+            for (uint32_t i = 0; i < entries; ++i)
+            {
+                paths.push_back(u8(folder / (std::to_wstring(i) + L".bin")));
+            }
+            Measure("stat", "each entry", 0, entries, 0, runs, [&](uint32_t)
+                {
+                    bool ok{ true };
+                    for (auto const& path : paths)
+                    {
+                        ok = succeeded(m_harness.Call(L"stat", path)) && ok;
+                    }
+                    return ok;
+                });
+            React::JSValueArray batch;
+            Measure("statBatch", "", 0, entries, 0, runs,
+                [&](uint32_t)
+                {
+                    batch = {};
+                    for (auto const& path : paths)
+                    {
+                        batch.push_back(React::JSValue{ std::string{ path } });
+                    }
+                },
+                [&](uint32_t) { return m_harness.Call(L"statBatch", std::move(batch), React::JSValueObject{}); });
+
+            Measure("readDir", "", 0, entries, 0, runs, [&](uint32_t) { return m_harness.Call(L"readDir", u8(folder), React::JSValueObject{}); });
+            Measure("readDir", "columnar", 0, entries, 0, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"readDir", u8(folder), React::JSValueObject{ { "columnar", true } });
+                });
+            Measure("readDir", "columnar names", 0, entries, 0, runs, [&](uint32_t)
+                {
+                    return m_harness.Call(L"readDir", u8(folder), React::JSValueObject{ { "columnar", true }, { "fields", React::JSValueArray{ "name" } } });
+                });
+            Measure("copyFolder", "", 0, entries, uint64_t{ entries } * 1024, runs,
+                [&](uint32_t)
+                {
+                    std::filesystem::remove_all(copy);
+                    std::filesystem::create_directory(copy);
+                },
+                [&](uint32_t) { return m_harness.Call(L"copyFolder", u8(folder), u8(copy), React::JSValueObject{}); });
+            Measure("unlink", "directory", 0, entries, 0, runs,
+                [&](uint32_t)
+                {
+                    std::filesystem::remove_all(copy);
+                    std::filesystem::copy(folder, copy);
+                },
+                [&](uint32_t) { return m_harness.Call(L"unlink", u8(copy), React::JSValueObject{}); });
+
+            std::filesystem::remove_all(folder);
+        }
+
+        static constexpr uint64_t PieceSize = 64 * 1024;
+
+        Options const& m_options;
+        std::filesystem::path m_folder{ std::filesystem::temp_directory_path() / L"rnfs-bench-methods" };
+        ModuleHarness m_harness;
+        LoopbackHttpServer m_server;
+        int32_t m_jobId{ 0 };
+        std::vector<Row> m_rows;
+    };
+}
+
+namespace RNFSBench {
+
+    int run_method_suite(Options const& options)
+    {
+        MethodSuite suite{ options };
+        suite.Run();
+
+        if (options.out.empty())
+        {
+            suite.Write(stdout);
+            return 0;
+        }
+
+        FILE* out{ nullptr };
+        if (fopen_s(&out, options.out.c_str(), "w") != 0 || !out)
+        {
+            std::fprintf(stderr, "cannot write %s\n", options.out.c_str());
+            return 1;
+        }
+        suite.Write(out);
+        std::fclose(out);
+        return 0;
+    }
+}
@@ -0,0 +1,272 @@
+#include "pch.h"
+#include "Bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <psapi.h>
+#include <vector>
+#include <winioctl.h>
+#include "LoopbackHttpServer.h"
+
+//
+// The default "transfers" suite measures the throughput of downloadFile and
+// uploadFiles against LoopbackHttpServer for payloads from 1 KB to 1 GB. Each
+// row reports wall clock MB/s, process CPU milliseconds per MB (the server runs
+// in this process, so that includes its share), the rate of events sent to JS,
+// the peak working set so far and, for downloads, how many extents the file
+// ended up in on disk, with and without preallocation. The "methods" suite times every method of
+// the module separately and writes JSON, see MethodSuite.cpp.
+//
+//   RNFS.Bench [--suite transfers|methods] [--max-size <bytes>[K|M|G]] [--iterations <n>]
+//              [--throttle <bytes per second>] [--max-bridge-size <bytes>[K|M|G]] [--max-entries <n>] [--out <file>]
+//
+// Without --iterations, small payloads are repeated until about 64 MB have
+// gone through so that their numbers are not dominated by timer resolution.
+//
+
+namespace RNFSBench {
+
+    double cpu_seconds() noexcept
+    {
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        {
+            return 0;
+        }
+        auto ticks{ [](FILETIME const& time) { return (uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime; } };
+        return (ticks(kernel) + ticks(user)) / 1e7;
+    }
+
+    uint64_t peak_working_set() noexcept
+    {
+        PROCESS_MEMORY_COUNTERS counters{};
+        return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+    }
+
+    std::optional<uint32_t> extent_count(std::filesystem::path const& path)
+    {
+        winrt::file_handle file{ CreateFileW(path.c_str(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_EXISTING, 0, nullptr) };
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        STARTING_VCN_INPUT_BUFFER input{};
+        std::vector<uint8_t> output(64 * 1024);
+        uint32_t extents{ 0 };
+        for (;;)
+        {
+            DWORD returned{ 0 };
+            BOOL complete{ DeviceIoControl(file.get(), FSCTL_GET_RETRIEVAL_POINTERS, &input, sizeof(input),
+                output.data(), static_cast<DWORD>(output.size()), &returned, nullptr) };
+            auto error{ complete ? ERROR_SUCCESS : GetLastError() };
+            if (error == ERROR_HANDLE_EOF)
+            {
+                return extents; // nothing allocated outside the MFT record
+            }
+            if (error != ERROR_SUCCESS && error != ERROR_MORE_DATA)
+            {
+                return std::nullopt;
+            }
+
+            // Only as many extents as fit in the buffer come back at a time
+            auto const& pointers{ *reinterpret_cast<RETRIEVAL_POINTERS_BUFFER const*>(output.data()) };
+            extents += pointers.ExtentCount;
+            if (complete || pointers.ExtentCount == 0)
+            {
+                return extents;
+            }
+            input.StartingVcn = pointers.Extents[pointers.ExtentCount - 1].NextVcn;
+        }
+    }
+
+    uint64_t parse_size(std::string_view text)
+    {
+        size_t end{ 0 };
+        uint64_t value{ std::stoull(std::string{ text }, &end) };
+        switch (end < text.size() ? text[end] : '\0')
+        {
+        case 'G': case 'g': return value << 30;
+        case 'M': case 'm': return value << 20;
+        case 'K': case 'k': return value << 10;
+        default: return value;
+        }
+    }
+
+    std::string format_size(uint64_t size)
+    {
+        if (size >= (1ull << 30)) return std::to_string(size >> 30) + " GB";
+        if (size >= (1ull << 20)) return std::to_string(size >> 20) + " MB";
+        if (size >= (1ull << 10)) return std::to_string(size >> 10) + " KB";
+        return std::to_string(size) + " B";
+    }
+
+    void write_pattern_file(std::filesystem::path const& path, uint64_t size)
+    {
+        std::ofstream stream{ path, std::ios::binary | std::ios::trunc };
+        constexpr size_t sliceSize{ 4 * 1024 * 1024 };
+        for (uint64_t offset = 0; offset < size; offset += sliceSize)
+        {
+            auto slice{ LoopbackHttpServer::Pattern(offset, static_cast<size_t>(std::min<uint64_t>(sliceSize, size - offset))) };
+            stream.write(slice.data(), slice.size());
+        }
+    }
+
+    React::JSValueArray upload_files(std::filesystem::path const& path)
+    {
+        React::JSValueArray files;
+        files.push_back(React::JSValueObject{
+            { "name", "file" },
+            { "filename", winrt::to_string(path.filename().wstring()) },
+            { "filepath", winrt::to_string(path.wstring()) },
+            { "filetype", "application/octet-stream" },
+        });
+        return files;
+    }
+}
+
+namespace {
+
+    using namespace RNFSBench;
+
+    struct Sample
+    {
+        double seconds{ 0 };
+        double cpuSeconds{ 0 };
+        uint64_t events{ 0 };
+        uint32_t failures{ 0 };
+        std::optional<uint32_t> extents; // of the downloaded file after the last run
+    };
+
+    template <typename Run>
+    Sample measure(ModuleHarness& harness, uint32_t iterations, Run&& run)
+    {
+        Sample sample;
+        auto events{ harness.Events() };
+        auto cpu{ cpu_seconds() };
+        auto start{ std::chrono::steady_clock::now() };
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            sample.failures += succeeded(run()) ? 0 : 1;
+        }
+        sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sample.cpuSeconds = cpu_seconds() - cpu;
+        sample.events = harness.Events() - events;
+        return sample;
+    }
+
+    void report(char const* name, uint64_t size, uint32_t iterations, Sample const& sample)
+    {
+        auto megabytes{ static_cast<double>(size) * iterations / (1024 * 1024) };
+        std::printf("%-22s %8s %6u %10.1f %12.2f %10.0f %10.1f %6u %8s\n",
+            name, format_size(size).c_str(), iterations,
+            megabytes / sample.seconds,
+            sample.cpuSeconds * 1000 / megabytes,
+            sample.events / sample.seconds,
+            peak_working_set() / (1024.0 * 1024),
+            sample.failures,
+            sample.extents ? std::to_string(*sample.extents).c_str() : "-");
+        std::fflush(stdout);
+    }
+
+    int run_transfer_suite(Options const& options)
+    {
+        auto folder{ std::filesystem::temp_directory_path() / L"rnfs-bench" };
+        std::filesystem::create_directories(folder);
+        auto downloadPath{ winrt::to_string((folder / L"download.bin").wstring()) };
+        auto uploadPath{ folder / L"upload.bin" };
+
+        ModuleHarness harness;
+        LoopbackHttpServer server;
+        server.KeepBodies(false);
+
+        std::printf("%-22s %8s %6s %10s %12s %10s %10s %6s %8s\n",
+            "operation", "size", "runs", "MB/s", "CPU ms/MB", "events/s", "peak MB", "failed", "extents");
+
+        int32_t jobId{ 0 };
+        for (uint64_t size = 1024; size <= options.maxSize; size *= 16)
+        {
+            auto iterations{ options.iterations ? options.iterations
+                : static_cast<uint32_t>(std::clamp<uint64_t>((64ull << 20) / size, 1, 1000)) };
+
+            LoopbackHttpServer::Resource resource;
+            resource.size = size;
+            resource.bytesPerSecond = options.bytesPerSecond;
+            auto path{ "/" + std::to_string(size) };
+            server.Serve(path, resource);
+
+            for (bool preallocate : { false, true })
+            {
+                auto sample{ measure(harness, iterations, [&]
+                    {
+                        return harness.Call(L"downloadFile", React::JSValueObject{
+                            { "jobId", ++jobId },
+                            { "fromUrl", server.Url(path) },
+                            { "toFile", downloadPath },
+                            { "headers", React::JSValueObject{} },
+                            { "progressInterval", 0 },
+                            { "progressDivider", 0 },
+                            { "preallocate", preallocate },
+                        });
+                    }) };
+                sample.extents = extent_count(folder / L"download.bin");
+                report(preallocate ? "download (preallocate)" : "download", size, iterations, sample);
+            }
+
+            write_pattern_file(uploadPath, size);
+            for (bool parallel : { false, true })
+            {
+                auto sample{ measure(harness, iterations, [&]
+                    {
+                        return harness.Call(L"uploadFiles", React::JSValueObject{
+                            { "jobId", ++jobId },
+                            { "toUrl", server.Url("/upload") },
+                            { "files", upload_files(uploadPath) },
+                            { "headers", React::JSValueObject{} },
+                            { "fields", React::JSValueObject{} },
+                            { "method", "POST" },
+                            { "hasProgressCallback", true },
+                            { "maxBytesPerSecond", static_cast<int64_t>(options.bytesPerSecond) },
+                            { "parallel", parallel },
+                        });
+                    }) };
+                report(parallel ? "upload (parallel)" : "upload", size, iterations, sample);
+            }
+        }
+
+        std::error_code ignored;
+        std::filesystem::remove_all(folder, ignored);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    winrt::init_apartment();
+
+    Options options;
+    bool valid{ argc % 2 == 1 };
+    for (int i = 1; valid && i + 1 < argc; i += 2)
+    {
+        std::string_view flag{ argv[i] };
+        if (flag == "--suite") options.suite = argv[i + 1];
+        else if (flag == "--max-size") options.maxSize = parse_size(argv[i + 1]);
+        else if (flag == "--max-bridge-size") options.maxBridgeSize = parse_size(argv[i + 1]);
+        else if (flag == "--max-entries") options.maxEntries = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (flag == "--iterations") options.iterations = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        else if (flag == "--throttle") options.bytesPerSecond = parse_size(argv[i + 1]);
+        else if (flag == "--out") options.out = argv[i + 1];
+        else valid = false;
+    }
+    if (!valid || (options.suite != "transfers" && options.suite != "methods"))
+    {
+        std::fprintf(stderr, "usage: RNFS.Bench [--suite transfers|methods] [--max-size <bytes>[K|M|G]] [--iterations <n>]\n"
+            "                  [--throttle <bytes per second>] [--max-bridge-size <bytes>[K|M|G]] [--max-entries <n>] [--out <file>]\n");
+        return 2;
+    }
+
+    return options.suite == "methods" ? run_method_suite(options) : run_transfer_suite(options);
+}
@@ -0,0 +1,127 @@
+#include "pch.h"
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AppendCoalescer.h"
+#include "TestFiles.h"
+
+namespace ReactNativeTests {
+
+    TEST_CLASS(AppendCoalescerTest) {
+        std::filesystem::path m_folder{ fresh_folder(L"rnfs-append-coalescer-test") };
+        std::filesystem::path m_file{ m_folder / L"log.txt" };
+
+        TEST_METHOD(TestSubmit_writesInCallOrder) {
+            AppendCoalescer appends;
+            std::vector<winrt::hresult> results;
+            std::mutex mutex;
+            auto record{ [&](winrt::hresult result) { std::lock_guard lock{ mutex }; results.push_back(result); } };
+
+            auto first{ appends.Reserve(m_file) };
+            auto second{ appends.Reserve(m_file) };
+            auto third{ appends.Reserve(m_file) };
+
+            // Nothing is written until the first append is in
+            appends.Submit(third, bytes_of("c"), record);
+            appends.Submit(second, bytes_of("b"), record);
+            TestCheck(results.empty());
+            TestCheck(!std::filesystem::exists(m_file));
+
+            // ...and then all three go out in one write
+            appends.Submit(first, bytes_of("a"), record);
+            TestCheck(results.size() == 3);
+            TestCheck(contents_of(m_file) == "abc");
+
+            auto counters{ appends.Snapshot() };
+            TestCheck(counters.appends == 3);
+            TestCheck(counters.writes == 1);
+            TestCheck(counters.bytes == 3);
+            TestCheck(appends.Pending() == 0);
+        }
+
+        TEST_METHOD(TestSubmit_appendsToExistingFile) {
+            std::ofstream{ m_file, std::ios::binary } << "log:";
+            AppendCoalescer appends;
+            appends.Submit(appends.Reserve(m_file), bytes_of("one"), [](winrt::hresult) {});
+            appends.Submit(appends.Reserve(m_file), bytes_of("two"), [](winrt::hresult) {});
+            TestCheck(contents_of(m_file) == "log:onetwo");
+            TestCheck(appends.Snapshot().writes == 2);
+        }
+
+        TEST_METHOD(TestSubmit_runsBoundedByMaxBytes) {
+            AppendCoalescer appends;
+            appends.Configure({ std::chrono::milliseconds{ 0 }, 4 });
+            auto first{ appends.Reserve(m_file) };
+            auto second{ appends.Reserve(m_file) };
+            auto third{ appends.Reserve(m_file) };
+            appends.Submit(third, bytes_of("45"), [](winrt::hresult) {});
+            appends.Submit(second, bytes_of("23"), [](winrt::hresult) {});
+            appends.Submit(first, bytes_of("01"), [](winrt::hresult) {});
+            TestCheck(contents_of(m_file) == "012345");
+            TestCheck(appends.Snapshot().writes == 2);
+        }
+
+        TEST_METHOD(TestSkip_letsLaterAppendsThrough) {
+            AppendCoalescer appends;
+            bool done{ false };
+            auto first{ appends.Reserve(m_file) };
+            auto second{ appends.Reserve(m_file) };
+            appends.Submit(second, bytes_of("kept"), [&](winrt::hresult result) { done = result == S_OK; });
+            TestCheck(!done);
+            appends.Skip(first);
+            TestCheck(done);
+            TestCheck(contents_of(m_file) == "kept");
+            TestCheck(appends.Snapshot().appends == 1);
+        }
+
+        TEST_METHOD(TestMaxDelay_holdsRunUntilTimer) {
+            AppendCoalescer appends;
+            appends.Configure({ std::chrono::milliseconds{ 100 }, AppendCoalescer::DefaultMaxBytes });
+
+            std::promise<void> written;
+            auto start{ std::chrono::steady_clock::now() };
+            appends.Submit(appends.Reserve(m_file), bytes_of("a"), [](winrt::hresult) {});
+            appends.Submit(appends.Reserve(m_file), bytes_of("b"), [&](winrt::hresult) { written.set_value(); });
+            TestCheck(!std::filesystem::exists(m_file));
+            TestCheck(appends.Pending() == 1);
+
+            written.get_future().wait();
+            TestCheck(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{ 90 });
+            TestCheck(contents_of(m_file) == "ab");
+            TestCheck(appends.Snapshot().writes == 1);
+        }
+
+        TEST_METHOD(TestMaxDelay_fullRunWrittenAtOnce) {
+            AppendCoalescer appends;
+            appends.Configure({ std::chrono::milliseconds{ 1000 }, 4 });
+            bool done{ false };
+            appends.Submit(appends.Reserve(m_file), bytes_of("0123"), [&](winrt::hresult) { done = true; });
+            TestCheck(done);
+            TestCheck(contents_of(m_file) == "0123");
+        }
+
+        TEST_METHOD(TestDestructor_writesDelayedRun) {
+            bool done{ false };
+            {
+                AppendCoalescer appends;
+                appends.Configure({ std::chrono::milliseconds{ 1000 }, AppendCoalescer::DefaultMaxBytes });
+                appends.Submit(appends.Reserve(m_file), bytes_of("late"), [&](winrt::hresult) { done = true; });
+                TestCheck(!done);
+            }
+            TestCheck(done);
+            TestCheck(contents_of(m_file) == "late");
+        }
+
+        TEST_METHOD(TestSubmit_missingFolder) {
+            AppendCoalescer appends;
+            winrt::hresult error;
+            appends.Submit(appends.Reserve(m_folder / L"missing" / L"log.txt"), bytes_of("x"), [&](winrt::hresult result) { error = result; });
+            TestCheck(error == HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND));
+            TestCheck(appends.Snapshot().writes == 0);
+        }
+    };
+}
@@ -0,0 +1,112 @@
+#include "pch.h"
+
+#include <chrono>
+#include <thread>
+#include "BandwidthLimiter.h"
+
+namespace ReactNativeTests {
+
+    TEST_CLASS(BandwidthLimiterTest) {
+        TEST_METHOD(TestAcquire_unlimited) {
+            BandwidthLimiter limiter;
+            auto job{ limiter.Track(1, 0) };
+            TestCheck(limiter.Acquire(1, 100 * 1024 * 1024).count() == 0);
+        }
+
+        TEST_METHOD(TestAcquire_untrackedJob) {
+            BandwidthLimiter limiter;
+            limiter.SetGlobalLimit(1000);
+            TestCheck(limiter.Acquire(7, 1000000).count() == 0);
+        }
+
+        TEST_METHOD(TestAcquire_jobLimit) {
+            BandwidthLimiter limiter;
+            auto job{ limiter.Track(1, 1000) };
+
+            // 2000 bytes at 1000 bytes/s with an empty bucket is two seconds of debt
+            auto delay{ limiter.Acquire(1, 2000).count() };
+            TestCheck(delay >= 1900 && delay <= 2000);
+        }
+
+        TEST_METHOD(TestAcquire_globalLimitIsShared) {
+            BandwidthLimiter limiter;
+            limiter.SetGlobalLimit(2000);
+            auto first{ limiter.Track(1, 0) };
+            auto second{ limiter.Track(2, 0) };
+
+            // Each of the two jobs gets 1000 bytes/s
+            auto delay{ limiter.Acquire(1, 1000).count() };
+            TestCheck(delay >= 900 && delay <= 1000);
+        }
+
+        TEST_METHOD(TestAcquire_runtimeChange) {
+            BandwidthLimiter limiter;
+            auto job{ limiter.Track(1, 1000) };
+            limiter.SetJobLimit(1, 0);
+            TestCheck(limiter.Acquire(1, 1000000).count() == 0);
+
+            limiter.SetJobLimit(1, 500);
+            auto delay{ limiter.Acquire(1, 500).count() };
+            TestCheck(delay >= 900 && delay <= 1000);
+        }
+
+        TEST_METHOD(TestAcquire_idleJobLeavesItsShare) {
+            BandwidthLimiter limiter;
+            limiter.SetGlobalLimit(2000);
+            auto first{ limiter.Track(1, 0) };
+            auto second{ limiter.Track(2, 0) };
+            TestCheck(limiter.Acquire(2, 0).count() == 0);
+
+            // The second job has not taken anything since, as if it were waiting to retry
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1100 });
+            TestCheck(limiter.Acquire(1, 0).count() == 0);
+            auto delay{ limiter.Acquire(1, 2000 + 500).count() }; // 500 bytes of burst
+            TestCheck(delay >= 900 && delay <= 1000);
+        }
+
+        TEST_METHOD(TestAcquire_cappedJobLeavesTheRest) {
+            BandwidthLimiter limiter;
+            limiter.SetGlobalLimit(2000);
+            auto capped{ limiter.Track(1, 500) };
+            auto second{ limiter.Track(2, 0) };
+
+            // The 500 bytes/s the first job cannot use of its 1000 go to the second one
+            auto delay{ limiter.Acquire(2, 1500).count() };
+            TestCheck(delay >= 900 && delay <= 1000);
+        }
+
+        TEST_METHOD(TestSetJobLimit_beforeTrack) {
+            BandwidthLimiter limiter;
+            limiter.SetJobLimit(1, 500);
+
+            // Set while the job was still queued, the limit wins over the one it starts with
+            auto job{ limiter.Track(1, 0) };
+            auto delay{ limiter.Acquire(1, 500).count() };
+            TestCheck(delay >= 900 && delay <= 1000);
+        }
+
+        TEST_METHOD(TestSetJobLimit_forgotten) {
+            BandwidthLimiter limiter;
+            {
+                auto job{ limiter.Track(1, 0) };
+                limiter.SetJobLimit(1, 500);
+                TestCheck(limiter.Acquire(1, 500).count() > 0);
+            }
+            limiter.Forget(1);
+
+            // A job that later starts with the same id is not held to it
+            auto job{ limiter.Track(1, 0) };
+            TestCheck(limiter.Acquire(1, 1000000).count() == 0);
+        }
+
+        TEST_METHOD(TestTrack_releasesOnDestruction) {
+            BandwidthLimiter limiter;
+            limiter.SetGlobalLimit(1000);
+            {
+                auto job{ limiter.Track(1, 0) };
+                TestCheck(limiter.Acquire(1, 1000).count() > 0);
+            }
+            TestCheck(limiter.Acquire(1, 1000).count() == 0);
+        }
+    };
+}
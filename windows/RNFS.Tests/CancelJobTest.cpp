@@ -0,0 +1,194 @@
+#include "pch.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include "ModuleHarness.h"
+#include "TestHooks.h"
+
+namespace ReactNativeTests {
+
+    // File operations given a jobId, stopped with cancelJob the first time they report progress,
+    // so that they are known to be part way through however fast the disk is
+    TEST_CLASS(CancelJobTest) {
+        ModuleHarness m_harness;
+        std::filesystem::path m_folder{ std::filesystem::temp_directory_path() / L"rnfs-cancel-test" };
+        int32_t m_jobId{ 0 };
+        std::atomic<uint32_t> m_progressed{ 0 }; // progress reports of the cancelled job
+
+        CancelJobTest() {
+            std::error_code ignored;
+            std::filesystem::remove_all(m_folder, ignored);
+            std::filesystem::create_directories(m_folder);
+        }
+
+        ~CancelJobTest() {
+            TestHooks::JobProgress = nullptr;
+        }
+
+        // Calls a method and, when `cancel` is set, cancels its job from its first progress report
+        template <typename... TArgs>
+        ModuleHarness::Outcome Call(bool cancel, std::wstring const& method, TArgs&&... args) {
+            if (cancel)
+            {
+                TestHooks::JobProgress = [this, jobId = m_jobId](int32_t progressed) {
+                    if (progressed == jobId && m_progressed++ == 0)
+                    {
+                        m_harness.Call0(L"cancelJob", jobId);
+                    }
+                };
+            }
+            auto outcome{ m_harness.Start(method, std::forward<TArgs>(args)...).Wait() };
+            TestHooks::JobProgress = nullptr;
+            return outcome;
+        }
+
+        React::JSValueObject JobOptions() {
+            return React::JSValueObject{ { "jobId", ++m_jobId } };
+        }
+
+        std::string Path(std::filesystem::path const& path) const {
+            return winrt::to_string(path.wstring());
+        }
+
+        static void WriteFile(std::filesystem::path const& path, size_t size) {
+            std::ofstream stream{ path, std::ios::binary | std::ios::trunc };
+            std::string block(1024 * 1024, 'x');
+            for (size_t written = 0; written < size; written += block.size())
+            {
+                stream.write(block.data(), std::min(block.size(), size - written));
+            }
+        }
+
+        bool IsCancelled(ModuleHarness::Outcome const& outcome) const {
+            return m_progressed > 0 && !outcome.resolved && outcome.value["message"].AsString().rfind("CANCELLED", 0) == 0;
+        }
+
+        static std::set<std::wstring> Names(std::filesystem::path const& folder) {
+            std::set<std::wstring> names;
+            for (auto const& entry : std::filesystem::directory_iterator{ folder })
+            {
+                names.insert(entry.path().filename().wstring());
+            }
+            return names;
+        }
+
+        TEST_METHOD(TestCancelJob_unknownJob) {
+            m_harness.Call0(L"cancelJob", 424242);
+
+            std::ofstream{ m_folder / L"small.txt" } << "hello";
+            auto outcome{ Call(false, L"readFile", Path(m_folder / L"small.txt"), JobOptions()) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value == "aGVsbG8=");
+        }
+
+        TEST_METHOD(TestReadFile_cancelled) {
+            WriteFile(m_folder / L"large.bin", 8 * 1024 * 1024);
+            auto outcome{ Call(true, L"readFile", Path(m_folder / L"large.bin"), JobOptions()) };
+            TestCheck(IsCancelled(outcome));
+        }
+
+        TEST_METHOD(TestHash_chunked) {
+            // Spans several chunks, so the hash must come out the same as in one piece
+            WriteFile(m_folder / L"hash.bin", 3 * 1024 * 1024 + 17);
+            std::ifstream stream{ m_folder / L"hash.bin", std::ios::binary };
+            std::vector<uint8_t> contents{ std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{} };
+            auto provider{ CryptographyCore::HashAlgorithmProvider::OpenAlgorithm(CryptographyCore::HashAlgorithmNames::Sha256()) };
+            auto expected{ winrt::to_string(Cryptography::CryptographicBuffer::EncodeToHexString(
+                provider.HashData(Cryptography::CryptographicBuffer::CreateFromByteArray(contents)))) };
+
+            auto outcome{ Call(false, L"hash", Path(m_folder / L"hash.bin"), std::string{ "sha256" }, React::JSValueObject{}) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value == expected);
+        }
+
+        TEST_METHOD(TestHash_cancelled) {
+            WriteFile(m_folder / L"large.bin", 8 * 1024 * 1024);
+            auto outcome{ Call(true, L"hash", Path(m_folder / L"large.bin"), std::string{ "md5" }, JobOptions()) };
+            TestCheck(IsCancelled(outcome));
+        }
+
+        TEST_METHOD(TestCopyFile_cancelledRemovesCopy) {
+            WriteFile(m_folder / L"large.bin", 64 * 1024 * 1024);
+            auto outcome{ Call(true, L"copyFile", Path(m_folder / L"large.bin"), Path(m_folder / L"copy.bin"), JobOptions()) };
+            TestCheck(IsCancelled(outcome));
+            TestCheck(!std::filesystem::exists(m_folder / L"copy.bin"));
+            TestCheck(Names(m_folder) == std::set<std::wstring>{ L"large.bin" });
+        }
+
+        TEST_METHOD(TestCopyFile_cancelledKeepsExistingDestination) {
+            WriteFile(m_folder / L"large.bin", 64 * 1024 * 1024);
+            std::ofstream{ m_folder / L"copy.bin", std::ios::binary } << "the user's own file";
+            auto outcome{ Call(true, L"copyFile", Path(m_folder / L"large.bin"), Path(m_folder / L"copy.bin"), JobOptions()) };
+            TestCheck(IsCancelled(outcome));
+
+            std::ifstream stream{ m_folder / L"copy.bin", std::ios::binary };
+            TestCheck(std::string{ std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{} } == "the user's own file");
+            TestCheck(Names(m_folder) == (std::set<std::wstring>{ L"copy.bin", L"large.bin" }));
+        }
+
+        TEST_METHOD(TestCopyFile_withJobId) {
+            WriteFile(m_folder / L"source.bin", 3 * 1024 * 1024);
+            auto outcome{ Call(false, L"copyFile", Path(m_folder / L"source.bin"), Path(m_folder / L"copy.bin"), JobOptions()) };
+            TestCheck(outcome.resolved);
+            TestCheck(std::filesystem::file_size(m_folder / L"copy.bin") == 3 * 1024 * 1024);
+        }
+
+        TEST_METHOD(TestCopyFolder_waitsForSubfolders) {
+            std::filesystem::create_directories(m_folder / L"tree" / L"a" / L"b" / L"c");
+            WriteFile(m_folder / L"tree" / L"a" / L"b" / L"c" / L"deep.bin", 1024);
+            WriteFile(m_folder / L"tree" / L"top.bin", 1024);
+            std::filesystem::create_directories(m_folder / L"copy");
+
+            auto outcome{ Call(false, L"copyFolder", Path(m_folder / L"tree"), Path(m_folder / L"copy"), React::JSValueObject{}) };
+            TestCheck(outcome.resolved);
+            TestCheck(std::filesystem::exists(m_folder / L"copy" / L"top.bin"));
+            TestCheck(std::filesystem::exists(m_folder / L"copy" / L"a" / L"b" / L"c" / L"deep.bin"));
+        }
+
+        TEST_METHOD(TestCopyFolder_cancelledRemovesCopies) {
+            std::filesystem::create_directories(m_folder / L"tree" / L"sub");
+            for (int i = 0; i < 20; ++i)
+            {
+                WriteFile(m_folder / L"tree" / (std::to_wstring(i) + L".bin"), 1024);
+                WriteFile(m_folder / L"tree" / L"sub" / (std::to_wstring(i) + L".bin"), 1024);
+            }
+            std::filesystem::create_directories(m_folder / L"copy");
+            WriteFile(m_folder / L"copy" / L"kept.bin", 1024);
+            for (int i = 0; i < 20; i += 2)
+            {
+                WriteFile(m_folder / L"copy" / (std::to_wstring(i) + L".bin"), 16); // overwritten by the copy
+            }
+            auto before{ Names(m_folder / L"copy") };
+
+            // Whatever was copied before the cancellation is gone again, and what was there before stays
+            auto outcome{ Call(true, L"copyFolder", Path(m_folder / L"tree"), Path(m_folder / L"copy"), JobOptions()) };
+            TestCheck(IsCancelled(outcome));
+            TestCheck(Names(m_folder / L"copy") == before);
+        }
+
+        TEST_METHOD(TestUnlink_recursiveWithJobId) {
+            std::filesystem::create_directories(m_folder / L"doomed" / L"a" / L"b");
+            WriteFile(m_folder / L"doomed" / L"a" / L"b" / L"file.bin", 1024);
+            WriteFile(m_folder / L"doomed" / L"file.bin", 1024);
+
+            auto outcome{ Call(false, L"unlink", Path(m_folder / L"doomed"), JobOptions()) };
+            TestCheck(outcome.resolved);
+            TestCheck(!std::filesystem::exists(m_folder / L"doomed"));
+        }
+
+        TEST_METHOD(TestUnlink_cancelled) {
+            std::filesystem::create_directories(m_folder / L"doomed");
+            for (int i = 0; i < 200; ++i)
+            {
+                WriteFile(m_folder / L"doomed" / (std::to_wstring(i) + L".bin"), 16);
+            }
+
+            // The entry removed before the cancellation stays removed
+            auto outcome{ Call(true, L"unlink", Path(m_folder / L"doomed"), JobOptions()) };
+            TestCheck(IsCancelled(outcome));
+            TestCheck(Names(m_folder / L"doomed").size() == 199);
+        }
+    };
+}
@@ -0,0 +1,186 @@
+#include "pch.h"
+
+#include <string>
+#include "Deflate.h"
+
+namespace ReactNativeTests {
+
+    // "squirrels squirrels squirrels squirrels" in the three supported framings
+    const std::vector<uint8_t> gzipSquirrels{
+        0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x2b, 0x2e, 0x2c, 0xcd, 0x2c, 0x2a, 0x4a, 0xcd, 0x29, 0x56, 0x28,
+        0xc6, 0xc7, 0x02, 0x00, 0x1f, 0x2b, 0x26, 0xc7, 0x27, 0x00, 0x00, 0x00 };
+    const std::vector<uint8_t> zlibSquirrels{
+        0x78, 0xda, 0x2b, 0x2e, 0x2c, 0xcd, 0x2c, 0x2a, 0x4a, 0xcd, 0x29, 0x56, 0x28, 0xc6, 0xc7, 0x02, 0x00, 0x41, 0x6e, 0x10, 0x09 };
+    const std::vector<uint8_t> storedSquirrels{
+        0x01, 0x27, 0x00, 0xd8, 0xff, 0x73, 0x71, 0x75, 0x69, 0x72, 0x72, 0x65, 0x6c, 0x73, 0x20, 0x73, 0x71, 0x75, 0x69, 0x72, 0x72,
+        0x65, 0x6c, 0x73, 0x20, 0x73, 0x71, 0x75, 0x69, 0x72, 0x72, 0x65, 0x6c, 0x73, 0x20, 0x73, 0x71, 0x75, 0x69, 0x72, 0x72, 0x65,
+        0x6c, 0x73 };
+    const std::string squirrels{ "squirrels squirrels squirrels squirrels" };
+
+    static std::string Inflate(StreamingInflater::Format format, std::vector<uint8_t> const& input, size_t chunkSize)
+    {
+        StreamingInflater inflater{ format };
+        std::vector<uint8_t> output;
+        for (size_t offset = 0; offset < input.size(); offset += chunkSize)
+        {
+            inflater.Write(input.data() + offset, std::min(chunkSize, input.size() - offset), output);
+        }
+        inflater.Finish(output);
+        return std::string(output.begin(), output.end());
+    }
+
+    TEST_CLASS(StreamingInflaterTest) {
+        TEST_METHOD(TestInflate_gzip) {
+            TestCheck(Inflate(StreamingInflater::Format::Gzip, gzipSquirrels, gzipSquirrels.size()) == squirrels);
+        }
+
+        TEST_METHOD(TestInflate_gzipByteAtATime) {
+            TestCheck(Inflate(StreamingInflater::Format::Gzip, gzipSquirrels, 1) == squirrels);
+        }
+
+        TEST_METHOD(TestInflate_autoDetect) {
+            TestCheck(Inflate(StreamingInflater::Format::Auto, gzipSquirrels, 7) == squirrels);
+            TestCheck(Inflate(StreamingInflater::Format::Auto, zlibSquirrels, 7) == squirrels);
+            TestCheck(Inflate(StreamingInflater::Format::Auto, storedSquirrels, 7) == squirrels);
+        }
+
+        TEST_METHOD(TestInflate_truncated) {
+            std::vector<uint8_t> truncated{ gzipSquirrels.begin(), gzipSquirrels.end() - 4 };
+            bool threw{ false };
+            try
+            {
+                Inflate(StreamingInflater::Format::Gzip, truncated, 8);
+            }
+            catch (DeflateError const&)
+            {
+                threw = true;
+            }
+            TestCheck(threw);
+        }
+
+        TEST_METHOD(TestInflate_corruptChecksum) {
+            std::vector<uint8_t> corrupt{ zlibSquirrels };
+            corrupt[corrupt.size() - 1] ^= 0xff;
+            bool threw{ false };
+            try
+            {
+                Inflate(StreamingInflater::Format::Zlib, corrupt, 8);
+            }
+            catch (DeflateError const&)
+            {
+                threw = true;
+            }
+            TestCheck(threw);
+        }
+
+        TEST_METHOD(TestInflate_gzipMembers) {
+            auto members{ gzipSquirrels };
+            members.insert(members.end(), gzipSquirrels.begin(), gzipSquirrels.end());
+            TestCheck(Inflate(StreamingInflater::Format::Gzip, members, 5) == squirrels + squirrels);
+        }
+
+        TEST_METHOD(TestInflate_trailingGarbage) {
+            auto padded{ zlibSquirrels };
+            padded.push_back(0);
+            bool threw{ false };
+            try
+            {
+                Inflate(StreamingInflater::Format::Zlib, padded, 8);
+            }
+            catch (DeflateError const&)
+            {
+                threw = true;
+            }
+            TestCheck(threw);
+        }
+
+        TEST_METHOD(TestInflate_mutatedInput) {
+            // Bodies come off the network: every corruption must end in output or DeflateError, never worse
+            std::vector<uint8_t> text(64 * 1024);
+            for (size_t i = 0; i < text.size(); ++i)
+            {
+                text[i] = static_cast<uint8_t>("squirrels "[i % 10] + i / 4096);
+            }
+            StreamingDeflater deflater{ StreamingDeflater::Format::Gzip };
+            std::vector<uint8_t> compressed;
+            deflater.Write(text.data(), text.size(), compressed);
+            deflater.Finish(compressed);
+
+            uint32_t state{ 2024 };
+            for (int round = 0; round < 2000; ++round)
+            {
+                auto mutated{ compressed };
+                for (int flip = 0; flip < 1 + round % 4; ++flip)
+                {
+                    state = state * 1103515245 + 12345;
+                    mutated[(state >> 8) % mutated.size()] ^= static_cast<uint8_t>(1 + (state >> 24) % 255);
+                }
+                try
+                {
+                    Inflate(StreamingInflater::Format::Auto, mutated, 1 + round % 700);
+                }
+                catch (DeflateError const&)
+                {
+                }
+            }
+            TestCheck(Inflate(StreamingInflater::Format::Auto, compressed, 700) == std::string(text.begin(), text.end()));
+        }
+    };
+
+    static std::vector<uint8_t> Deflate(StreamingDeflater::Format format, std::vector<uint8_t> const& input, size_t chunkSize)
+    {
+        StreamingDeflater deflater{ format };
+        std::vector<uint8_t> output;
+        for (size_t offset = 0; offset < input.size(); offset += chunkSize)
+        {
+            deflater.Write(input.data() + offset, std::min(chunkSize, input.size() - offset), output);
+        }
+        deflater.Finish(output);
+        return output;
+    }
+
+    static std::vector<uint8_t> LogLines(size_t count)
+    {
+        std::string text;
+        for (size_t i = 0; i < count; ++i)
+        {
+            text += "2024-01-01T00:00:" + std::to_string(i % 60) + " INFO request " + std::to_string(i * 7919 % 1000) + " served\n";
+        }
+        return { text.begin(), text.end() };
+    }
+
+    TEST_CLASS(StreamingDeflaterTest) {
+        TEST_METHOD(TestDeflate_roundTrip) {
+            auto const input{ LogLines(20000) };
+            for (auto format : { StreamingDeflater::Format::Raw, StreamingDeflater::Format::Zlib, StreamingDeflater::Format::Gzip })
+            {
+                auto const compressed{ Deflate(format, input, 1000) };
+                TestCheck(compressed.size() < input.size() / 4);
+
+                auto const inflaterFormat{ format == StreamingDeflater::Format::Raw ? StreamingInflater::Format::Raw :
+                    format == StreamingDeflater::Format::Zlib ? StreamingInflater::Format::Zlib : StreamingInflater::Format::Gzip };
+                TestCheck(Inflate(inflaterFormat, compressed, 4096) == std::string(input.begin(), input.end()));
+            }
+        }
+
+        TEST_METHOD(TestDeflate_incompressible) {
+            std::vector<uint8_t> input(200000);
+            uint32_t state{ 12345 };
+            for (auto& byte : input)
+            {
+                state = state * 1103515245 + 12345;
+                byte = static_cast<uint8_t>(state >> 16);
+            }
+
+            auto const compressed{ Deflate(StreamingDeflater::Format::Gzip, input, 65536) };
+            TestCheck(compressed.size() < input.size() + 64); // falls back to stored blocks
+            TestCheck(Inflate(StreamingInflater::Format::Gzip, compressed, 4096) == std::string(input.begin(), input.end()));
+        }
+
+        TEST_METHOD(TestDeflate_empty) {
+            auto const compressed{ Deflate(StreamingDeflater::Format::Gzip, {}, 1) };
+            TestCheck(compressed.size() >= 2 && compressed[0] == 0x1f && compressed[1] == 0x8b);
+            TestCheck(Inflate(StreamingInflater::Format::Gzip, compressed, 1).empty());
+        }
+    };
+}
@@ -0,0 +1,177 @@
+#include "pch.h"
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "EventBus.h"
+
+namespace ReactNativeTests {
+
+    // Collects the batches a bus delivers
+    struct BatchSink
+    {
+        std::mutex mutex;
+        std::vector<React::JSValueArray> batches;
+
+        EventBus::Sink Sink() {
+            return [this](React::JSValueArray batch)
+                {
+                    std::lock_guard lock{ mutex };
+                    batches.push_back(std::move(batch));
+                };
+        }
+
+        size_t Count() {
+            std::lock_guard lock{ mutex };
+            return batches.size();
+        }
+    };
+
+    template <typename TPredicate>
+    static bool wait_for_batches(TPredicate predicate)
+    {
+        for (int i = 0; i < 5000 && !predicate(); ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+        return predicate();
+    }
+
+    TEST_CLASS(EventBusTest) {
+        TEST_METHOD(TestFlush_oneBatchInOrder) {
+            BatchSink sink;
+            EventBus bus{ std::chrono::seconds{ 10 } };
+            bus.SetSink(sink.Sink());
+            bus.Post("UploadBegin", React::JSValueObject{ { "jobId", 1 } });
+            bus.Post("DownloadBegin", React::JSValueObject{ { "jobId", 2 } });
+            bus.Post("UploadBegin", React::JSValueObject{ { "jobId", 3 } });
+            bus.Flush();
+
+            TestCheck(sink.batches.size() == 1);
+            auto const& batch{ sink.batches[0] };
+            TestCheck(batch.size() == 3);
+            TestCheck(batch[0]["name"] == "UploadBegin");
+            TestCheck(batch[1]["name"] == "DownloadBegin");
+            TestCheck(batch[2]["body"]["jobId"] == 3);
+
+            bus.Flush();
+            TestCheck(sink.batches.size() == 1);
+        }
+
+        TEST_METHOD(TestPostProgress_supersedesQueued) {
+            BatchSink sink;
+            EventBus bus{ std::chrono::seconds{ 10 } };
+            bus.SetSink(sink.Sink());
+            bus.Post("DownloadBegin", React::JSValueObject{ { "jobId", 1 } });
+            bus.PostProgress("DownloadProgress", 1, React::JSValueObject{ { "jobId", 1 }, { "bytesWritten", 10 } });
+            bus.PostProgress("DownloadProgress", 2, React::JSValueObject{ { "jobId", 2 }, { "bytesWritten", 5 } });
+            bus.PostProgress("DownloadProgress", 1, React::JSValueObject{ { "jobId", 1 }, { "bytesWritten", 20 } });
+            bus.Post("DownloadBegin", React::JSValueObject{ { "jobId", 3 } });
+            bus.Flush();
+
+            auto const& batch{ sink.batches[0] };
+            TestCheck(batch.size() == 4);
+            TestCheck(batch[0]["name"] == "DownloadBegin");
+            TestCheck(batch[1]["body"]["jobId"] == 2);
+            TestCheck(batch[2]["body"]["bytesWritten"] == 20);
+            TestCheck(batch[3]["body"]["jobId"] == 3);
+
+            auto counters{ bus.Snapshot() };
+            TestCheck(counters.posted == 5);
+            TestCheck(counters.superseded == 1);
+            TestCheck(counters.delivered == 4);
+            TestCheck(counters.batches == 1);
+
+            // Delivered progress is not superseded by the next one
+            bus.PostProgress("DownloadProgress", 1, React::JSValueObject{ { "jobId", 1 }, { "bytesWritten", 30 } });
+            bus.Flush();
+            TestCheck(sink.batches.size() == 2);
+            TestCheck(bus.Snapshot().superseded == 1);
+        }
+
+        TEST_METHOD(TestPost_deliveredWithinInterval) {
+            BatchSink sink;
+            EventBus bus;
+            bus.SetSink(sink.Sink());
+            bus.Post("UploadBegin", React::JSValueObject{ { "jobId", 1 } });
+            TestCheck(wait_for_batches([&] { return sink.Count() == 1; }));
+        }
+
+        TEST_METHOD(TestPost_fullBatchSentEarly) {
+            BatchSink sink;
+            EventBus bus{ std::chrono::seconds{ 60 } };
+            bus.SetSink(sink.Sink());
+            for (int32_t i = 0; i < static_cast<int32_t>(EventBus::MaxBatch); ++i)
+            {
+                bus.Post("UploadBegin", React::JSValueObject{ { "jobId", i } });
+            }
+            TestCheck(wait_for_batches([&] { return sink.Count() == 1; }));
+            TestCheck(bus.Snapshot().delivered == EventBus::MaxBatch);
+        }
+
+        TEST_METHOD(TestSetSink_deliversEarlierEvents) {
+            BatchSink sink;
+            EventBus bus;
+            bus.Post("DownloadBegin", React::JSValueObject{ { "jobId", 1 } });
+            bus.Flush();
+            TestCheck(bus.Snapshot().delivered == 0);
+
+            bus.SetSink(sink.Sink());
+            TestCheck(wait_for_batches([&] { return sink.Count() == 1; }));
+        }
+
+        TEST_METHOD(TestPostProgress_manyJobs) {
+            constexpr int Jobs = 16;
+            constexpr int Updates = 1000;
+
+            BatchSink sink;
+            EventBus bus;
+            bus.SetSink(sink.Sink());
+            std::vector<std::thread> jobs;
+            for (int32_t job = 0; job < Jobs; ++job)
+            {
+                jobs.emplace_back([&bus, job]
+                    {
+                        bus.Post("UploadBegin", React::JSValueObject{ { "jobId", job } });
+                        for (int update = 1; update <= Updates; ++update)
+                        {
+                            bus.PostProgress("UploadProgress", job, React::JSValueObject{ { "jobId", job }, { "totalBytesSent", update } });
+                        }
+                    });
+            }
+            for (auto& job : jobs)
+            {
+                job.join();
+            }
+            bus.Flush();
+
+            // Every job's progress arrives in order and ends with its last update
+            std::map<int32_t, int64_t> lastSent;
+            bool ordered{ true };
+            for (auto const& batch : sink.batches)
+            {
+                for (auto const& event : batch)
+                {
+                    if (event["name"] == "UploadProgress")
+                    {
+                        auto& last{ lastSent[event["body"]["jobId"].AsInt32()] };
+                        ordered = ordered && event["body"]["totalBytesSent"].AsInt64() > last;
+                        last = event["body"]["totalBytesSent"].AsInt64();
+                    }
+                }
+            }
+            TestCheck(ordered);
+            TestCheck(lastSent.size() == Jobs);
+            for (auto const& [job, sent] : lastSent)
+            {
+                TestCheck(sent == Updates);
+            }
+
+            auto counters{ bus.Snapshot() };
+            TestCheck(counters.posted == Jobs * (Updates + 1));
+            TestCheck(counters.delivered + counters.superseded == counters.posted);
+            TestCheck(counters.batches < counters.posted / 10);
+        }
+    };
+}
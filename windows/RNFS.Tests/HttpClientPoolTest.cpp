@@ -0,0 +1,56 @@
+#include "pch.h"
+
+#include "HttpClientPool.h"
+#include <winrt/Windows.Web.Http.Headers.h>
+
+namespace ReactNativeTests {
+
+    TEST_CLASS(HttpClientPoolTest) {
+        TEST_METHOD(TestParseTransferPriority) {
+            TestCheck(ParseTransferPriority("") == TransferPriority::Normal);
+            TestCheck(ParseTransferPriority("normal") == TransferPriority::Normal);
+            TestCheck(ParseTransferPriority("interactive") == TransferPriority::Interactive);
+            TestCheck(ParseTransferPriority("background") == TransferPriority::Background);
+            TestCheck(!ParseTransferPriority("urgent"));
+        }
+
+        TEST_METHOD(TestSettings_defaults) {
+            HttpClientPool pool;
+            TestCheck(pool.Settings(TransferPriority::Interactive).maxConnectionsPerServer == 8);
+            TestCheck(pool.Settings(TransferPriority::Normal).maxConnectionsPerServer == 6);
+            TestCheck(pool.Settings(TransferPriority::Background).maxConnectionsPerServer == 2);
+            TestCheck(pool.Settings(TransferPriority::Normal).bypassCache);
+            TestCheck(pool.Settings(TransferPriority::Normal).keepAlive);
+        }
+
+        TEST_METHOD(TestGet_reusesClientPerClass) {
+            HttpClientPool pool;
+            auto normal{ pool.Get(TransferPriority::Normal) };
+            TestCheck(pool.Get(TransferPriority::Normal) == normal);
+            TestCheck(pool.Get(TransferPriority::Interactive) != normal);
+            TestCheck(pool.Get(TransferPriority::Background) != normal);
+            TestCheck(pool.Get(TransferPriority::Background) != pool.Get(TransferPriority::Interactive));
+        }
+
+        TEST_METHOD(TestConfigure_replacesOnlyThatClient) {
+            HttpClientPool pool;
+            auto normal{ pool.Get(TransferPriority::Normal) };
+            auto background{ pool.Get(TransferPriority::Background) };
+
+            HttpClientSettings settings;
+            settings.maxConnectionsPerServer = 1;
+            settings.keepAlive = false;
+            pool.Configure(TransferPriority::Normal, settings);
+            TestCheck(pool.Settings(TransferPriority::Normal).maxConnectionsPerServer == 1);
+
+            auto replaced{ pool.Get(TransferPriority::Normal) };
+            TestCheck(replaced != normal);
+            TestCheck(pool.Get(TransferPriority::Normal) == replaced);
+            TestCheck(pool.Get(TransferPriority::Background) == background);
+
+            // Without keep-alive every request asks the server to close the connection
+            TestCheck(replaced.DefaultRequestHeaders().Connection().ToString() == L"close");
+            TestCheck(normal.DefaultRequestHeaders().Connection().Size() == 0);
+        }
+    };
+}
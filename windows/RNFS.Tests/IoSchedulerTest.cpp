@@ -0,0 +1,174 @@
+#include "pch.h"
+
+#include <functional>
+#include <optional>
+#include <thread>
+#include <vector>
+#include "IoScheduler.h"
+
+namespace ReactNativeTests {
+
+    using winrt::Windows::Foundation::IAsyncAction;
+
+    // Runs `work` in a slot of the scheduler
+    static IAsyncAction run_in_slot(IoScheduler& io, TransferPriority priority, std::function<void()> work)
+    {
+        auto slot{ co_await io.Schedule(priority) };
+        work();
+    }
+
+    // Takes a slot and keeps it until `release` is signaled
+    static IAsyncAction hold_slot(IoScheduler& io, TransferPriority priority, HANDLE release)
+    {
+        auto slot{ co_await io.Schedule(priority) };
+        co_await winrt::resume_on_signal(release);
+    }
+
+    template <typename TPredicate>
+    static bool wait_until(TPredicate predicate)
+    {
+        for (int i = 0; i < 5000 && !predicate(); ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+        return predicate();
+    }
+
+    TEST_CLASS(IoSchedulerTest) {
+        winrt::handle m_release{ CreateEvent(nullptr, true, false, nullptr) };
+
+        TEST_METHOD(TestSchedule_resumesOnWorker) {
+            IoScheduler io{ 2 };
+            auto caller{ std::this_thread::get_id() };
+            std::thread::id worker;
+            run_in_slot(io, TransferPriority::Normal, [&] { worker = std::this_thread::get_id(); }).get();
+
+            TestCheck(worker != caller);
+            auto lane{ io.Snapshot(TransferPriority::Normal) };
+            TestCheck(lane.scheduled == 1);
+            TestCheck(lane.queued == 0);
+            TestCheck(io.Snapshot(TransferPriority::Interactive).scheduled == 0);
+        }
+
+        TEST_METHOD(TestSchedule_boundedByWorkers) {
+            IoScheduler io{ 2 };
+            std::atomic<int> running{ 0 };
+            std::atomic<int> mostRunning{ 0 };
+            std::vector<IAsyncAction> operations;
+            for (int i = 0; i < 8; ++i)
+            {
+                operations.push_back(run_in_slot(io, TransferPriority::Interactive, [&]
+                    {
+                        auto now{ ++running };
+                        for (auto most{ mostRunning.load() }; now > most && !mostRunning.compare_exchange_weak(most, now);)
+                        {
+                        }
+                        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+                        --running;
+                    }));
+            }
+            for (auto& operation : operations)
+            {
+                operation.get();
+            }
+
+            TestCheck(mostRunning <= 2);
+            TestCheck(io.Snapshot(TransferPriority::Interactive).scheduled == 8);
+            TestCheck(io.Snapshot(TransferPriority::Interactive).maxWaitMicroseconds >= 20000);
+        }
+
+        TEST_METHOD(TestSchedule_interactiveFirst) {
+            IoScheduler io{ 1 };
+            auto blocker{ hold_slot(io, TransferPriority::Normal, m_release.get()) };
+            TestCheck(wait_until([&] { return io.Snapshot(TransferPriority::Normal).scheduled == 1; }));
+
+            std::mutex mutex;
+            std::vector<std::string> order;
+            auto record = [&](TransferPriority priority, std::string name)
+            {
+                return run_in_slot(io, priority, [&mutex, &order, name]
+                    {
+                        std::lock_guard lock{ mutex };
+                        order.push_back(name);
+                    });
+            };
+            auto background{ record(TransferPriority::Background, "background") };
+            auto normal{ record(TransferPriority::Normal, "normal") };
+            auto interactive{ record(TransferPriority::Interactive, "interactive") };
+            TestCheck(io.Snapshot(TransferPriority::Background).queued == 1);
+
+            SetEvent(m_release.get());
+            blocker.get();
+            background.get();
+            normal.get();
+            interactive.get();
+            TestCheck((order == std::vector<std::string>{ "interactive", "normal", "background" }));
+        }
+
+        TEST_METHOD(TestSchedule_backgroundShare) {
+            // Background operations get half of the slots, leaving the rest to the other lanes
+            IoScheduler io{ 4 };
+            std::vector<IAsyncAction> holders;
+            for (int i = 0; i < 4; ++i)
+            {
+                holders.push_back(hold_slot(io, TransferPriority::Background, m_release.get()));
+            }
+            TestCheck(wait_until([&] { return io.Snapshot(TransferPriority::Background).scheduled == 2; }));
+            TestCheck(io.Snapshot(TransferPriority::Background).queued == 2);
+
+            bool ran{ false };
+            run_in_slot(io, TransferPriority::Normal, [&] { ran = true; }).get();
+            TestCheck(ran);
+            TestCheck(io.Snapshot(TransferPriority::Background).scheduled == 2);
+
+            SetEvent(m_release.get());
+            for (auto& holder : holders)
+            {
+                holder.get();
+            }
+            TestCheck(io.Snapshot(TransferPriority::Background).scheduled == 4);
+        }
+
+        TEST_METHOD(TestShutdown_cancelsQueued) {
+            std::optional<IoScheduler> io{ std::in_place, 1 };
+            auto blocker{ hold_slot(*io, TransferPriority::Normal, m_release.get()) };
+            TestCheck(wait_until([&] { return io->Snapshot(TransferPriority::Normal).scheduled == 1; }));
+
+            bool ran{ false };
+            auto queued{ run_in_slot(*io, TransferPriority::Normal, [&] { ran = true; }) };
+            io.reset();
+
+            bool cancelled{ false };
+            try
+            {
+                queued.get();
+            }
+            catch (winrt::hresult_canceled const&)
+            {
+                cancelled = true;
+            }
+            TestCheck(cancelled);
+            TestCheck(!ran);
+
+            // The slot outlives the scheduler
+            SetEvent(m_release.get());
+            blocker.get();
+        }
+
+        TEST_METHOD(TestReset_keepsQueued) {
+            IoScheduler io{ 1 };
+            auto blocker{ hold_slot(io, TransferPriority::Normal, m_release.get()) };
+            TestCheck(wait_until([&] { return io.Snapshot(TransferPriority::Normal).scheduled == 1; }));
+            auto queued{ run_in_slot(io, TransferPriority::Background, [] {}) };
+
+            io.Reset();
+            TestCheck(io.Snapshot(TransferPriority::Normal).scheduled == 0);
+            TestCheck(io.Snapshot(TransferPriority::Background).queued == 1);
+
+            SetEvent(m_release.get());
+            blocker.get();
+            queued.get();
+            TestCheck(io.Snapshot(TransferPriority::Background).scheduled == 1);
+        }
+    };
+}
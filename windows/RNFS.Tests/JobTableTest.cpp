@@ -0,0 +1,161 @@
+#include "pch.h"
+
+#include <thread>
+#include <vector>
+#include "JobTable.h"
+
+namespace ReactNativeTests {
+
+    using winrt::Windows::Foundation::AsyncStatus;
+    using winrt::Windows::Foundation::IAsyncAction;
+
+    static IAsyncAction run_until_cancelled()
+    {
+        for (;;)
+        {
+            co_await winrt::resume_after(std::chrono::milliseconds{ 1 });
+        }
+    }
+
+    TEST_CLASS(JobTableTest) {
+        TEST_METHOD(TestAdd_queuedUntilRemoved) {
+            JobTable jobs;
+            auto job{ jobs.Add(7) };
+            TestCheck(job->Id() == 7);
+            TestCheck(job->State() == JobState::Queued);
+            TestCheck(jobs.Add(7) == job);
+            TestCheck(jobs.Find(7) == job);
+            TestCheck(jobs.Size() == 1);
+
+            jobs.Remove(7);
+            TestCheck(job->State() == JobState::Done);
+            TestCheck(!job->Cancelled());
+            TestCheck(jobs.Find(7) == nullptr);
+            TestCheck(jobs.Size() == 0);
+        }
+
+        TEST_METHOD(TestProgress_readableFromTheJob) {
+            JobTable jobs;
+            auto job{ jobs.Add(1) };
+            job->Progress(10, 100);
+            job->Progress(40);
+
+            auto found{ jobs.Find(1) };
+            TestCheck(found->BytesTransferred() == 40);
+            TestCheck(found->BytesExpected() == 100);
+        }
+
+        TEST_METHOD(TestJobs_listsRegistered) {
+            JobTable jobs;
+            jobs.Add(1);
+            jobs.Add(65); // same shard as 1
+            jobs.Add(2)->Progress(5, 10);
+            jobs.Remove(1);
+
+            auto listed{ jobs.Jobs() };
+            TestCheck(listed.size() == 2);
+            for (auto const& job : listed)
+            {
+                TestCheck(job->Id() == 2 || job->Id() == 65);
+                TestCheck(job->BytesTransferred() == (job->Id() == 2 ? 5u : 0u));
+            }
+        }
+
+        TEST_METHOD(TestCancel_running) {
+            JobTable jobs;
+            auto job{ jobs.Add(3) };
+            auto action{ jobs.Start(job, run_until_cancelled()) };
+            TestCheck(job->State() == JobState::Running);
+            TestCheck(action.Status() == AsyncStatus::Started);
+
+            jobs.Cancel(3);
+            TestCheck(action.Status() == AsyncStatus::Canceled);
+            TestCheck(job->Cancelled());
+            TestCheck(job->State() == JobState::Done);
+            TestCheck(jobs.Find(3) == nullptr);
+        }
+
+        TEST_METHOD(TestCancel_whileQueued) {
+            JobTable jobs;
+            auto job{ jobs.Add(4) };
+            jobs.Cancel(4);
+
+            auto action{ jobs.Start(job, run_until_cancelled()) };
+            TestCheck(action.Status() == AsyncStatus::Canceled);
+            TestCheck(job->State() == JobState::Done);
+        }
+
+        TEST_METHOD(TestCancel_unknownJob) {
+            JobTable jobs;
+            jobs.Cancel(42);
+            jobs.Remove(42);
+            TestCheck(jobs.Size() == 0);
+        }
+
+        TEST_METHOD(TestStress_manyThreads) {
+            constexpr int Threads = 16;
+            constexpr int JobsPerThread = 2000;
+
+            JobTable jobs;
+            std::atomic<bool> writing{ true };
+            std::atomic<uint64_t> mismatches{ 0 };
+
+            // Readers look up jobs the writers are adding and removing
+            std::vector<std::thread> readers;
+            for (int t = 0; t < 4; ++t)
+            {
+                readers.emplace_back([&jobs, &writing, &mismatches, t]
+                    {
+                        uint32_t jobId = t;
+                        while (writing)
+                        {
+                            jobId = (jobId * 1103515245 + 12345) % (Threads * JobsPerThread);
+                            if (auto job{ jobs.Find(static_cast<JobTable::JobId>(jobId)) })
+                            {
+                                mismatches += job->Id() != static_cast<JobTable::JobId>(jobId) ? 1 : 0;
+                            }
+                        }
+                    });
+            }
+
+            std::vector<std::thread> writers;
+            for (int t = 0; t < Threads; ++t)
+            {
+                writers.emplace_back([&jobs, &mismatches, t]
+                    {
+                        for (int i = 0; i < JobsPerThread; ++i)
+                        {
+                            JobTable::JobId jobId{ t * JobsPerThread + i };
+                            auto job{ jobs.Add(jobId) };
+                            job->Progress(0, 1000);
+                            job->SetState(JobState::Running);
+                            job->Progress(1000);
+                            mismatches += jobs.Find(jobId) != job ? 1 : 0;
+                            if (i % 2)
+                            {
+                                jobs.Cancel(jobId);
+                            }
+                            else
+                            {
+                                jobs.Remove(jobId);
+                            }
+                            mismatches += job->State() != JobState::Done ? 1 : 0;
+                        }
+                    });
+            }
+
+            for (auto& writer : writers)
+            {
+                writer.join();
+            }
+            writing = false;
+            for (auto& reader : readers)
+            {
+                reader.join();
+            }
+
+            TestCheck(mismatches == 0);
+            TestCheck(jobs.Size() == 0);
+        }
+    };
+}
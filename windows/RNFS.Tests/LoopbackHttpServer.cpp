@@ -0,0 +1,598 @@
+#include "pch.h"
+
+#include "LoopbackHttpServer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <winrt/Windows.Networking.h>
+#include <winrt/Windows.Storage.Streams.h>
+
+using namespace winrt;
+using namespace winrt::Windows::Foundation;
+using namespace winrt::Windows::Networking;
+using namespace winrt::Windows::Networking::Sockets;
+using namespace winrt::Windows::Storage::Streams;
+
+struct LoopbackHttpServer::State
+{
+    struct Failure
+    {
+        int status{ 0 };
+        uint32_t remaining{ 0 };
+        uint32_t retryAfterSeconds{ 0 };
+    };
+
+    struct Upload
+    {
+        uint64_t length{ 0 };
+        std::string data;
+    };
+
+    mutable std::mutex mutex; // to protect everything below
+    std::string baseUrl;
+    std::map<std::string, Resource> resources;
+    std::map<std::string, Failure> failures;
+    std::set<std::string> tusEndpoints;
+    std::vector<Upload> tusUploads;
+    std::vector<Request> requests;
+    std::vector<StreamSocket> sockets; // closed when the server goes away
+    bool keepBodies{ true };
+    bool stopped{ false };
+
+    std::atomic<uint64_t> bytesSent{ 0 };
+    std::atomic<uint64_t> bytesReceived{ 0 };
+};
+
+// What has been read from a connection but not parsed yet
+struct LoopbackHttpServer::Connection
+{
+    explicit Connection(StreamSocket const& socket)
+        : input{ socket.InputStream() },
+          output{ socket.OutputStream() }
+    {
+    }
+
+    IAsyncOperation<bool> ReadMoreAsync()
+    {
+        buffer.Length(0);
+        auto read{ co_await input.ReadAsync(buffer, buffer.Capacity(), InputStreamOptions::Partial) };
+        if (read.Length() == 0)
+        {
+            co_return false;
+        }
+        pending.append(reinterpret_cast<char const*>(read.data()), read.Length());
+        co_return true;
+    }
+
+    IAsyncAction WriteAsync(std::string_view data)
+    {
+        Buffer out{ static_cast<uint32_t>(data.size()) };
+        std::memcpy(out.data(), data.data(), data.size());
+        out.Length(static_cast<uint32_t>(data.size()));
+        co_await output.WriteAsync(out);
+    }
+
+    IInputStream input;
+    IOutputStream output;
+    Buffer buffer{ 64 * 1024 };
+    std::string pending;
+};
+
+static std::string lower(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+static std::string trim(std::string_view value)
+{
+    auto first{ value.find_first_not_of(" \t") };
+    if (first == std::string_view::npos)
+    {
+        return {};
+    }
+    return std::string{ value.substr(first, value.find_last_not_of(" \t") - first + 1) };
+}
+
+static std::string header(LoopbackHttpServer::Request const& request, std::string const& name)
+{
+    auto it{ request.headers.find(name) };
+    return it == request.headers.end() ? std::string{} : it->second;
+}
+
+static bool parse_head(std::string_view head, LoopbackHttpServer::Request& request)
+{
+    auto lineEnd{ head.find("\r\n") };
+    auto requestLine{ head.substr(0, lineEnd) };
+    auto firstSpace{ requestLine.find(' ') };
+    auto secondSpace{ requestLine.find(' ', firstSpace + 1) };
+    if (firstSpace == std::string_view::npos || secondSpace == std::string_view::npos)
+    {
+        return false;
+    }
+    request.method = std::string{ requestLine.substr(0, firstSpace) };
+    request.target = std::string{ requestLine.substr(firstSpace + 1, secondSpace - firstSpace - 1) };
+
+    while (lineEnd != std::string_view::npos)
+    {
+        auto start{ lineEnd + 2 };
+        lineEnd = head.find("\r\n", start);
+        auto line{ head.substr(start, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - start) };
+        auto colon{ line.find(':') };
+        if (colon != std::string_view::npos)
+        {
+            request.headers[lower(std::string{ line.substr(0, colon) })] = trim(line.substr(colon + 1));
+        }
+    }
+    return true;
+}
+
+static char const* reason(int status)
+{
+    switch (status)
+    {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 204: return "No Content";
+    case 206: return "Partial Content";
+    case 304: return "Not Modified";
+    case 404: return "Not Found";
+    case 408: return "Request Timeout";
+    case 409: return "Conflict";
+    case 416: return "Range Not Satisfiable";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    default: return "Status";
+    }
+}
+
+static std::string status_line(int status)
+{
+    return "HTTP/1.1 " + std::to_string(status) + " " + reason(status) + "\r\n";
+}
+
+LoopbackHttpServer::LoopbackHttpServer()
+    : m_state{ std::make_shared<State>() }
+{
+    m_listener.Control().NoDelay(true);
+    m_listener.ConnectionReceived([state = m_state](StreamSocketListener const&, StreamSocketListenerConnectionReceivedEventArgs const& args)
+        {
+            ServeAsync(state, args.Socket());
+        });
+    m_listener.BindEndpointAsync(HostName{ L"127.0.0.1" }, L"").get();
+    m_state->baseUrl = "http://127.0.0.1:" + winrt::to_string(m_listener.Information().LocalPort());
+}
+
+LoopbackHttpServer::~LoopbackHttpServer() noexcept
+{
+    m_listener.Close();
+
+    std::vector<StreamSocket> sockets;
+    {
+        std::scoped_lock lock{ m_state->mutex };
+        m_state->stopped = true;
+        sockets.swap(m_state->sockets);
+    }
+    for (auto const& socket : sockets)
+    {
+        socket.Close();
+    }
+}
+
+std::string LoopbackHttpServer::Url(std::string_view path) const
+{
+    std::scoped_lock lock{ m_state->mutex };
+    return m_state->baseUrl + std::string{ path };
+}
+
+void LoopbackHttpServer::Serve(std::string path, Resource resource)
+{
+    std::scoped_lock lock{ m_state->mutex };
+    m_state->resources[std::move(path)] = std::move(resource);
+}
+
+void LoopbackHttpServer::Fail(std::string path, int status, uint32_t times, uint32_t retryAfterSeconds)
+{
+    std::scoped_lock lock{ m_state->mutex };
+    m_state->failures[std::move(path)] = { status, times, retryAfterSeconds };
+}
+
+void LoopbackHttpServer::EnableTus(std::string path)
+{
+    std::scoped_lock lock{ m_state->mutex };
+    m_state->tusEndpoints.insert(std::move(path));
+}
+
+std::string LoopbackHttpServer::TusUpload(size_t index) const
+{
+    std::scoped_lock lock{ m_state->mutex };
+    return index < m_state->tusUploads.size() ? m_state->tusUploads[index].data : std::string{};
+}
+
+void LoopbackHttpServer::KeepBodies(bool keep) noexcept
+{
+    std::scoped_lock lock{ m_state->mutex };
+    m_state->keepBodies = keep;
+}
+
+std::vector<LoopbackHttpServer::Request> LoopbackHttpServer::Requests() const
+{
+    std::scoped_lock lock{ m_state->mutex };
+    return m_state->requests;
+}
+
+uint64_t LoopbackHttpServer::BodyBytesSent() const noexcept
+{
+    return m_state->bytesSent;
+}
+
+uint64_t LoopbackHttpServer::BodyBytesReceived() const noexcept
+{
+    return m_state->bytesReceived;
+}
+
+std::string LoopbackHttpServer::Pattern(uint64_t offset, size_t length)
+{
+    std::string data(length, '\0');
+    for (size_t i = 0; i < length; ++i)
+    {
+        auto position{ offset + i };
+        data[i] = static_cast<char>((position ^ (position >> 8) ^ (position >> 16)) & 0xff);
+    }
+    return data;
+}
+
+fire_and_forget LoopbackHttpServer::ServeAsync(std::shared_ptr<State> state, StreamSocket socket)
+{
+    {
+        std::scoped_lock lock{ state->mutex };
+        if (state->stopped)
+        {
+            socket.Close();
+            co_return;
+        }
+        state->sockets.push_back(socket);
+    }
+
+    try
+    {
+        Connection connection{ socket };
+        for (;;)
+        {
+            //Head
+            size_t headEnd;
+            while ((headEnd = connection.pending.find("\r\n\r\n")) == std::string::npos)
+            {
+                if (!co_await connection.ReadMoreAsync())
+                {
+                    co_return;
+                }
+            }
+
+            Request request;
+            if (!parse_head(std::string_view{ connection.pending }.substr(0, headEnd), request))
+            {
+                break;
+            }
+            connection.pending.erase(0, headEnd + 4);
+
+            if (lower(header(request, "expect")) == "100-continue")
+            {
+                co_await connection.WriteAsync("HTTP/1.1 100 Continue\r\n\r\n");
+            }
+
+            //Body: Content-Length or chunked
+            bool keepBody{ request.method == "PATCH" };
+            {
+                std::scoped_lock lock{ state->mutex };
+                keepBody |= state->keepBodies;
+            }
+            auto consume = [&](size_t size)
+            {
+                request.bodySize += size;
+                state->bytesReceived += size;
+                if (keepBody)
+                {
+                    request.body.append(connection.pending, 0, size);
+                }
+                connection.pending.erase(0, size);
+            };
+
+            if (auto contentLength{ header(request, "content-length") }; !contentLength.empty())
+            {
+                uint64_t remaining{ std::stoull(contentLength) };
+                while (remaining > 0)
+                {
+                    if (connection.pending.empty() && !co_await connection.ReadMoreAsync())
+                    {
+                        co_return;
+                    }
+                    auto size{ static_cast<size_t>(std::min<uint64_t>(remaining, connection.pending.size())) };
+                    consume(size);
+                    remaining -= size;
+                }
+            }
+            else if (lower(header(request, "transfer-encoding")).find("chunked") != std::string::npos)
+            {
+                for (;;)
+                {
+                    size_t lineEnd;
+                    while ((lineEnd = connection.pending.find("\r\n")) == std::string::npos)
+                    {
+                        if (!co_await connection.ReadMoreAsync())
+                        {
+                            co_return;
+                        }
+                    }
+                    uint64_t chunkSize{ std::stoull(connection.pending.substr(0, lineEnd), nullptr, 16) };
+                    connection.pending.erase(0, lineEnd + 2);
+
+                    if (chunkSize == 0)
+                    {
+                        // Trailers, up to an empty line
+                        for (;;)
+                        {
+                            while ((lineEnd = connection.pending.find("\r\n")) == std::string::npos)
+                            {
+                                if (!co_await connection.ReadMoreAsync())
+                                {
+                                    co_return;
+                                }
+                            }
+                            connection.pending.erase(0, lineEnd + 2);
+                            if (lineEnd == 0)
+                            {
+                                break;
+                            }
+                        }
+                        break;
+                    }
+
+                    while (chunkSize > 0)
+                    {
+                        if (connection.pending.empty() && !co_await connection.ReadMoreAsync())
+                        {
+                            co_return;
+                        }
+                        auto size{ static_cast<size_t>(std::min<uint64_t>(chunkSize, connection.pending.size())) };
+                        consume(size);
+                        chunkSize -= size;
+                    }
+                    while (connection.pending.size() < 2)
+                    {
+                        if (!co_await connection.ReadMoreAsync())
+                        {
+                            co_return;
+                        }
+                    }
+                    connection.pending.erase(0, 2);
+                }
+            }
+
+            {
+                std::scoped_lock lock{ state->mutex };
+                state->requests.push_back(request);
+            }
+
+            bool keepAlive{ co_await RespondAsync(state, connection, request) };
+            if (!keepAlive || lower(header(request, "connection")) == "close")
+            {
+                break;
+            }
+        }
+    }
+    catch (hresult_error const&)
+    {
+        // The client went away
+    }
+    socket.Close();
+}
+
+IAsyncOperation<bool> LoopbackHttpServer::RespondAsync(std::shared_ptr<State> state, Connection& connection, Request const& request)
+{
+    auto path{ request.target.substr(0, request.target.find('?')) };
+
+    //Injected failures
+    std::optional<State::Failure> failure;
+    std::optional<Resource> resource;
+    bool drop{ false };
+    {
+        std::scoped_lock lock{ state->mutex };
+        if (auto it{ state->failures.find(path) }; it != state->failures.end() && it->second.remaining > 0)
+        {
+            --it->second.remaining;
+            failure = it->second;
+        }
+        else if (auto found{ state->resources.find(path) }; found != state->resources.end() && (request.method == "GET" || request.method == "HEAD"))
+        {
+            resource = found->second;
+            if (found->second.disconnectAfter > 0 && found->second.disconnects > 0)
+            {
+                --found->second.disconnects;
+                drop = true;
+            }
+        }
+    }
+
+    if (failure)
+    {
+        std::string response{ status_line(failure->status) };
+        if (failure->retryAfterSeconds > 0)
+        {
+            response += "Retry-After: " + std::to_string(failure->retryAfterSeconds) + "\r\n";
+        }
+        response += "Content-Length: 0\r\n\r\n";
+        co_await connection.WriteAsync(response);
+        co_return true;
+    }
+
+    //tus: creation, offset queries and PATCHes
+    if (!resource)
+    {
+        std::string response;
+        {
+            std::scoped_lock lock{ state->mutex };
+            for (auto const& endpoint : state->tusEndpoints)
+            {
+                if (path == endpoint && request.method == "POST")
+                {
+                    state->tusUploads.push_back({ std::stoull("0" + header(request, "upload-length")), {} });
+                    response = status_line(201) + "Tus-Resumable: 1.0.0\r\nLocation: " + state->baseUrl + endpoint + "/" +
+                        std::to_string(state->tusUploads.size() - 1) + "\r\nContent-Length: 0\r\n\r\n";
+                }
+                else if (path.rfind(endpoint + "/", 0) == 0)
+                {
+                    auto index{ static_cast<size_t>(std::stoull("0" + path.substr(endpoint.size() + 1))) };
+                    if (index >= state->tusUploads.size())
+                    {
+                        response = status_line(404) + "Content-Length: 0\r\n\r\n";
+                    }
+                    else if (request.method == "HEAD")
+                    {
+                        auto const& upload{ state->tusUploads[index] };
+                        response = status_line(200) + "Tus-Resumable: 1.0.0\r\nCache-Control: no-store\r\nUpload-Offset: " +
+                            std::to_string(upload.data.size()) + "\r\nUpload-Length: " + std::to_string(upload.length) + "\r\nContent-Length: 0\r\n\r\n";
+                    }
+                    else if (request.method == "PATCH")
+                    {
+                        auto& upload{ state->tusUploads[index] };
+                        if (std::stoull("0" + header(request, "upload-offset")) != upload.data.size())
+                        {
+                            response = status_line(409) + "Content-Length: 0\r\n\r\n";
+                        }
+                        else
+                        {
+                            upload.data += request.body;
+                            response = status_line(204) + "Tus-Resumable: 1.0.0\r\nUpload-Offset: " + std::to_string(upload.data.size()) + "\r\n\r\n";
+                        }
+                    }
+                }
+            }
+        }
+
+        if (response.empty())
+        {
+            response = request.method == "GET" || request.method == "HEAD" ?
+                status_line(404) + "Content-Length: 0\r\n\r\n" :
+                status_line(200) + "Content-Type: text/plain\r\nContent-Length: 2\r\n\r\nok";
+        }
+        co_await connection.WriteAsync(response);
+        co_return true;
+    }
+
+    //Resources: conditional and range requests
+    if (resource->responseDelayMilliseconds > 0)
+    {
+        co_await winrt::resume_after(std::chrono::milliseconds{ resource->responseDelayMilliseconds });
+    }
+    uint64_t size{ resource->body.empty() ? resource->size : resource->body.size() };
+    auto ifNoneMatch{ header(request, "if-none-match") };
+    auto ifModifiedSince{ header(request, "if-modified-since") };
+    if ((!resource->etag.empty() && ifNoneMatch == resource->etag) ||
+        (!resource->lastModified.empty() && ifNoneMatch.empty() && ifModifiedSince == resource->lastModified))
+    {
+        co_await connection.WriteAsync(status_line(304) +
+            (resource->etag.empty() ? "" : "ETag: " + resource->etag + "\r\n") +
+            (resource->lastModified.empty() ? "" : "Last-Modified: " + resource->lastModified + "\r\n") + "\r\n");
+        co_return true;
+    }
+
+    uint64_t first{ 0 };
+    uint64_t count{ size };
+    bool partial{ false };
+    auto range{ header(request, "range") };
+    auto ifRange{ header(request, "if-range") };
+    if (resource->ranges && range.rfind("bytes=", 0) == 0 &&
+        (ifRange.empty() || ifRange == resource->etag || ifRange == resource->lastModified))
+    {
+        auto dash{ range.find('-') };
+        first = std::stoull("0" + range.substr(6, dash - 6));
+        if (first >= size)
+        {
+            co_await connection.WriteAsync(status_line(416) + "Content-Range: bytes */" + std::to_string(size) + "\r\nContent-Length: 0\r\n\r\n");
+            co_return true;
+        }
+        auto lastText{ range.substr(dash + 1) };
+        uint64_t last{ lastText.empty() ? size - 1 : std::min<uint64_t>(std::stoull(lastText), size - 1) };
+        count = last - first + 1;
+        partial = true;
+    }
+
+    std::string head{ status_line(partial ? 206 : 200) };
+    head += "Content-Type: " + resource->contentType + "\r\n";
+    if (!resource->etag.empty())
+    {
+        head += "ETag: " + resource->etag + "\r\n";
+    }
+    if (!resource->lastModified.empty())
+    {
+        head += "Last-Modified: " + resource->lastModified + "\r\n";
+    }
+    if (resource->ranges)
+    {
+        head += "Accept-Ranges: bytes\r\n";
+    }
+    if (!resource->contentEncoding.empty())
+    {
+        head += "Content-Encoding: " + resource->contentEncoding + "\r\n";
+    }
+    if (partial)
+    {
+        head += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(first + count - 1) + "/" + std::to_string(size) + "\r\n";
+    }
+    head += resource->chunked ? "Transfer-Encoding: chunked\r\n\r\n" : "Content-Length: " + std::to_string(count) + "\r\n\r\n";
+    co_await connection.WriteAsync(head);
+    if (request.method == "HEAD")
+    {
+        co_return true;
+    }
+
+    //Body, paced and cut short as configured
+    uint64_t limit{ drop ? std::min(count, resource->disconnectAfter) : count };
+    size_t slice{ 64 * 1024 };
+    if (resource->bytesPerSecond > 0)
+    {
+        slice = static_cast<size_t>(std::clamp<uint64_t>(resource->bytesPerSecond / 20, 1024, slice));
+    }
+    for (uint64_t sent = 0; sent < limit;)
+    {
+        auto length{ static_cast<size_t>(std::min<uint64_t>(slice, limit - sent)) };
+        auto data{ resource->body.empty() ? Pattern(first + sent, length) : resource->body.substr(static_cast<size_t>(first + sent), length) };
+        if (resource->chunked)
+        {
+            char chunkHead[20];
+            snprintf(chunkHead, sizeof(chunkHead), "%zx\r\n", length);
+            data = chunkHead + data + "\r\n";
+        }
+        co_await connection.WriteAsync(data);
+        sent += length;
+        state->bytesSent += length;
+
+        if (resource->bytesPerSecond > 0)
+        {
+            co_await winrt::resume_after(std::chrono::milliseconds{ length * 1000 / resource->bytesPerSecond });
+        }
+    }
+
+    if (drop)
+    {
+        if (resource->stallMilliseconds > 0)
+        {
+            co_await winrt::resume_after(std::chrono::milliseconds{ resource->stallMilliseconds });
+        }
+        co_return false;
+    }
+    if (resource->chunked)
+    {
+        co_await connection.WriteAsync("0\r\n\r\n");
+    }
+    co_return true;
+}
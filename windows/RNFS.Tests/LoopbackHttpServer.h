@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <winrt/Windows.Networking.Sockets.h>
+
+//
+// A small HTTP/1.1 server on 127.0.0.1 for exercising the transfer code against
+// the server behaviour that is hard to get from a real one on demand: range
+// requests, chunked bodies, slow links, dropped connections, 304s, error
+// statuses with Retry-After, and the tus upload protocol. It runs in-process on
+// the thread pool and listens on an ephemeral port, so every test can have its
+// own. Requests to paths without a resource are answered with 200 "ok", which
+// is what uploads need.
+//
+struct LoopbackHttpServer final
+{
+    struct Resource
+    {
+        std::string body;               // when empty, `size` bytes of Pattern() are served instead
+        uint64_t size{ 0 };
+        std::string contentType{ "application/octet-stream" };
+        std::string contentEncoding;    // sent as Content-Encoding; the body must already be encoded
+        std::string etag;               // enables If-None-Match and If-Range
+        std::string lastModified;
+        bool ranges{ true };            // honour Range requests
+        bool chunked{ false };          // Transfer-Encoding: chunked instead of Content-Length
+        uint64_t bytesPerSecond{ 0 };   // 0 sends as fast as the connection drains
+        uint64_t disconnectAfter{ 0 };  // drop the connection after this many body bytes...
+        uint32_t disconnects{ 0 };      // ...for this many responses
+        uint32_t stallMilliseconds{ 0 }; // go silent this long before dropping, as a stalled server does
+        uint32_t responseDelayMilliseconds{ 0 }; // take this long before answering, as a busy server does
+    };
+
+    struct Request
+    {
+        std::string method;
+        std::string target;
+        std::map<std::string, std::string> headers; // names in lower case
+        std::string body;                           // de-chunked; empty unless bodies are kept
+        uint64_t bodySize{ 0 };
+    };
+
+    LoopbackHttpServer();
+    ~LoopbackHttpServer() noexcept;
+
+    LoopbackHttpServer(LoopbackHttpServer const&) = delete;
+    LoopbackHttpServer& operator=(LoopbackHttpServer const&) = delete;
+
+    // "http://127.0.0.1:<port>" + path
+    std::string Url(std::string_view path) const;
+
+    void Serve(std::string path, Resource resource);
+
+    // Answers the next `times` requests for `path` with `status` and an empty body
+    void Fail(std::string path, int status, uint32_t times, uint32_t retryAfterSeconds = 0);
+
+    // Makes `path` a tus 1.0.0 creation endpoint; uploads live at path + "/<index>"
+    void EnableTus(std::string path);
+    std::string TusUpload(size_t index) const;
+
+    // Large upload benchmarks turn this off so request bodies are only counted
+    void KeepBodies(bool keep) noexcept;
+
+    std::vector<Request> Requests() const;
+    uint64_t BodyBytesSent() const noexcept;
+    uint64_t BodyBytesReceived() const noexcept;
+
+    // The deterministic content served for resources without a body
+    static std::string Pattern(uint64_t offset, size_t length);
+
+private:
+    struct State;
+    struct Connection;
+
+    static winrt::fire_and_forget ServeAsync(std::shared_ptr<State> state, winrt::Windows::Networking::Sockets::StreamSocket socket);
+    static winrt::Windows::Foundation::IAsyncOperation<bool> RespondAsync(std::shared_ptr<State> state, Connection& connection, Request const& request);
+
+    std::shared_ptr<State> m_state;
+    winrt::Windows::Networking::Sockets::StreamSocketListener m_listener;
+};
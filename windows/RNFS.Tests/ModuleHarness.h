@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include "ReactModuleBuilderMock.h"
+#include "future/futureWait.h"
+#include "RNFSManager.h"
+
+//
+// One RNFSManager hosted on the module builder mock, the way the module tests
+// and RNFS.Bench call it. Call runs a method that takes a promise and waits for
+// it to settle; Start returns as soon as the method was dispatched, for tests
+// that act on a call while it runs. The events the module emits are counted;
+// they may arrive on any thread.
+//
+struct ModuleHarness final
+{
+    struct Outcome
+    {
+        bool resolved{ false };
+        React::JSValue value; // what the promise was resolved or rejected with
+
+        explicit operator bool() const noexcept
+        {
+            return resolved;
+        }
+    };
+
+    // A call whose promise may not have settled yet
+    struct Pending
+    {
+        Mso::Future<bool> future;
+        std::shared_ptr<Outcome> outcome;
+
+        Outcome Wait()
+        {
+            Mso::FutureWait(future);
+            return std::move(*outcome);
+        }
+    };
+
+    ModuleHarness()
+    {
+        m_moduleBuilder = winrt::make<React::ReactModuleBuilderImpl>(m_builderMock);
+        auto provider = React::MakeModuleProvider<RNFSManager>();
+        m_moduleObject = m_builderMock.CreateModule(provider, m_moduleBuilder);
+        m_builderMock.ExpectFunction(L"RCTDeviceEventEmitter", L"emit",
+            [events = m_events](React::JSValueArray const&) noexcept { ++*events; });
+    }
+
+    ModuleHarness(ModuleHarness const&) = delete;
+    ModuleHarness& operator=(ModuleHarness const&) = delete;
+
+    template <typename... TArgs>
+    Pending Start(std::wstring const& method, TArgs&&... args)
+    {
+        auto outcome{ std::make_shared<Outcome>() };
+        auto future{ m_builderMock.Call2(
+            method,
+            std::function<void(React::JSValue const&)>(
+                [outcome](React::JSValue const& result) noexcept { *outcome = { true, result.Copy() }; }),
+            std::function<void(React::JSValue const&)>(
+                [outcome](React::JSValue const& error) noexcept { *outcome = { false, error.Copy() }; }),
+            std::forward<TArgs>(args)...) };
+        return { std::move(future), std::move(outcome) };
+    }
+
+    template <typename... TArgs>
+    Outcome Call(std::wstring const& method, TArgs&&... args)
+    {
+        return Start(method, std::forward<TArgs>(args)...).Wait();
+    }
+
+    // Calls a method without a promise, such as cancelJob
+    template <typename... TArgs>
+    void Call0(std::wstring const& method, TArgs&&... args)
+    {
+        m_builderMock.Call0(method, std::forward<TArgs>(args)...);
+    }
+
+    uint64_t Events() const noexcept
+    {
+        return *m_events;
+    }
+
+private:
+    React::ReactModuleBuilderMock m_builderMock{};
+    React::IReactModuleBuilder m_moduleBuilder;
+    winrt::Windows::Foundation::IInspectable m_moduleObject{ nullptr };
+    std::shared_ptr<std::atomic<uint64_t>> m_events{ std::make_shared<std::atomic<uint64_t>>(0) };
+};
@@ -0,0 +1,112 @@
+#include "pch.h"
+
+#include <thread>
+#include <vector>
+#include "OperationStats.h"
+
+namespace ReactNativeTests {
+
+    using Operation = OperationStats::Operation;
+
+    TEST_CLASS(OperationStatsTest) {
+        TEST_METHOD(TestScope_countsCallAndLatency) {
+            OperationStats stats;
+            {
+                OperationScope scope{ stats, Operation::ReadFile };
+                TestCheck(stats.Snapshot(Operation::ReadFile).inFlight == 1);
+            }
+
+            auto counters{ stats.Snapshot(Operation::ReadFile) };
+            TestCheck(counters.calls == 1);
+            TestCheck(counters.inFlight == 0);
+            TestCheck(stats.Snapshot(Operation::WriteFile).calls == 0);
+        }
+
+        TEST_METHOD(TestEnd_log2Buckets) {
+            OperationStats stats;
+            stats.Begin(Operation::Hash);
+            stats.End(Operation::Hash, std::chrono::microseconds{ 0 });
+            stats.Begin(Operation::Hash);
+            stats.End(Operation::Hash, std::chrono::microseconds{ 1 });
+            stats.Begin(Operation::Hash);
+            stats.End(Operation::Hash, std::chrono::microseconds{ 1000 });
+
+            auto counters{ stats.Snapshot(Operation::Hash) };
+            TestCheck(counters.latency[0] == 1); // under 1us
+            TestCheck(counters.latency[1] == 1); // [1us, 2us)
+            TestCheck(counters.latency[10] == 1); // [512us, 1024us)
+            TestCheck(counters.totalMicroseconds == 1001);
+        }
+
+        TEST_METHOD(TestPercentile_upperBucketBound) {
+            OperationStats stats;
+            for (int i = 0; i < 99; ++i)
+            {
+                stats.Begin(Operation::Stat);
+                stats.End(Operation::Stat, std::chrono::microseconds{ 100 });
+            }
+            stats.Begin(Operation::Stat);
+            stats.End(Operation::Stat, std::chrono::milliseconds{ 50 });
+
+            auto counters{ stats.Snapshot(Operation::Stat) };
+            TestCheck(counters.Percentile(0.5) == 128);
+            TestCheck(counters.Percentile(0.99) == 128);
+            TestCheck(counters.Percentile(1.0) == 65536);
+            TestCheck(OperationStats::Counters{}.Percentile(0.5) == 0);
+        }
+
+        TEST_METHOD(TestFail_errorCodes) {
+            OperationStats stats;
+            stats.Fail(Operation::ReadFile, "ENOENT");
+            stats.Fail(Operation::ReadFile, "ENOENT");
+            stats.Fail(Operation::ReadFile, "ESOMETHING");
+
+            auto counters{ stats.Snapshot(Operation::ReadFile) };
+            TestCheck(counters.errors == 3);
+            TestCheck(counters.errorCodes[0] == 2); // ENOENT
+            TestCheck(counters.errorCodes[OperationStats::ErrorCodes.size() - 1] == 1); // Error
+        }
+
+        TEST_METHOD(TestReset_keepsInFlight) {
+            OperationStats stats;
+            stats.AddBytes(Operation::DownloadFile, 100, 50);
+            stats.Fail(Operation::DownloadFile, "ETIMEDOUT");
+            OperationScope running{ stats, Operation::DownloadFile };
+            auto before{ stats.Since() };
+
+            stats.Reset();
+            auto counters{ stats.Snapshot(Operation::DownloadFile) };
+            TestCheck(counters.bytesIn == 0);
+            TestCheck(counters.bytesOut == 0);
+            TestCheck(counters.errors == 0);
+            TestCheck(counters.inFlight == 1);
+            TestCheck(stats.Since() >= before);
+        }
+
+        TEST_METHOD(TestRecord_manyThreads) {
+            OperationStats stats;
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 32; ++t)
+            {
+                threads.emplace_back([&stats]
+                    {
+                        for (int i = 0; i < 1000; ++i)
+                        {
+                            OperationScope scope{ stats, Operation::Exists };
+                            stats.AddBytes(Operation::Exists, 1, 2);
+                        }
+                    });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+
+            auto counters{ stats.Snapshot(Operation::Exists) };
+            TestCheck(counters.calls == 32000);
+            TestCheck(counters.inFlight == 0);
+            TestCheck(counters.bytesIn == 32000);
+            TestCheck(counters.bytesOut == 64000);
+        }
+    };
+}
@@ -197,7 +197,7 @@ namespace ReactNativeTests {
                 ); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to read file."); }),
-                testLocation + "toRead.txt"));
+                testLocation + "toRead.txt", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
 
@@ -208,7 +208,7 @@ namespace ReactNativeTests {
                 ); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to read file."); }),
-                testLocation + "toRead"));
+                testLocation + "toRead", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
 
@@ -219,7 +219,7 @@ namespace ReactNativeTests {
                 std::function<void(std::string)>([](std::string value) noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(true); }),
-                testLocation + "Hello"));
+                testLocation + "Hello", React::JSValueObject{}));
             TestCheck(m_builderMock.IsRejectCallbackCalled());
         }
 
@@ -255,7 +255,7 @@ namespace ReactNativeTests {
                 std::function<void(React::JSValueObject&)>([](React::JSValueObject&) noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to read directory."); }),
-                testLocation + "wait"));
+                testLocation + "wait", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
 
@@ -265,7 +265,7 @@ namespace ReactNativeTests {
                 std::function<void(React::JSValueObject&)>([](React::JSValueObject&) noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to read directory."); }),
-                testLocation + "Hello"));
+                testLocation + "Hello", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
 
@@ -275,7 +275,7 @@ namespace ReactNativeTests {
                 std::function<void(React::JSValueObject&)>([](React::JSValueObject&) noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(true); }),
-                testLocation + "Hello/World/Toast/Bro"));
+                testLocation + "Hello/World/Toast/Bro", React::JSValueObject{}));
             TestCheck(m_builderMock.IsRejectCallbackCalled());
         }
 
@@ -501,7 +501,7 @@ namespace ReactNativeTests {
                 std::function<void(std::string)>([](std::string value) noexcept { TestCheck(value == "0e988e0e8dec56e3bb331e110109cc24"); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to get checksum from file."); }),
-                testLocation + "toHash.txt", "md5"));
+                testLocation + "toHash.txt", "md5", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
@@ -512,7 +512,7 @@ namespace ReactNativeTests {
                 std::function<void(std::string)>([](std::string value) noexcept { TestCheck(value == "cb6e9c8e23671c8406179b9e50e8d55d79bb6d1c"); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to get checksum from file."); }),
-                testLocation + "toHash.txt", "sha1"));
+                testLocation + "toHash.txt", "sha1", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
 
@@ -522,7 +522,7 @@ namespace ReactNativeTests {
                 std::function<void(std::string)>([](std::string value) noexcept { TestCheck(value == "ba0ed317bfab6eb1f3b59b9ea26efeb5a2afd565f7632fb6ec3fafcd3ee05336"); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to get checksum from file."); }),
-                testLocation + "toHash.txt", "sha256"));
+                testLocation + "toHash.txt", "sha256", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
 
@@ -532,7 +532,7 @@ namespace ReactNativeTests {
                 std::function<void(std::string)>([](std::string value) noexcept { TestCheck(value == "ca729e5416a95d4acaf31d398824e782d085283a1fd776a188bb6340904f2205cf5c1e6849e7acfbb7271b2e8135d96f"); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to get checksum from file."); }),
-                testLocation + "toHash.txt", "sha384"));
+                testLocation + "toHash.txt", "sha384", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
 
@@ -542,7 +542,7 @@ namespace ReactNativeTests {
                 std::function<void(std::string)>([](std::string value) noexcept { TestCheck(value == "0bd4e1ac2101124ca5efa102c2be200a2573f627c5bc926d0105c0a98fb24064ebed206b47deca5c4d0005c8796fbdc5e256f5f75f603fedc5bf5d4e3d40e79f"); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to get checksum from file."); }),
-                testLocation + "toHash.txt", "sha512"));
+                testLocation + "toHash.txt", "sha512", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
 
@@ -552,7 +552,7 @@ namespace ReactNativeTests {
                 std::function<void(std::string)>([](std::string value) noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(true); }),
-                testLocation + "toHash.txt", "sha224"));
+                testLocation + "toHash.txt", "sha224", React::JSValueObject{}));
             TestCheck(m_builderMock.IsRejectCallbackCalled());
         }
 
@@ -562,7 +562,7 @@ namespace ReactNativeTests {
                 std::function<void(std::string)>([](std::string value) noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(true); }),
-                testLocation + "toHash.txt", "squirrels"));
+                testLocation + "toHash.txt", "squirrels", React::JSValueObject{}));
             TestCheck(m_builderMock.IsRejectCallbackCalled());
         }
 
@@ -572,7 +572,7 @@ namespace ReactNativeTests {
                 std::function<void(std::string)>([](std::string value) noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(true); }),
-                testLocation, "sha256"));
+                testLocation, "sha256", React::JSValueObject{}));
             TestCheck(m_builderMock.IsRejectCallbackCalled());
         }
 
@@ -585,7 +585,7 @@ namespace ReactNativeTests {
                 std::function<void()>([]() noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to unlink."); }),
-                testLocation + "Hello"));
+                testLocation + "Hello", React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
 
@@ -595,7 +595,7 @@ namespace ReactNativeTests {
                 std::function<void()>([]() noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(true); }),
-                testLocation + "Helloasdfasdfasdf"));
+                testLocation + "Helloasdfasdfasdf", React::JSValueObject{}));
             TestCheck(m_builderMock.IsRejectCallbackCalled());
         }
 
@@ -605,7 +605,7 @@ namespace ReactNativeTests {
                 std::function<void()>([]() noexcept { TestCheck(true); }),
                 std::function<void(React::JSValue const&)>(
                     [](React::JSValue const& error) noexcept { TestCheck(error["message"] == "Failed to unlink."); }),
-                testLocation));
+                testLocation, React::JSValueObject{}));
             TestCheck(m_builderMock.IsResolveCallbackCalled());
         }
     };
@@ -0,0 +1,102 @@
+#include "pch.h"
+
+#include <filesystem>
+#include <fstream>
+#include "ModuleHarness.h"
+
+namespace ReactNativeTests {
+
+    // readDir with columnar results or chosen fields, and statBatch
+    TEST_CLASS(ReadDirColumnsTest) {
+        ModuleHarness m_harness;
+        std::filesystem::path m_folder{ std::filesystem::temp_directory_path() / L"rnfs-columns-test" };
+
+        ReadDirColumnsTest() {
+            std::error_code ignored;
+            std::filesystem::remove_all(m_folder, ignored);
+            std::filesystem::create_directories(m_folder / L"child");
+            std::ofstream{ m_folder / L"a.txt" } << "hello";
+            std::ofstream{ m_folder / L"b.txt" } << "hello world";
+        }
+
+        std::string Path(std::filesystem::path const& path) const {
+            return winrt::to_string(path.wstring());
+        }
+
+        TEST_METHOD(TestReadDir_columnsMatchRows) {
+            auto rows{ m_harness.Call(L"readDir", Path(m_folder), React::JSValueObject{}) };
+            auto columns{ m_harness.Call(L"readDir", Path(m_folder), React::JSValueObject{ { "columnar", true } }) };
+            TestCheck(rows.resolved);
+            TestCheck(columns.resolved);
+
+            auto const& table{ columns.value.AsObject() };
+            TestCheck(table["count"] == 3);
+            TestCheck(table["names"].AsArray().size() == 3);
+            for (auto const& row : rows.value.AsArray())
+            {
+                size_t i{ 0 };
+                while (i < 3 && table["names"][i] != row["name"])
+                {
+                    ++i;
+                }
+                TestCheck(i < 3);
+                TestCheck(table["paths"][i] == row["path"]);
+                TestCheck(table["sizes"][i] == row["size"]);
+                TestCheck(table["mtimes"][i] == row["mtime"]);
+                TestCheck(table["types"][i] == row["type"]);
+            }
+        }
+
+        TEST_METHOD(TestReadDir_namesOnly) {
+            auto columns{ m_harness.Call(L"readDir", Path(m_folder),
+                React::JSValueObject{ { "columnar", true }, { "fields", React::JSValueArray{ "name" } } }) };
+            TestCheck(columns.resolved);
+            auto const& table{ columns.value.AsObject() };
+            TestCheck(table.size() == 2);
+            TestCheck(table["names"].AsArray().size() == 3);
+
+            auto rows{ m_harness.Call(L"readDir", Path(m_folder),
+                React::JSValueObject{ { "fields", React::JSValueArray{ "name", "type" } } }) };
+            TestCheck(rows.resolved);
+            TestCheck(rows.value.AsArray().size() == 3);
+            for (auto const& row : rows.value.AsArray())
+            {
+                TestCheck(row.AsObject().size() == 2);
+                TestCheck(row["type"] == (row["name"] == "child" ? 1 : 0));
+            }
+        }
+
+        TEST_METHOD(TestReadDir_invalidField) {
+            auto outcome{ m_harness.Call(L"readDir", Path(m_folder),
+                React::JSValueObject{ { "fields", React::JSValueArray{ "name", "owner" } } }) };
+            TestCheck(!outcome.resolved);
+        }
+
+        TEST_METHOD(TestStatBatch_missingPaths) {
+            React::JSValueArray paths;
+            paths.push_back(Path(m_folder / L"b.txt"));
+            paths.push_back(Path(m_folder / L"missing.txt"));
+            paths.push_back(Path(m_folder / L"missing" / L"deeper.txt"));
+            paths.push_back(Path(m_folder / L"child"));
+            auto outcome{ m_harness.Call(L"statBatch", std::move(paths), React::JSValueObject{}) };
+            TestCheck(outcome.resolved);
+
+            auto const& table{ outcome.value.AsObject() };
+            TestCheck(table["count"] == 4);
+            TestCheck(table["exists"][0] == true);
+            TestCheck(table["exists"][1] == false);
+            TestCheck(table["exists"][2] == false);
+            TestCheck(table["exists"][3] == true);
+            TestCheck(table["sizes"][0] == 11);
+            TestCheck(table["sizes"][1] == 0);
+            TestCheck(table["types"][0] == 0);
+            TestCheck(table["types"][3] == 1);
+
+            auto typesOnly{ m_harness.Call(L"statBatch", React::JSValueArray{ Path(m_folder / L"child") },
+                React::JSValueObject{ { "fields", React::JSValueArray{ "type" } } }) };
+            TestCheck(typesOnly.resolved);
+            TestCheck(typesOnly.value["types"][0] == 1);
+            TestCheck(typesOnly.value.AsObject().count("sizes") == 0);
+        }
+    };
+}
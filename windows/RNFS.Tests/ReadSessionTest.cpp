@@ -0,0 +1,146 @@
+#include "pch.h"
+
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "IoScheduler.h"
+#include "ReadSession.h"
+#include "TestFiles.h"
+
+namespace ReactNativeTests {
+
+    // Waits for the next chunk of the session
+    static ReadSession::Chunk next_chunk(ReadSession& session)
+    {
+        auto chunk{ std::make_shared<std::promise<ReadSession::Chunk>>() };
+        auto future{ chunk->get_future() };
+        session.Next([chunk](ReadSession::Chunk next) { chunk->set_value(std::move(next)); });
+        return future.get();
+    }
+
+    static std::string text_of(ReadSession::Chunk const& chunk)
+    {
+        return { chunk.bytes.begin(), chunk.bytes.end() };
+    }
+
+    template <typename TPredicate>
+    static bool wait_for_reads(TPredicate predicate)
+    {
+        for (int i = 0; i < 5000 && !predicate(); ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+        return predicate();
+    }
+
+    TEST_CLASS(ReadSessionTest) {
+        IoScheduler m_io{ 2 };
+        std::filesystem::path m_folder{ fresh_folder(L"rnfs-read-session-test") };
+        std::filesystem::path m_file{ m_folder / L"session.txt" };
+
+        ReadSessionTest() {
+            std::ofstream{ m_file, std::ios::binary } << "0123456789";
+        }
+
+        TEST_METHOD(TestNext_chunksInOrder) {
+            auto session{ ReadSession::Open(m_file, m_io, 4) };
+            auto first{ next_chunk(*session) };
+            auto second{ next_chunk(*session) };
+            auto last{ next_chunk(*session) };
+            TestCheck(text_of(first) == "0123" && !first.eof);
+            TestCheck(text_of(second) == "4567" && !second.eof);
+            TestCheck(text_of(last) == "89" && last.eof);
+
+            auto past{ next_chunk(*session) };
+            TestCheck(past.bytes.empty() && past.eof && past.error == S_OK);
+            TestCheck(session->BytesRead() == 10);
+        }
+
+        TEST_METHOD(TestNext_emptyFile) {
+            std::ofstream{ m_file };
+            auto session{ ReadSession::Open(m_file, m_io) };
+            auto only{ next_chunk(*session) };
+            TestCheck(only.bytes.empty() && only.eof && only.error == S_OK);
+        }
+
+        TEST_METHOD(TestReadAhead_bounded) {
+            auto session{ ReadSession::Open(m_file, m_io, 1, 3) };
+            TestCheck(wait_for_reads([&] { return session->Buffered() == 3; }));
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+            TestCheck(session->Buffered() == 3);
+            TestCheck(session->BytesRead() == 3);
+
+            // Taking a chunk makes room for one more
+            TestCheck(text_of(next_chunk(*session)) == "0");
+            TestCheck(wait_for_reads([&] { return session->BytesRead() == 4; }));
+            TestCheck(session->Buffered() == 3);
+        }
+
+        TEST_METHOD(TestReadAhead_none) {
+            auto session{ ReadSession::Open(m_file, m_io, 4, 0) };
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
+            TestCheck(session->BytesRead() == 0);
+
+            // Calls made before the reads finish still get the chunks in call order
+            std::vector<std::string> chunks;
+            std::mutex mutex;
+            std::promise<void> done;
+            for (int i = 0; i < 3; ++i)
+            {
+                session->Next([&, i](ReadSession::Chunk chunk)
+                    {
+                        std::lock_guard lock{ mutex };
+                        chunks.push_back(text_of(chunk));
+                        if (i == 2)
+                        {
+                            done.set_value();
+                        }
+                    });
+            }
+            done.get_future().wait();
+            TestCheck((chunks == std::vector<std::string>{ "0123", "4567", "89" }));
+        }
+
+        TEST_METHOD(TestClose_failsLaterCalls) {
+            auto session{ ReadSession::Open(m_file, m_io, 4) };
+            session->Close();
+            auto chunk{ next_chunk(*session) };
+            TestCheck(chunk.error == HRESULT_FROM_WIN32(ERROR_OPERATION_ABORTED));
+            TestCheck(chunk.bytes.empty());
+        }
+
+        TEST_METHOD(TestOpen_missingFile) {
+            bool failed{ false };
+            try
+            {
+                ReadSession::Open(m_folder / L"missing.txt", m_io);
+            }
+            catch (winrt::hresult_error const& ex)
+            {
+                failed = ex.code() == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+            }
+            TestCheck(failed);
+        }
+
+        TEST_METHOD(TestSweep_closesIdleSessions) {
+            ReadSessionTable table;
+            auto sessionId{ table.Add(ReadSession::Open(m_file, m_io, 4), std::chrono::seconds{ 10 }) };
+            auto session{ table.Find(sessionId) };
+            TestCheck(text_of(next_chunk(*session)) == "0123");
+
+            TestCheck(table.Sweep(std::chrono::steady_clock::now()) == 0);
+            TestCheck(table.Sweep(std::chrono::steady_clock::now() + std::chrono::minutes{ 1 }) == 1);
+            TestCheck(table.Find(sessionId) == nullptr);
+            TestCheck(next_chunk(*session).error == HRESULT_FROM_WIN32(ERROR_OPERATION_ABORTED));
+            TestCheck(!table.Remove(sessionId));
+
+            auto counters{ table.Snapshot() };
+            TestCheck(counters.opened == 1);
+            TestCheck(counters.expired == 1);
+        }
+    };
+}
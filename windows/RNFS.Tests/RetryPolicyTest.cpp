@@ -0,0 +1,70 @@
+#include "pch.h"
+
+#include "RetryPolicy.h"
+
+namespace ReactNativeTests {
+
+    using namespace std::chrono_literals;
+
+    TEST_CLASS(RetryPolicyTest) {
+        TEST_METHOD(TestDelay_noRetryByDefault) {
+            RetryPolicy policy;
+            TestCheck(!policy.Delay(1, std::nullopt, 0.5));
+        }
+
+        TEST_METHOD(TestDelay_exponential) {
+            RetryPolicy policy;
+            policy.maxAttempts = 5;
+            policy.initialDelay = 100ms;
+
+            // The upper end of each range doubles; the lower end is half of it
+            TestCheck(policy.Delay(1, std::nullopt, 1.0) == 100ms);
+            TestCheck(policy.Delay(2, std::nullopt, 1.0) == 200ms);
+            TestCheck(policy.Delay(3, std::nullopt, 1.0) == 400ms);
+            TestCheck(policy.Delay(3, std::nullopt, 0.0) == 200ms);
+            TestCheck(!policy.Delay(5, std::nullopt, 1.0));
+        }
+
+        TEST_METHOD(TestDelay_cappedAtMaxDelay) {
+            RetryPolicy policy;
+            policy.maxAttempts = 100;
+            policy.initialDelay = 1000ms;
+            policy.maxDelay = 5000ms;
+            TestCheck(policy.Delay(60, std::nullopt, 1.0) == 5000ms);
+        }
+
+        TEST_METHOD(TestDelay_jitterStaysInRange) {
+            RetryPolicy policy;
+            policy.maxAttempts = 3;
+            policy.initialDelay = 1000ms;
+            for (int i = 0; i < 100; ++i)
+            {
+                auto delay{ policy.Delay(2, std::nullopt) };
+                TestCheck(delay && *delay >= 1000ms && *delay <= 2000ms);
+            }
+        }
+
+        TEST_METHOD(TestDelay_retryAfter) {
+            RetryPolicy policy;
+            policy.maxAttempts = 3;
+            policy.initialDelay = 100ms;
+            policy.maxDelay = 10000ms;
+
+            TestCheck(policy.Delay(1, 3000ms, 0.5) == 3000ms); // longer than the backoff
+            TestCheck(policy.Delay(1, 10ms, 1.0) == 100ms);    // shorter than the backoff
+            TestCheck(!policy.Delay(1, 20000ms, 0.5));         // longer than we are willing to wait
+        }
+
+        TEST_METHOD(TestIsRetryableStatus) {
+            RetryPolicy policy;
+            TestCheck(policy.IsRetryableStatus(503));
+            TestCheck(policy.IsRetryableStatus(429));
+            TestCheck(!policy.IsRetryableStatus(404));
+            TestCheck(!policy.IsRetryableStatus(501));
+
+            policy.retryableStatusCodes = { 404 };
+            TestCheck(policy.IsRetryableStatus(404));
+            TestCheck(!policy.IsRetryableStatus(503));
+        }
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+
+//
+// For the tests of the components that work on files directly: a folder of
+// their own under the temp directory, and the text they write and read back
+// as the bytes the components take.
+//
+namespace ReactNativeTests {
+
+    // Emptied of whatever an earlier run left in it
+    inline std::filesystem::path fresh_folder(std::wstring const& name)
+    {
+        auto folder{ std::filesystem::temp_directory_path() / name };
+        std::error_code ignored;
+        std::filesystem::remove_all(folder, ignored);
+        std::filesystem::create_directories(folder);
+        return folder;
+    }
+
+    inline std::vector<uint8_t> bytes_of(std::string const& text)
+    {
+        return { text.begin(), text.end() };
+    }
+
+    inline std::string contents_of(std::filesystem::path const& path)
+    {
+        std::ifstream stream{ path, std::ios::binary };
+        return { std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{} };
+    }
+}
@@ -0,0 +1,1049 @@
+#include "pch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include "Deflate.h"
+#include "LoopbackHttpServer.h"
+#include "ModuleHarness.h"
+#include "TestHooks.h"
+
+namespace ReactNativeTests {
+
+    // downloadFile and uploadFiles against LoopbackHttpServer. The download cache
+    // and the tus journal are pointed at folders of their own with
+    // configureDownloadCache and configureUploadJournal.
+    TEST_CLASS(TransferTest) {
+        ModuleHarness m_harness;
+        LoopbackHttpServer m_server;
+        std::filesystem::path m_folder{ std::filesystem::temp_directory_path() / L"rnfs-transfer-test" };
+        int32_t m_jobId{ 0 };
+
+        TransferTest() {
+            std::filesystem::create_directories(m_folder);
+        }
+
+        ~TransferTest() {
+            TestHooks::JobProgress = nullptr;
+        }
+
+        std::string FilePath(std::wstring const& name) const {
+            return winrt::to_string((m_folder / name).wstring());
+        }
+
+        static std::string ReadAll(std::string const& path) {
+            std::ifstream stream{ std::filesystem::u8path(path), std::ios::binary };
+            return { std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{} };
+        }
+
+        static void WriteAll(std::string const& path, std::string const& content) {
+            std::ofstream stream{ std::filesystem::u8path(path), std::ios::binary | std::ios::trunc };
+            stream.write(content.data(), content.size());
+        }
+
+        // The temp file a download writes until it is renamed over toFile
+        static std::string PartialPath(std::string const& toFile, int32_t jobId) {
+            return toFile + "." + std::to_string(jobId) + ".download";
+        }
+
+        // Bytes the file system holds for the file, which preallocation may put past its end
+        static uint64_t AllocatedSize(std::string const& path) {
+            winrt::file_handle file{ CreateFileW(std::filesystem::u8path(path).c_str(), FILE_READ_ATTRIBUTES,
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, 0, nullptr) };
+            FILE_STANDARD_INFO info{};
+            winrt::check_bool(GetFileInformationByHandleEx(file.get(), FileStandardInfo, &info, sizeof(info)));
+            return static_cast<uint64_t>(info.AllocationSize.QuadPart);
+        }
+
+        React::JSValueObject DownloadOptions(std::string const& path, std::string const& toFile) {
+            return React::JSValueObject{
+                { "jobId", ++m_jobId },
+                { "fromUrl", m_server.Url(path) },
+                { "toFile", toFile },
+                { "headers", React::JSValueObject{} },
+                { "progressInterval", 0 },
+                { "progressDivider", 0 },
+                { "connectionTimeout", 5000 },
+                { "readTimeout", 15000 },
+            };
+        }
+
+        React::JSValueObject UploadOptions(std::string const& path, std::vector<std::string> const& files) {
+            React::JSValueArray items;
+            for (auto const& file : files)
+            {
+                items.push_back(React::JSValueObject{
+                    { "name", "file" },
+                    { "filename", std::filesystem::u8path(file).filename().u8string() },
+                    { "filepath", file },
+                    { "filetype", "application/octet-stream" },
+                });
+            }
+
+            return React::JSValueObject{
+                { "jobId", ++m_jobId },
+                { "toUrl", m_server.Url(path) },
+                { "files", std::move(items) },
+                { "headers", React::JSValueObject{} },
+                { "fields", React::JSValueObject{} },
+                { "method", "POST" },
+            };
+        }
+
+        React::JSValueObject FetchOptions(std::string const& path, std::string const& encoding) {
+            return React::JSValueObject{
+                { "jobId", ++m_jobId },
+                { "fromUrl", m_server.Url(path) },
+                { "headers", React::JSValueObject{} },
+                { "encoding", encoding },
+                { "connectionTimeout", 5000 },
+                { "readTimeout", 15000 },
+            };
+        }
+
+        // Points the download cache at an empty folder of its own
+        std::filesystem::path ConfigureCache() {
+            auto folder{ m_folder / L"cache" };
+            std::error_code ignored;
+            std::filesystem::remove_all(folder, ignored);
+            TestCheck(m_harness.Call(L"configureDownloadCache", React::JSValueObject{ { "folder", winrt::to_string(folder.wstring()) } }).resolved);
+            return folder;
+        }
+
+        // Points the tus journal at an empty folder of its own
+        std::filesystem::path ConfigureJournal() {
+            auto folder{ m_folder / L"journal" };
+            std::error_code ignored;
+            std::filesystem::remove_all(folder, ignored);
+            TestCheck(m_harness.Call(L"configureUploadJournal", React::JSValueObject{ { "folder", winrt::to_string(folder.wstring()) } }).resolved);
+            return folder;
+        }
+
+        React::JSValueObject ResumableOptions(std::string const& path, std::string const& file, int32_t chunkSize) {
+            auto options{ UploadOptions(path, { file }) };
+            options["resumable"] = true;
+            options["chunkSize"] = chunkSize;
+            return options;
+        }
+
+        React::JSValueObject CachedDownloadOptions(std::string const& path, std::string const& toFile) {
+            auto options{ DownloadOptions(path, toFile) };
+            options["cache"] = true;
+            return options;
+        }
+
+        static React::JSValueObject Retry(int32_t maxAttempts) {
+            return React::JSValueObject{ { "maxAttempts", maxAttempts }, { "initialDelay", 10 }, { "maxDelay", 1000 } };
+        }
+
+        TEST_METHOD(TestDownload_contentLength) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024 * 1024;
+            m_server.Serve("/file", resource);
+
+            auto toFile{ FilePath(L"contentLength.bin") };
+            auto outcome{ m_harness.Call(L"downloadFile", DownloadOptions("/file", toFile)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"].AsInt32() == 200);
+            TestCheck(outcome.value["bytesWritten"].AsInt64() == 1024 * 1024);
+            TestCheck(outcome.value["attempts"].AsInt32() == 1);
+            TestCheck(ReadAll(toFile) == LoopbackHttpServer::Pattern(0, 1024 * 1024));
+            TestCheck(m_harness.Events() >= 1); // DownloadBegin
+        }
+
+        TEST_METHOD(TestDownload_chunked) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 300000;
+            resource.chunked = true;
+            m_server.Serve("/chunked", resource);
+
+            auto toFile{ FilePath(L"chunked.bin") };
+            auto outcome{ m_harness.Call(L"downloadFile", DownloadOptions("/chunked", toFile)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["bytesWritten"].AsInt64() == 300000);
+            TestCheck(ReadAll(toFile) == LoopbackHttpServer::Pattern(0, 300000));
+        }
+
+        TEST_METHOD(TestDownload_throttledServer) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 100 * 1024;
+            resource.bytesPerSecond = 200 * 1024;
+            m_server.Serve("/slow", resource);
+
+            auto start{ std::chrono::steady_clock::now() };
+            auto outcome{ m_harness.Call(L"downloadFile", DownloadOptions("/slow", FilePath(L"slow.bin"))) };
+            TestCheck(outcome.resolved);
+            TestCheck(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{ 400 });
+        }
+
+        TEST_METHOD(TestDownload_slowResponseWithinReadTimeout) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024;
+            resource.responseDelayMilliseconds = 1000;
+            m_server.Serve("/busy", resource);
+
+            // Answering later than connectionTimeout is fine while the server stays within readTimeout
+            auto options{ DownloadOptions("/busy", FilePath(L"busy.bin")) };
+            options["connectionTimeout"] = 300;
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(outcome.resolved);
+        }
+
+        TEST_METHOD(TestDownload_noResponseTimesOut) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024;
+            resource.responseDelayMilliseconds = 5000;
+            m_server.Serve("/silent", resource);
+
+            auto options{ DownloadOptions("/silent", FilePath(L"silent.bin")) };
+            options["connectionTimeout"] = 200;
+            options["readTimeout"] = 300;
+            auto start{ std::chrono::steady_clock::now() };
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(!outcome.resolved);
+            TestCheck(outcome.value["code"] == "ETIMEDOUT");
+            TestCheck(std::chrono::steady_clock::now() - start < std::chrono::seconds{ 3 });
+        }
+
+        TEST_METHOD(TestDownload_stalledTimesOut) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024 * 1024;
+            resource.disconnectAfter = 64 * 1024;
+            resource.disconnects = 1;
+            resource.stallMilliseconds = 5000;
+            m_server.Serve("/stalled", resource);
+
+            auto options{ DownloadOptions("/stalled", FilePath(L"stalled.bin")) };
+            options["readTimeout"] = 300;
+            auto start{ std::chrono::steady_clock::now() };
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(!outcome.resolved);
+            TestCheck(outcome.value["code"] == "ETIMEDOUT");
+            TestCheck(std::chrono::steady_clock::now() - start < std::chrono::seconds{ 3 });
+
+            auto stats{ m_harness.Call(L"getStats") };
+            TestCheck(stats.value["operations"]["downloadFile"]["errorCodes"]["ETIMEDOUT"].AsInt64() == 1);
+        }
+
+        TEST_METHOD(TestDownload_slowButProgressing) {
+            // A kilobyte every 62ms: filling a whole read buffer takes longer than the
+            // read timeout, but the connection never goes quiet for that long
+            LoopbackHttpServer::Resource resource;
+            resource.size = 32 * 1024;
+            resource.bytesPerSecond = 16 * 1024;
+            m_server.Serve("/trickle", resource);
+
+            auto toFile{ FilePath(L"trickle.bin") };
+            auto options{ DownloadOptions("/trickle", toFile) };
+            options["readTimeout"] = 300;
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["attempts"].AsInt32() == 1);
+            TestCheck(ReadAll(toFile) == LoopbackHttpServer::Pattern(0, 32 * 1024));
+        }
+
+        TEST_METHOD(TestDownload_cancelledInStats) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024 * 1024;
+            resource.bytesPerSecond = 64 * 1024;
+            m_server.Serve("/slow", resource);
+
+            // Sixteen seconds of body, so the download is still running when it is stopped
+            auto options{ DownloadOptions("/slow", FilePath(L"cancelled.bin")) };
+            auto jobId{ m_jobId };
+            auto pending{ m_harness.Start(L"downloadFile", std::move(options)) };
+            m_harness.Call0(L"stopDownload", jobId);
+            auto outcome{ pending.Wait() };
+            TestCheck(!outcome.resolved);
+            TestCheck(outcome.value["message"].AsString().rfind("CANCELLED", 0) == 0);
+
+            auto stats{ m_harness.Call(L"getStats") };
+            auto const& download{ stats.value["operations"]["downloadFile"] };
+            TestCheck(download["errors"].AsInt64() == 1);
+            TestCheck(download["errorCodes"]["CANCELLED"].AsInt64() == 1);
+            TestCheck(download["errorCodes"]["Error"].IsNull());
+        }
+
+        // Polls getJobs until `ready` accepts the entry of the job, for up to five seconds
+        template <typename TReady>
+        React::JSValue WaitForJob(int32_t jobId, TReady ready) {
+            auto deadline{ std::chrono::steady_clock::now() + std::chrono::seconds{ 5 } };
+            while (std::chrono::steady_clock::now() < deadline)
+            {
+                auto jobs{ m_harness.Call(L"getJobs") };
+                for (auto const& job : jobs.value.AsArray())
+                {
+                    if (job["jobId"].AsInt32() == jobId && ready(job))
+                    {
+                        return job.Copy();
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+            }
+            return {};
+        }
+
+        TEST_METHOD(TestSetBandwidthLimit_unknownJob) {
+            auto outcome{ m_harness.Call(L"setBandwidthLimit", React::JSValueObject{ { "maxBytesPerSecond", 1000 }, { "jobId", 424242 } }) };
+            TestCheck(!outcome.resolved);
+            TestCheck(outcome.value["code"] == "ESRCH");
+        }
+
+        TEST_METHOD(TestSetBandwidthLimit_runningDownload) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 256 * 1024;
+            resource.bytesPerSecond = 1024 * 1024; // a quarter of a second on its own
+            m_server.Serve("/limited", resource);
+
+            // Limited as soon as it is registered, so the whole body goes out at the lower rate
+            auto options{ DownloadOptions("/limited", FilePath(L"limited.bin")) };
+            auto jobId{ m_jobId };
+            auto pending{ m_harness.Start(L"downloadFile", std::move(options)) };
+            auto start{ std::chrono::steady_clock::now() };
+            auto limited{ m_harness.Call(L"setBandwidthLimit", React::JSValueObject{ { "maxBytesPerSecond", 128 * 1024 }, { "jobId", jobId } }) };
+            TestCheck(limited.resolved);
+            TestCheck(pending.Wait().resolved);
+            TestCheck(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{ 1000 });
+
+            // The job is gone and its limit with it
+            TestCheck(!m_harness.Call(L"setBandwidthLimit", React::JSValueObject{ { "maxBytesPerSecond", 0 }, { "jobId", jobId } }).resolved);
+        }
+
+        TEST_METHOD(TestGetJobs_runningDownload) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024 * 1024;
+            resource.bytesPerSecond = 64 * 1024;
+            m_server.Serve("/slow", resource);
+
+            auto pending{ m_harness.Start(L"downloadFile", DownloadOptions("/slow", FilePath(L"jobs.bin"))) };
+            auto jobId{ m_jobId };
+            auto job{ WaitForJob(jobId, [](React::JSValue const& job) { return job["bytesTransferred"].AsInt64() > 0; }) };
+            TestCheck(!job.IsNull());
+            TestCheck(job["state"] == "running");
+            TestCheck(job["bytesExpected"].AsInt64() == 1024 * 1024);
+
+            m_harness.Call0(L"stopDownload", jobId);
+            TestCheck(!pending.Wait().resolved);
+            TestCheck(m_harness.Call(L"getJobs").value.AsArray().empty());
+        }
+
+        TEST_METHOD(TestGetJobs_pausedBetweenAttempts) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1000;
+            m_server.Serve("/file", resource);
+            m_server.Fail("/file", 503, 1);
+
+            auto options{ DownloadOptions("/file", FilePath(L"paused.bin")) };
+            options["retry"] = React::JSValueObject{ { "maxAttempts", 2 }, { "initialDelay", 1000 }, { "maxDelay", 1000 } };
+            auto pending{ m_harness.Start(L"downloadFile", std::move(options)) };
+            auto job{ WaitForJob(m_jobId, [](React::JSValue const& job) { return job["state"] == "paused"; }) };
+            TestCheck(!job.IsNull());
+
+            auto outcome{ pending.Wait() };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["attempts"].AsInt32() == 2);
+        }
+
+        TEST_METHOD(TestDownload_decompress) {
+            auto original{ LoopbackHttpServer::Pattern(0, 200000) };
+            std::vector<uint8_t> compressed;
+            StreamingDeflater deflater{ StreamingDeflater::Format::Gzip };
+            deflater.Write(reinterpret_cast<uint8_t const*>(original.data()), original.size(), compressed);
+            deflater.Finish(compressed);
+
+            // A .gz file rather than Content-Encoding, which HttpClient would undo itself
+            LoopbackHttpServer::Resource resource;
+            resource.body.assign(compressed.begin(), compressed.end());
+            resource.contentType = "application/gzip";
+            m_server.Serve("/file.gz", resource);
+
+            auto toFile{ FilePath(L"decompressed.bin") };
+            auto options{ DownloadOptions("/file.gz", toFile) };
+            options["decompress"] = "gzip";
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["bytesRead"].AsInt64() == static_cast<int64_t>(compressed.size()));
+            TestCheck(outcome.value["bytesWritten"].AsInt64() == static_cast<int64_t>(original.size()));
+            TestCheck(ReadAll(toFile) == original);
+        }
+
+        TEST_METHOD(TestDownload_checksumMismatch) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 4096;
+            m_server.Serve("/file", resource);
+
+            auto toFile{ FilePath(L"checksum.bin") };
+            WriteAll(toFile, "the user's own file");
+            auto options{ DownloadOptions("/file", toFile) };
+            options["checksum"] = React::JSValueObject{ { "algorithm", "sha256" }, { "expected", "00" } };
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(!outcome.resolved);
+            TestCheck(outcome.value["code"] == "EINTEGRITY");
+            TestCheck(ReadAll(toFile) == "the user's own file");
+            TestCheck(!std::filesystem::exists(std::filesystem::u8path(PartialPath(toFile, m_jobId))));
+        }
+
+        TEST_METHOD(TestDownload_failedKeepsExistingFile) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024 * 1024;
+            resource.disconnectAfter = 300000;
+            resource.disconnects = 1;
+            m_server.Serve("/broken", resource);
+
+            // Without a retry option the broken transfer fails the download
+            auto toFile{ FilePath(L"failed.bin") };
+            WriteAll(toFile, "the user's own file");
+            auto outcome{ m_harness.Call(L"downloadFile", DownloadOptions("/broken", toFile)) };
+            TestCheck(!outcome.resolved);
+            TestCheck(ReadAll(toFile) == "the user's own file");
+            TestCheck(!std::filesystem::exists(std::filesystem::u8path(PartialPath(toFile, m_jobId))));
+        }
+
+        TEST_METHOD(TestDownload_cancelledKeepsExistingFile) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024 * 1024;
+            resource.bytesPerSecond = 64 * 1024;
+            m_server.Serve("/slow", resource);
+
+            auto toFile{ FilePath(L"cancelled.bin") };
+            WriteAll(toFile, "the user's own file");
+            auto pending{ m_harness.Start(L"downloadFile", DownloadOptions("/slow", toFile)) };
+            auto jobId{ m_jobId };
+            TestCheck(!WaitForJob(jobId, [](React::JSValue const& job) { return job["bytesTransferred"].AsInt64() > 0; }).IsNull());
+
+            m_harness.Call0(L"stopDownload", jobId);
+            TestCheck(!pending.Wait().resolved);
+            TestCheck(ReadAll(toFile) == "the user's own file");
+            TestCheck(!std::filesystem::exists(std::filesystem::u8path(PartialPath(toFile, jobId))));
+        }
+
+        TEST_METHOD(TestDownload_resumesAfterDisconnect) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024 * 1024;
+            resource.etag = "\"v1\"";
+            resource.disconnectAfter = 300000;
+            resource.disconnects = 1;
+            m_server.Serve("/flaky", resource);
+
+            auto toFile{ FilePath(L"resumed.bin") };
+            auto options{ DownloadOptions("/flaky", toFile) };
+            options["retry"] = Retry(3);
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["attempts"].AsInt32() == 2);
+            TestCheck(ReadAll(toFile) == LoopbackHttpServer::Pattern(0, 1024 * 1024));
+
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 2);
+            TestCheck(requests[1].headers["range"].find("bytes=") == 0);
+            TestCheck(requests[1].headers["if-range"] == "\"v1\"");
+        }
+
+        TEST_METHOD(TestDownload_restartsWithoutValidator) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1024 * 1024;
+            resource.disconnectAfter = 300000;
+            resource.disconnects = 1;
+            m_server.Serve("/flaky", resource);
+
+            auto toFile{ FilePath(L"restarted.bin") };
+            auto options{ DownloadOptions("/flaky", toFile) };
+            options["retry"] = Retry(3);
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["attempts"].AsInt32() == 2);
+            TestCheck(ReadAll(toFile) == LoopbackHttpServer::Pattern(0, 1024 * 1024));
+
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 2);
+            TestCheck(requests[1].headers.count("range") == 0);
+        }
+
+        TEST_METHOD(TestDownload_preallocationTrimmedToBody) {
+            LoopbackHttpServer::Resource announced;
+            announced.size = 4 * 1024 * 1024;
+            announced.disconnectAfter = 300000;
+            announced.disconnects = 1;
+            m_server.Serve("/shrinking", announced);
+
+            // The first response announces 4 MB, which is reserved on disk, and breaks off; by the
+            // time the download starts over the resource has shrunk, so far less arrives than was announced
+            auto toFile{ FilePath(L"shrunk.bin") };
+            auto options{ DownloadOptions("/shrinking", toFile) };
+            options["retry"] = Retry(3);
+            options["preallocate"] = true;
+            auto jobId{ m_jobId };
+            std::atomic<bool> shrunk{ false };
+            TestHooks::JobProgress = [this, jobId, &shrunk](int32_t progressed) {
+                if (progressed == jobId && !shrunk.exchange(true))
+                {
+                    LoopbackHttpServer::Resource sent;
+                    sent.size = 256 * 1024;
+                    m_server.Serve("/shrinking", sent);
+                }
+            };
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestHooks::JobProgress = nullptr;
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["attempts"].AsInt32() == 2);
+            TestCheck(ReadAll(toFile) == LoopbackHttpServer::Pattern(0, 256 * 1024));
+
+            // What was reserved and never written is given back, up to the last cluster
+            TestCheck(std::filesystem::file_size(std::filesystem::u8path(toFile)) == 256 * 1024);
+            TestCheck(AllocatedSize(toFile) < 256 * 1024 + 64 * 1024);
+        }
+
+        TEST_METHOD(TestDownload_retriesServerErrors) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1000;
+            m_server.Serve("/busy", resource);
+            m_server.Fail("/busy", 503, 2);
+
+            auto toFile{ FilePath(L"busy.bin") };
+            auto options{ DownloadOptions("/busy", toFile) };
+            options["retry"] = Retry(3);
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"].AsInt32() == 200);
+            TestCheck(outcome.value["attempts"].AsInt32() == 3);
+            TestCheck(ReadAll(toFile) == LoopbackHttpServer::Pattern(0, 1000));
+        }
+
+        TEST_METHOD(TestDownload_retryAfterBeyondMaxDelay) {
+            m_server.Fail("/busy", 503, 1, 60);
+
+            auto options{ DownloadOptions("/busy", FilePath(L"busy.bin")) };
+            options["retry"] = Retry(3);
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"].AsInt32() == 503);
+            TestCheck(outcome.value["attempts"].AsInt32() == 1);
+        }
+
+        TEST_METHOD(TestDownload_notModified) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 1000;
+            resource.etag = "\"v1\"";
+            m_server.Serve("/file", resource);
+
+            auto options{ DownloadOptions("/file", FilePath(L"notModified.bin")) };
+            options["headers"] = React::JSValueObject{ { "If-None-Match", "\"v1\"" } };
+            auto outcome{ m_harness.Call(L"downloadFile", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"].AsInt32() == 304);
+            TestCheck(outcome.value["bytesWritten"].AsInt64() == 0);
+        }
+
+        TEST_METHOD(TestDownloadCache_hitServesStoredCopy) {
+            auto folder{ ConfigureCache() };
+            LoopbackHttpServer::Resource resource;
+            resource.size = 100000;
+            resource.etag = "\"v1\"";
+            m_server.Serve("/cached", resource);
+
+            auto first{ m_harness.Call(L"downloadFile", CachedDownloadOptions("/cached", FilePath(L"cached1.bin"))) };
+            TestCheck(first.resolved);
+            TestCheck(first.value["statusCode"].AsInt32() == 200);
+            TestCheck(!first.value["fromCache"].AsBoolean());
+            TestCheck(std::distance(std::filesystem::directory_iterator{ folder }, std::filesystem::directory_iterator{}) == 2);
+            auto sent{ m_server.BodyBytesSent() };
+
+            auto toFile{ FilePath(L"cached2.bin") };
+            auto second{ m_harness.Call(L"downloadFile", CachedDownloadOptions("/cached", toFile)) };
+            TestCheck(second.resolved);
+            TestCheck(second.value["statusCode"].AsInt32() == 304);
+            TestCheck(second.value["fromCache"].AsBoolean());
+            TestCheck(second.value["bytesWritten"].AsInt64() == 100000);
+            TestCheck(ReadAll(toFile) == LoopbackHttpServer::Pattern(0, 100000));
+            TestCheck(m_server.BodyBytesSent() == sent);
+
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 2);
+            TestCheck(requests[0].headers.count("if-none-match") == 0);
+            TestCheck(requests[1].headers["if-none-match"] == "\"v1\"");
+
+            auto stats{ m_harness.Call(L"getDownloadCacheStats") };
+            TestCheck(stats.value["hits"].AsInt64() == 1);
+            TestCheck(stats.value["misses"].AsInt64() == 1);
+            TestCheck(stats.value["bytesServed"].AsInt64() == 100000);
+        }
+
+        TEST_METHOD(TestDownloadCache_lastModifiedRevalidation) {
+            ConfigureCache();
+            LoopbackHttpServer::Resource resource;
+            resource.body = "dated";
+            resource.lastModified = "Mon, 01 Jan 2024 00:00:00 GMT";
+            m_server.Serve("/dated", resource);
+
+            TestCheck(m_harness.Call(L"downloadFile", CachedDownloadOptions("/dated", FilePath(L"dated1.bin"))).resolved);
+            auto toFile{ FilePath(L"dated2.bin") };
+            auto second{ m_harness.Call(L"downloadFile", CachedDownloadOptions("/dated", toFile)) };
+            TestCheck(second.value["fromCache"].AsBoolean());
+            TestCheck(ReadAll(toFile) == "dated");
+
+            auto requests{ m_server.Requests() };
+            TestCheck(requests[1].headers["if-modified-since"] == "Mon, 01 Jan 2024 00:00:00 GMT");
+            TestCheck(requests[1].headers.count("if-none-match") == 0);
+        }
+
+        TEST_METHOD(TestDownloadCache_notModifiedRefreshesEntry) {
+            ConfigureCache();
+            LoopbackHttpServer::Resource resource;
+            resource.body = "same body";
+            resource.etag = "\"v1\"";
+            resource.lastModified = "Mon, 01 Jan 2024 00:00:00 GMT";
+            m_server.Serve("/refreshed", resource);
+            TestCheck(m_harness.Call(L"downloadFile", CachedDownloadOptions("/refreshed", FilePath(L"refreshed1.bin"))).resolved);
+
+            // The ETag still matches, so the 304 brings the new date along with it
+            resource.lastModified = "Tue, 02 Jan 2024 00:00:00 GMT";
+            m_server.Serve("/refreshed", resource);
+            auto second{ m_harness.Call(L"downloadFile", CachedDownloadOptions("/refreshed", FilePath(L"refreshed2.bin"))) };
+            TestCheck(second.value["fromCache"].AsBoolean());
+
+            auto toFile{ FilePath(L"refreshed3.bin") };
+            auto third{ m_harness.Call(L"downloadFile", CachedDownloadOptions("/refreshed", toFile)) };
+            TestCheck(third.value["fromCache"].AsBoolean());
+            TestCheck(ReadAll(toFile) == "same body");
+
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 3);
+            TestCheck(requests[1].headers["if-modified-since"] == "Mon, 01 Jan 2024 00:00:00 GMT");
+            TestCheck(requests[2].headers["if-modified-since"] == "Tue, 02 Jan 2024 00:00:00 GMT");
+            TestCheck(requests[2].headers["if-none-match"] == "\"v1\"");
+        }
+
+        TEST_METHOD(TestDownloadCache_changedResourceReplacesEntry) {
+            ConfigureCache();
+            LoopbackHttpServer::Resource resource;
+            resource.body = "first version";
+            resource.etag = "\"v1\"";
+            m_server.Serve("/changing", resource);
+            TestCheck(m_harness.Call(L"downloadFile", CachedDownloadOptions("/changing", FilePath(L"changing1.bin"))).resolved);
+
+            resource.body = "second version";
+            resource.etag = "\"v2\"";
+            m_server.Serve("/changing", resource);
+            auto toFile{ FilePath(L"changing2.bin") };
+            auto second{ m_harness.Call(L"downloadFile", CachedDownloadOptions("/changing", toFile)) };
+            TestCheck(second.value["statusCode"].AsInt32() == 200);
+            TestCheck(!second.value["fromCache"].AsBoolean());
+            TestCheck(ReadAll(toFile) == "second version");
+
+            toFile = FilePath(L"changing3.bin");
+            auto third{ m_harness.Call(L"downloadFile", CachedDownloadOptions("/changing", toFile)) };
+            TestCheck(third.value["fromCache"].AsBoolean());
+            TestCheck(ReadAll(toFile) == "second version");
+            TestCheck(m_server.Requests()[2].headers["if-none-match"] == "\"v2\"");
+
+            auto stats{ m_harness.Call(L"getDownloadCacheStats") };
+            TestCheck(stats.value["hits"].AsInt64() == 1);
+            TestCheck(stats.value["misses"].AsInt64() == 2);
+        }
+
+        TEST_METHOD(TestDownloadCache_withoutValidatorsNotStored) {
+            auto folder{ ConfigureCache() };
+            LoopbackHttpServer::Resource resource;
+            resource.body = "volatile";
+            m_server.Serve("/volatile", resource);
+
+            TestCheck(m_harness.Call(L"downloadFile", CachedDownloadOptions("/volatile", FilePath(L"volatile1.bin"))).resolved);
+            auto second{ m_harness.Call(L"downloadFile", CachedDownloadOptions("/volatile", FilePath(L"volatile2.bin"))) };
+            TestCheck(second.value["statusCode"].AsInt32() == 200);
+            TestCheck(std::filesystem::is_empty(folder));
+            TestCheck(m_server.Requests()[1].headers.count("if-none-match") == 0);
+            TestCheck(m_harness.Call(L"getDownloadCacheStats").value["hits"].AsInt64() == 0);
+        }
+
+        TEST_METHOD(TestDownloadCache_defaultFolderWithoutPackageIdentity) {
+            // This executable has no app data, so the cache falls back to the temp directory
+            LoopbackHttpServer::Resource resource;
+            resource.body = "default folder";
+            resource.etag = "\"v1\"";
+            m_server.Serve("/default", resource);
+
+            TestCheck(m_harness.Call(L"downloadFile", CachedDownloadOptions("/default", FilePath(L"default1.bin"))).resolved);
+            auto second{ m_harness.Call(L"downloadFile", CachedDownloadOptions("/default", FilePath(L"default2.bin"))) };
+            TestCheck(second.value["fromCache"].AsBoolean());
+            TestCheck(std::filesystem::is_directory(std::filesystem::temp_directory_path() / L"RNFSHttpCache"));
+        }
+
+        TEST_METHOD(TestConfigureDownloadCache_relativeFolder) {
+            auto outcome{ m_harness.Call(L"configureDownloadCache", React::JSValueObject{ { "folder", "cache" } }) };
+            TestCheck(!outcome.resolved);
+        }
+
+        TEST_METHOD(TestFetch_base64) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 3000;
+            resource.contentType = "application/octet-stream";
+            m_server.Serve("/blob", resource);
+
+            auto outcome{ m_harness.Call(L"fetchToMemory", FetchOptions("/blob", "base64")) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"].AsInt32() == 200);
+            TestCheck(outcome.value["bytesRead"].AsInt64() == 3000);
+            TestCheck(outcome.value["headers"]["Content-Type"] == "application/octet-stream");
+
+            auto body{ winrt::Windows::Security::Cryptography::CryptographicBuffer::DecodeFromBase64String(
+                winrt::to_hstring(outcome.value["body"].AsString())) };
+            std::string decoded(body.Length(), '\0');
+            std::copy_n(body.data(), body.Length(), decoded.begin());
+            TestCheck(decoded == LoopbackHttpServer::Pattern(0, 3000));
+        }
+
+        TEST_METHOD(TestFetch_utf8) {
+            LoopbackHttpServer::Resource resource;
+            resource.body = "{\"squirrels\":3}";
+            resource.contentType = "application/json";
+            m_server.Serve("/json", resource);
+
+            auto outcome{ m_harness.Call(L"fetchToMemory", FetchOptions("/json", "utf8")) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["body"] == "{\"squirrels\":3}");
+        }
+
+        TEST_METHOD(TestFetch_utf8Invalid) {
+            LoopbackHttpServer::Resource resource;
+            resource.body = "squirrels \xff\xfe";
+            m_server.Serve("/binary", resource);
+
+            auto outcome{ m_harness.Call(L"fetchToMemory", FetchOptions("/binary", "utf8")) };
+            TestCheck(!outcome.resolved);
+            TestCheck(outcome.value["message"].AsString().find("UTF-8") != std::string::npos);
+
+            // The same bytes come through intact as base64
+            outcome = m_harness.Call(L"fetchToMemory", FetchOptions("/binary", "base64"));
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["body"] == "c3F1aXJyZWxzIP/+");
+        }
+
+        TEST_METHOD(TestFetch_contentLengthOverMaxSize) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 5000;
+            m_server.Serve("/large", resource);
+
+            auto options{ FetchOptions("/large", "base64") };
+            options["maxSize"] = 4096;
+            auto outcome{ m_harness.Call(L"fetchToMemory", std::move(options)) };
+            TestCheck(!outcome.resolved);
+            TestCheck(outcome.value["code"] == "EFBIG");
+        }
+
+        TEST_METHOD(TestFetch_chunkedOverMaxSize) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 200000;
+            resource.chunked = true;
+            m_server.Serve("/large", resource);
+
+            auto options{ FetchOptions("/large", "base64") };
+            options["maxSize"] = 100000;
+            auto outcome{ m_harness.Call(L"fetchToMemory", std::move(options)) };
+            TestCheck(!outcome.resolved);
+            TestCheck(outcome.value["code"] == "EFBIG");
+        }
+
+        TEST_METHOD(TestFetch_stalledTimesOut) {
+            LoopbackHttpServer::Resource resource;
+            resource.size = 256 * 1024;
+            resource.disconnectAfter = 16 * 1024;
+            resource.disconnects = 1;
+            resource.stallMilliseconds = 5000;
+            m_server.Serve("/stalled", resource);
+
+            auto options{ FetchOptions("/stalled", "base64") };
+            options["readTimeout"] = 300;
+            auto start{ std::chrono::steady_clock::now() };
+            auto outcome{ m_harness.Call(L"fetchToMemory", std::move(options)) };
+            TestCheck(!outcome.resolved);
+            TestCheck(outcome.value["code"] == "ETIMEDOUT");
+            TestCheck(std::chrono::steady_clock::now() - start < std::chrono::seconds{ 3 });
+        }
+
+        TEST_METHOD(TestFetch_retriesServerErrors) {
+            LoopbackHttpServer::Resource resource;
+            resource.body = "ready";
+            m_server.Serve("/busy", resource);
+            m_server.Fail("/busy", 503, 1);
+
+            auto options{ FetchOptions("/busy", "utf8") };
+            options["retry"] = Retry(2);
+            auto outcome{ m_harness.Call(L"fetchToMemory", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["attempts"].AsInt32() == 2);
+            TestCheck(outcome.value["body"] == "ready");
+        }
+
+        TEST_METHOD(TestUpload_multipart) {
+            auto file{ FilePath(L"upload.txt") };
+            WriteAll(file, "squirrels squirrels squirrels");
+
+            auto outcome{ m_harness.Call(L"uploadFiles", UploadOptions("/upload", { file })) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"] == "200");
+            TestCheck(outcome.value["body"] == "ok");
+
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 1);
+            TestCheck(requests[0].method == "POST");
+            TestCheck(requests[0].headers["content-type"].find("multipart/form-data") == 0);
+            TestCheck(requests[0].body.find("squirrels squirrels squirrels") != std::string::npos);
+        }
+
+        TEST_METHOD(TestUpload_retriesServerErrors) {
+            auto file{ FilePath(L"upload.txt") };
+            WriteAll(file, "squirrels squirrels squirrels");
+            m_server.Fail("/upload", 503, 1);
+
+            auto options{ UploadOptions("/upload", { file }) };
+            options["retry"] = Retry(2);
+            auto outcome{ m_harness.Call(L"uploadFiles", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"] == "200");
+            TestCheck(outcome.value["attempts"].AsInt32() == 2);
+
+            // The retried request carries the whole body again
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 2);
+            TestCheck(requests[1].body.find("squirrels squirrels squirrels") != std::string::npos);
+        }
+
+        TEST_METHOD(TestUpload_compressed) {
+            auto file{ FilePath(L"upload.txt") };
+            std::string original;
+            for (int i = 0; i < 1000; ++i)
+            {
+                original += "squirrels squirrels squirrels\n";
+            }
+            WriteAll(file, original);
+
+            auto options{ UploadOptions("/upload", { file }) };
+            options["compress"] = "gzip";
+            auto outcome{ m_harness.Call(L"uploadFiles", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"] == "200");
+
+            // The whole body is encoded, so the server sees plain parts once it decodes it
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 1);
+            TestCheck(requests[0].headers["content-encoding"] == "gzip");
+            TestCheck(requests[0].headers["content-type"].find("multipart/form-data; boundary=") == 0);
+            TestCheck(requests[0].body.size() < original.size());
+
+            std::vector<uint8_t> decoded;
+            StreamingInflater inflater{ StreamingInflater::Format::Gzip };
+            inflater.Write(reinterpret_cast<uint8_t const*>(requests[0].body.data()), requests[0].body.size(), decoded);
+            inflater.Finish(decoded);
+            std::string body{ decoded.begin(), decoded.end() };
+            TestCheck(body.find("Content-Encoding") == std::string::npos);
+            TestCheck(body.find("upload.txt") != std::string::npos);
+            TestCheck(body.find("\r\n\r\n" + original + "\r\n--") != std::string::npos);
+        }
+
+        TEST_METHOD(TestUpload_inMemoryPart) {
+            auto options{ UploadOptions("/upload", {}) };
+            React::JSValueArray items;
+            items.push_back(React::JSValueObject{
+                { "name", "file" },
+                { "filename", "note.txt" },
+                { "filetype", "text/plain" },
+                { "data", "squirrels in memory" },
+                { "encoding", "utf8" },
+            });
+            items.push_back(React::JSValueObject{
+                { "name", "blob" },
+                { "filename", "blob.bin" },
+                { "filetype", "application/octet-stream" },
+                { "data", "c3F1aXJyZWxz" }, // "squirrels"
+            });
+            options["files"] = std::move(items);
+
+            auto outcome{ m_harness.Call(L"uploadFiles", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"] == "200");
+
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 1);
+            TestCheck(requests[0].body.find("squirrels in memory") != std::string::npos);
+            TestCheck(requests[0].body.find("\r\n\r\nsquirrels\r\n") != std::string::npos);
+        }
+
+        TEST_METHOD(TestUpload_inMemoryPartNotResumable) {
+            auto options{ UploadOptions("/upload", {}) };
+            React::JSValueArray items;
+            items.push_back(React::JSValueObject{
+                { "name", "file" },
+                { "filename", "note.txt" },
+                { "filetype", "text/plain" },
+                { "data", "squirrels" },
+                { "encoding", "utf8" },
+            });
+            options["files"] = std::move(items);
+            options["resumable"] = true;
+
+            auto outcome{ m_harness.Call(L"uploadFiles", std::move(options)) };
+            TestCheck(!outcome.resolved);
+            TestCheck(m_server.Requests().empty());
+        }
+
+        TEST_METHOD(TestUpload_parallel) {
+            auto first{ FilePath(L"first.txt") };
+            auto second{ FilePath(L"second.txt") };
+            WriteAll(first, "first file");
+            WriteAll(second, "second file");
+
+            auto options{ UploadOptions("/upload", { first, second }) };
+            options["parallel"] = true;
+            auto outcome{ m_harness.Call(L"uploadFiles", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["files"].AsArray().size() == 2);
+            TestCheck(m_server.Requests().size() == 2);
+        }
+
+        TEST_METHOD(TestResumableUpload_createThenComplete) {
+            auto journal{ ConfigureJournal() };
+            m_server.EnableTus("/tus");
+            auto file{ FilePath(L"resumable.bin") };
+            auto content{ LoopbackHttpServer::Pattern(0, 40000) };
+            WriteAll(file, content);
+
+            auto outcome{ m_harness.Call(L"uploadFiles", ResumableOptions("/tus", file, 16384)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["statusCode"] == "204");
+            TestCheck(outcome.value["uploadUrls"].AsArray()[0] == m_server.Url("/tus/0"));
+            TestCheck(outcome.value["retries"].AsInt32() == 0);
+            TestCheck(m_server.TusUpload(0) == content);
+
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 4);
+            TestCheck(requests[0].method == "POST");
+            TestCheck(requests[0].headers["upload-length"] == "40000");
+            TestCheck(requests[0].headers["tus-resumable"] == "1.0.0");
+            TestCheck(requests[1].headers["upload-offset"] == "0");
+            TestCheck(requests[2].headers["upload-offset"] == "16384");
+            TestCheck(requests[3].headers["upload-offset"] == "32768");
+            TestCheck(requests[3].bodySize == 40000 - 32768);
+
+            // A finished upload leaves nothing to resume
+            TestCheck(std::filesystem::is_empty(journal));
+        }
+
+        TEST_METHOD(TestResumableUpload_resumesAfterInterruption) {
+            auto journal{ ConfigureJournal() };
+            m_server.EnableTus("/tus");
+            auto file{ FilePath(L"interrupted.bin") };
+            auto content{ LoopbackHttpServer::Pattern(0, 8 * 16384) };
+            WriteAll(file, content);
+
+            // Stopped once the server holds a chunk; the rate limit keeps the others from all going out first
+            auto options{ ResumableOptions("/tus", file, 16384) };
+            options["maxBytesPerSecond"] = 64 * 1024;
+            auto jobId{ m_jobId };
+            std::atomic<bool> stopped{ false };
+            TestHooks::JobProgress = [this, jobId, &stopped](int32_t progressed) {
+                if (progressed == jobId && !m_server.TusUpload(0).empty() && !stopped.exchange(true))
+                {
+                    m_harness.Call0(L"stopUpload", jobId);
+                }
+            };
+            auto first{ m_harness.Call(L"uploadFiles", std::move(options)) };
+            TestHooks::JobProgress = nullptr;
+            TestCheck(!first.resolved);
+            TestCheck(first.value["message"].AsString().rfind("CANCELLED", 0) == 0);
+            TestCheck(!std::filesystem::is_empty(journal));
+            auto kept{ m_server.TusUpload(0).size() };
+            TestCheck(kept > 0 && kept < content.size());
+
+            // The second call finds the journal, asks the server where it stopped and sends only the rest
+            auto second{ m_harness.Call(L"uploadFiles", ResumableOptions("/tus", file, 16384)) };
+            TestCheck(second.resolved);
+            TestCheck(second.value["uploadUrls"].AsArray()[0] == m_server.Url("/tus/0"));
+            TestCheck(m_server.TusUpload(0) == content);
+            TestCheck(std::filesystem::is_empty(journal));
+
+            auto requests{ m_server.Requests() };
+            TestCheck(std::count_if(requests.begin(), requests.end(), [](auto const& request) { return request.method == "POST"; }) == 1);
+            auto head{ std::find_if(requests.begin(), requests.end(), [](auto const& request) { return request.method == "HEAD"; }) };
+            TestCheck(head != requests.end());
+            auto resumed{ std::find_if(head, requests.end(), [](auto const& request) { return request.method == "PATCH"; }) };
+            TestCheck(resumed != requests.end());
+            auto resumedAt{ std::stoull(resumed->headers["upload-offset"]) };
+            TestCheck(resumedAt >= kept && resumedAt % 16384 == 0); // the stopped chunk may still have landed
+        }
+
+        TEST_METHOD(TestResumableUpload_conflictResyncs) {
+            ConfigureJournal();
+            m_server.EnableTus("/tus");
+            m_server.Fail("/tus/0", 409, 1);
+            auto file{ FilePath(L"conflict.bin") };
+            auto content{ LoopbackHttpServer::Pattern(0, 40000) };
+            WriteAll(file, content);
+
+            auto outcome{ m_harness.Call(L"uploadFiles", ResumableOptions("/tus", file, 16384)) };
+            TestCheck(outcome.resolved);
+            TestCheck(outcome.value["retries"].AsInt32() == 1);
+            TestCheck(m_server.TusUpload(0) == content);
+
+            // The rejected chunk is followed by a HEAD, and sending goes on from the offset it reports
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 6);
+            TestCheck(requests[1].method == "PATCH");
+            TestCheck(requests[2].method == "HEAD");
+            TestCheck(requests[3].method == "PATCH");
+            TestCheck(requests[3].headers["upload-offset"] == "0");
+        }
+
+        TEST_METHOD(TestResumableUpload_createRetriedAfterBackoff) {
+            ConfigureJournal();
+            m_server.EnableTus("/tus");
+            m_server.Fail("/tus", 503, 1);
+            auto file{ FilePath(L"create.bin") };
+            auto content{ LoopbackHttpServer::Pattern(0, 20000) };
+            WriteAll(file, content);
+
+            // Without a retry option the create is sent again too, but not before the default delay
+            auto start{ std::chrono::steady_clock::now() };
+            auto outcome{ m_harness.Call(L"uploadFiles", ResumableOptions("/tus", file, 16384)) };
+            TestCheck(outcome.resolved);
+            TestCheck(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{ 250 });
+            TestCheck(m_server.TusUpload(0) == content);
+
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 4);
+            TestCheck(requests[0].method == "POST");
+            TestCheck(requests[1].method == "POST");
+        }
+
+        TEST_METHOD(TestResumableUpload_failedHeadRetried) {
+            ConfigureJournal();
+            m_server.EnableTus("/tus");
+            m_server.Fail("/tus/0", 503, 2); // the first chunk and the HEAD after it
+            auto file{ FilePath(L"head.bin") };
+            auto content{ LoopbackHttpServer::Pattern(0, 40000) };
+            WriteAll(file, content);
+
+            auto options{ ResumableOptions("/tus", file, 16384) };
+            options["retry"] = Retry(4);
+            auto outcome{ m_harness.Call(L"uploadFiles", std::move(options)) };
+            TestCheck(outcome.resolved);
+            TestCheck(m_server.TusUpload(0) == content);
+
+            // The failed HEAD is one more attempt, followed by another HEAD rather than failing the job
+            auto requests{ m_server.Requests() };
+            TestCheck(requests.size() == 7);
+            TestCheck(requests[1].method == "PATCH");
+            TestCheck(requests[2].method == "HEAD");
+            TestCheck(requests[3].method == "HEAD");
+            TestCheck(requests[4].method == "PATCH");
+            TestCheck(requests[4].headers["upload-offset"] == "0");
+        }
+
+        TEST_METHOD(TestConfigureUploadJournal_relativeFolder) {
+            auto outcome{ m_harness.Call(L"configureUploadJournal", React::JSValueObject{ { "folder", "journal" } }) };
+            TestCheck(!outcome.resolved);
+        }
+    };
+}
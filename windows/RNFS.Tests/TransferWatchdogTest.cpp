@@ -0,0 +1,78 @@
+#include "pch.h"
+
+#include <chrono>
+#include <thread>
+#include "TransferWatchdog.h"
+
+namespace ReactNativeTests {
+
+    using winrt::Windows::Foundation::AsyncStatus;
+    using winrt::Windows::Foundation::IAsyncAction;
+
+    static IAsyncAction run_for(std::chrono::milliseconds duration)
+    {
+        auto until{ std::chrono::steady_clock::now() + duration };
+        while (std::chrono::steady_clock::now() < until)
+        {
+            co_await winrt::resume_after(std::chrono::milliseconds{ 5 });
+        }
+    }
+
+    static void wait_until_done(IAsyncAction const& action)
+    {
+        while (action.Status() == AsyncStatus::Started)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 5 });
+        }
+    }
+
+    TEST_CLASS(TransferWatchdogTest) {
+        TEST_METHOD(TestWatch_cancelsStalledOperation) {
+            TransferWatchdog watchdog;
+            auto stalled{ run_for(std::chrono::seconds{ 10 }) };
+            auto start{ std::chrono::steady_clock::now() };
+            watchdog.Watch(stalled, std::chrono::milliseconds{ 100 });
+
+            wait_until_done(stalled);
+            auto elapsed{ std::chrono::steady_clock::now() - start };
+            TestCheck(stalled.Status() == AsyncStatus::Canceled);
+            TestCheck(watchdog.Expired());
+            TestCheck(elapsed >= std::chrono::milliseconds{ 100 });
+            TestCheck(elapsed < std::chrono::seconds{ 2 });
+        }
+
+        TEST_METHOD(TestWatch_progressingTransferNotCancelled) {
+            // Every read finishes well within the timeout, though the whole transfer takes much longer
+            TransferWatchdog watchdog;
+            for (int read = 0; read < 20; ++read)
+            {
+                auto operation{ run_for(std::chrono::milliseconds{ 30 }) };
+                watchdog.Watch(operation, std::chrono::milliseconds{ 100 });
+                wait_until_done(operation);
+                TestCheck(operation.Status() == AsyncStatus::Completed);
+            }
+            TestCheck(!watchdog.Expired());
+        }
+
+        TEST_METHOD(TestWatch_zeroTimeoutStopsWatching) {
+            TransferWatchdog watchdog;
+            auto operation{ run_for(std::chrono::milliseconds{ 300 }) };
+            watchdog.Watch(operation, std::chrono::milliseconds{ 50 });
+            watchdog.Watch(operation, std::chrono::milliseconds{ 0 });
+            wait_until_done(operation);
+            TestCheck(operation.Status() == AsyncStatus::Completed);
+            TestCheck(!watchdog.Expired());
+        }
+
+        TEST_METHOD(TestReset_clearsExpired) {
+            TransferWatchdog watchdog;
+            auto stalled{ run_for(std::chrono::seconds{ 10 }) };
+            watchdog.Watch(stalled, std::chrono::milliseconds{ 50 });
+            wait_until_done(stalled);
+            TestCheck(watchdog.Expired());
+
+            watchdog.Reset();
+            TestCheck(!watchdog.Expired());
+        }
+    };
+}
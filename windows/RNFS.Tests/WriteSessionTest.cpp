@@ -0,0 +1,126 @@
+#include "pch.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "TestFiles.h"
+#include "WriteSession.h"
+
+namespace ReactNativeTests {
+
+    TEST_CLASS(WriteSessionTest) {
+        std::filesystem::path m_folder{ fresh_folder(L"rnfs-write-session-test") };
+        std::filesystem::path m_file{ m_folder / L"session.txt" };
+
+        TEST_METHOD(TestSubmit_writesInTicketOrder) {
+            WriteSession session{ m_file, false };
+            auto first{ session.Reserve() };
+            auto second{ session.Reserve() };
+            auto third{ session.Reserve() };
+
+            std::vector<std::string> done;
+            auto record = [&done](std::string name) { return [&done, name](winrt::hresult) { done.push_back(name); }; };
+            session.Submit(third, bytes_of("three"), record("three"));
+            session.Submit(second, bytes_of("two "), record("two"));
+            TestCheck(done.empty());
+            session.Submit(first, bytes_of("one "), record("one"));
+            TestCheck((done == std::vector<std::string>{ "one", "two", "three" }));
+
+            winrt::hresult closed{ E_FAIL };
+            session.SubmitClose(session.Reserve(), true, [&](winrt::hresult result) { closed = result; });
+            TestCheck(closed == S_OK);
+            TestCheck(contents_of(m_file) == "one two three");
+            TestCheck(session.BytesWritten() == 13);
+        }
+
+        TEST_METHOD(TestSubmit_buffersUntilFull) {
+            WriteSession session{ m_file, false, 8 };
+            session.Submit(session.Reserve(), bytes_of("abcd"), nullptr);
+            TestCheck(session.BytesWritten() == 0);
+
+            session.Submit(session.Reserve(), bytes_of("efghij"), nullptr);
+            TestCheck(session.BytesWritten() == 4);
+
+            // A chunk as large as the buffer is written right away, after what is buffered
+            session.Submit(session.Reserve(), bytes_of("0123456789"), nullptr);
+            TestCheck(session.BytesWritten() == 20);
+            TestCheck(contents_of(m_file) == "abcdefghij0123456789");
+        }
+
+        TEST_METHOD(TestSkip_laterChunksWritten) {
+            WriteSession session{ m_file, false };
+            auto first{ session.Reserve() };
+            auto skipped{ session.Reserve() };
+            auto last{ session.Reserve() };
+            session.Submit(last, bytes_of("c"), nullptr);
+            session.Submit(first, bytes_of("a"), nullptr);
+            session.Skip(skipped);
+            session.SubmitClose(session.Reserve(), false, nullptr);
+            TestCheck(contents_of(m_file) == "ac");
+        }
+
+        TEST_METHOD(TestOpen_append) {
+            std::ofstream{ m_file } << "head ";
+            {
+                WriteSession session{ m_file, true };
+                session.Submit(session.Reserve(), bytes_of("tail"), nullptr);
+            }
+            TestCheck(contents_of(m_file) == "head tail");
+
+            WriteSession truncating{ m_file, false };
+            TestCheck(contents_of(m_file).empty());
+        }
+
+        TEST_METHOD(TestOpen_missingFolder) {
+            bool failed{ false };
+            try
+            {
+                WriteSession session{ m_folder / L"missing" / L"session.txt", false };
+            }
+            catch (winrt::hresult_error const& ex)
+            {
+                failed = ex.code() == HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND);
+            }
+            TestCheck(failed);
+        }
+
+        TEST_METHOD(TestSweep_closesIdleSessions) {
+            WriteSessionTable table;
+            auto sessionId{ table.Add(std::make_shared<WriteSession>(m_file, false), std::chrono::seconds{ 10 }) };
+            auto later{ std::chrono::steady_clock::now() + std::chrono::minutes{ 1 } };
+
+            // A reserved chunk keeps the session open however long it takes to submit
+            auto lease{ table.Reserve(sessionId) };
+            TestCheck(lease.session != nullptr);
+            TestCheck(table.Sweep(later) == 0);
+            lease.session->Submit(lease.ticket, bytes_of("kept"), nullptr);
+            lease = {};
+
+            TestCheck(table.Sweep(std::chrono::steady_clock::now()) == 0);
+            TestCheck(table.Sweep(later) == 1);
+            TestCheck(table.Size() == 0);
+            TestCheck(table.Reserve(sessionId).session == nullptr);
+            TestCheck(contents_of(m_file) == "kept");
+
+            auto counters{ table.Snapshot() };
+            TestCheck(counters.opened == 1);
+            TestCheck(counters.expired == 1);
+        }
+
+        TEST_METHOD(TestRemove_closeFollowsChunks) {
+            WriteSessionTable table;
+            auto sessionId{ table.Add(std::make_shared<WriteSession>(m_file, false)) };
+            auto chunk{ table.Reserve(sessionId) };
+            auto close{ table.Remove(sessionId) };
+            TestCheck(table.Remove(sessionId).session == nullptr);
+
+            bool closed{ false };
+            close.session->SubmitClose(close.ticket, false, [&](winrt::hresult) { closed = true; });
+            TestCheck(!closed);
+            chunk.session->Submit(chunk.ticket, bytes_of("last words"), nullptr);
+            TestCheck(closed);
+            TestCheck(contents_of(m_file) == "last words");
+        }
+    };
+}
@@ -0,0 +1,317 @@
+#include "pch.h"
+
+#include "AppendCoalescer.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <winrt/Windows.System.Threading.h>
+
+using namespace winrt::Windows::System::Threading;
+
+struct AppendCoalescer::State
+{
+    mutable std::mutex mutex; // to protect everything below
+    Settings settings;
+    std::unordered_map<std::wstring, std::shared_ptr<Queue>> queues;
+    Counters counters;
+};
+
+struct AppendCoalescer::Queue
+{
+    struct Entry
+    {
+        std::vector<uint8_t> bytes;
+        Completion done;
+        std::chrono::steady_clock::time_point submitted;
+        bool skipped{ false };
+    };
+
+    explicit Queue(std::filesystem::path path) noexcept
+        : path{ std::move(path) }
+    {
+    }
+
+    std::filesystem::path const path;
+    std::mutex drainMutex; // held while a run is written, so one thread writes the path at a time
+
+    std::mutex mutex; // to protect everything below
+    Ticket nextTicket{ 0 };
+    Ticket nextToWrite{ 0 }; // the ticket whose append starts the next run
+    std::map<Ticket, Entry> ready; // submitted appends not written yet
+    ThreadPoolTimer timer{ nullptr }; // set while a run waits out the delay
+};
+
+// Appends the run's bytes to path with a single write
+static void write_run(std::filesystem::path const& path, std::vector<AppendCoalescer::Queue::Entry> const& run, size_t size)
+{
+    if (std::all_of(run.begin(), run.end(), [](auto const& entry) { return entry.skipped; }))
+    {
+        return;
+    }
+
+    std::vector<uint8_t> merged;
+    auto const* data{ run.front().bytes.data() };
+    if (run.size() > 1)
+    {
+        merged.reserve(size);
+        for (auto const& entry : run)
+        {
+            merged.insert(merged.end(), entry.bytes.begin(), entry.bytes.end());
+        }
+        data = merged.data();
+    }
+
+    winrt::file_handle file{ CreateFileW(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+    if (!file)
+    {
+        winrt::throw_last_error();
+    }
+    while (size > 0)
+    {
+        DWORD written{ 0 };
+        winrt::check_bool(WriteFile(file.get(), data, static_cast<DWORD>(std::min<size_t>(size, MAXDWORD)), &written, nullptr));
+        data += written;
+        size -= written;
+    }
+}
+
+AppendCoalescer::AppendCoalescer()
+    : m_state{ std::make_shared<State>() }
+{
+}
+
+AppendCoalescer::~AppendCoalescer() noexcept
+{
+    std::vector<std::shared_ptr<Queue>> queues;
+    {
+        std::lock_guard lock{ m_state->mutex };
+        for (auto const& [path, queue] : m_state->queues)
+        {
+            queues.push_back(queue);
+        }
+    }
+
+    for (auto const& queue : queues)
+    {
+        {
+            std::lock_guard lock{ queue->mutex };
+            if (queue->timer)
+            {
+                queue->timer.Cancel();
+                queue->timer = nullptr;
+            }
+        }
+        try
+        {
+            Drain(m_state, queue, true);
+        }
+        catch (...)
+        {
+            // Appends that could not be written were told so; nothing else is left to do
+        }
+    }
+}
+
+void AppendCoalescer::Configure(Settings settings) noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    m_state->settings = settings;
+}
+
+AppendCoalescer::Settings AppendCoalescer::Current() const noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    return m_state->settings;
+}
+
+AppendCoalescer::Lease AppendCoalescer::Reserve(std::filesystem::path const& path)
+{
+    std::lock_guard lock{ m_state->mutex };
+    auto& queue{ m_state->queues[path.wstring()] };
+    if (!queue)
+    {
+        queue = std::make_shared<Queue>(path);
+    }
+
+    std::lock_guard queueLock{ queue->mutex };
+    return { queue, queue->nextTicket++ };
+}
+
+void AppendCoalescer::Submit(Lease const& lease, std::vector<uint8_t> bytes, Completion done)
+{
+    Enqueue(m_state, lease, std::move(bytes), std::move(done), false);
+}
+
+void AppendCoalescer::Skip(Lease const& lease)
+{
+    Enqueue(m_state, lease, {}, nullptr, true);
+}
+
+void AppendCoalescer::Enqueue(std::shared_ptr<State> const& state, Lease const& lease, std::vector<uint8_t> bytes, Completion done, bool skipped)
+{
+    {
+        std::lock_guard lock{ lease.queue->mutex };
+        lease.queue->ready.emplace(lease.ticket, Queue::Entry{ std::move(bytes), std::move(done), std::chrono::steady_clock::now(), skipped });
+    }
+    Drain(state, lease.queue, false);
+}
+
+void AppendCoalescer::Drain(std::shared_ptr<State> const& state, std::shared_ptr<Queue> const& queue, bool now)
+{
+    for (;;)
+    {
+        bool delayed{ false };
+        {
+            // Whoever drains already will write our append too, or see it below once done
+            std::unique_lock drain{ queue->drainMutex, std::defer_lock };
+            if (now)
+            {
+                drain.lock();
+            }
+            else if (!drain.try_lock())
+            {
+                return;
+            }
+
+            for (;;)
+            {
+                Settings settings;
+                {
+                    std::lock_guard lock{ state->mutex };
+                    settings = state->settings;
+                }
+
+                std::vector<Queue::Entry> run;
+                size_t size{ 0 };
+                {
+                    std::lock_guard lock{ queue->mutex };
+                    auto ticket{ queue->nextToWrite };
+                    auto next{ queue->ready.find(ticket) };
+                    bool full{ false };
+                    for (; next != queue->ready.end() && next->first == ticket; ++next, ++ticket)
+                    {
+                        if (size > 0 && size + next->second.bytes.size() > settings.maxBytes)
+                        {
+                            full = true;
+                            break;
+                        }
+                        size += next->second.bytes.size();
+                    }
+                    if (ticket == queue->nextToWrite)
+                    {
+                        break;
+                    }
+
+                    // Give the first append's run until the delay is up to grow, unless it cannot grow any further
+                    auto first{ queue->ready.begin() };
+                    auto age{ std::chrono::steady_clock::now() - first->second.submitted };
+                    if (!now && !full && size < settings.maxBytes && age < settings.maxDelay)
+                    {
+                        if (!queue->timer)
+                        {
+                            auto delay{ std::chrono::duration_cast<winrt::Windows::Foundation::TimeSpan>(settings.maxDelay - age) };
+                            queue->timer = ThreadPoolTimer::CreateTimer([state, queue](ThreadPoolTimer const& timer)
+                                {
+                                    {
+                                        std::lock_guard lock{ queue->mutex };
+                                        if (queue->timer == timer)
+                                        {
+                                            queue->timer = nullptr;
+                                        }
+                                    }
+                                    Drain(state, queue, true);
+                                }, delay);
+                        }
+                        delayed = true;
+                        break;
+                    }
+
+                    for (; queue->nextToWrite != ticket; ++queue->nextToWrite)
+                    {
+                        auto entry{ queue->ready.find(queue->nextToWrite) };
+                        run.push_back(std::move(entry->second));
+                        queue->ready.erase(entry);
+                    }
+                    if (queue->timer)
+                    {
+                        queue->timer.Cancel();
+                        queue->timer = nullptr;
+                    }
+                }
+
+                winrt::hresult result;
+                try
+                {
+                    write_run(queue->path, run, size);
+                }
+                catch (winrt::hresult_error const& ex)
+                {
+                    result = ex.code();
+                }
+
+                {
+                    std::lock_guard lock{ state->mutex };
+                    state->counters.appends += static_cast<uint64_t>(std::count_if(run.begin(), run.end(), [](auto const& entry) { return !entry.skipped; }));
+                    state->counters.writes += result == S_OK ? 1 : 0;
+                    state->counters.bytes += result == S_OK ? size : 0;
+                }
+                for (auto& entry : run)
+                {
+                    if (entry.done)
+                    {
+                        entry.done(result);
+                    }
+                }
+            }
+        }
+
+        if (delayed)
+        {
+            return; // the timer takes it from here
+        }
+
+        // An append submitted while we were finishing found the drain mutex taken
+        {
+            std::lock_guard lock{ queue->mutex };
+            if (queue->ready.find(queue->nextToWrite) != queue->ready.end())
+            {
+                continue;
+            }
+        }
+        Forget(*state, queue);
+        return;
+    }
+}
+
+void AppendCoalescer::Forget(State& state, std::shared_ptr<Queue> const& queue) noexcept
+{
+    // A queue is dropped once nothing is reserved, waiting or timed; the next append starts a new one
+    std::lock_guard lock{ state.mutex };
+    std::lock_guard queueLock{ queue->mutex };
+    auto found{ state.queues.find(queue->path.wstring()) };
+    if (found != state.queues.end() && found->second == queue &&
+        queue->nextToWrite == queue->nextTicket && queue->ready.empty() && !queue->timer)
+    {
+        state.queues.erase(found);
+    }
+}
+
+size_t AppendCoalescer::Pending() const noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    return m_state->queues.size();
+}
+
+AppendCoalescer::Counters AppendCoalescer::Snapshot() const noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    return m_state->counters;
+}
+
+void AppendCoalescer::Reset() noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    m_state->counters = {};
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <winrt/Windows.Foundation.h>
+
+//
+// Group commit for appendFile. Appends to one path take a ticket when they
+// are called and submit their bytes once decoded; whoever submits writes the
+// run of submitted appends that is next in line as a single write under one
+// open handle, so appends arriving while a write is in flight are merged into
+// the next one and reach the file in call order. With a MaxDelay the first
+// append of a run waits up to that long for others to join it, unless MaxBytes
+// are queued already; a timer writes the run once the delay is up. An append
+// completes once its bytes are in the file, or with the error of its write.
+//
+struct AppendCoalescer final
+{
+    using Ticket = uint64_t;
+    using Completion = std::function<void(winrt::hresult)>;
+
+    struct Settings
+    {
+        std::chrono::milliseconds maxDelay{ 0 }; // 0 only merges appends that queue behind a write
+        size_t maxBytes{ DefaultMaxBytes }; // a run this large is written without waiting, and no run grows larger
+    };
+
+    struct Counters
+    {
+        uint64_t appends{ 0 };
+        uint64_t writes{ 0 };
+        uint64_t bytes{ 0 };
+    };
+
+    struct Queue; // the appends of one path
+
+    // A ticket of the path's queue
+    struct Lease
+    {
+        std::shared_ptr<Queue> queue;
+        Ticket ticket{ 0 };
+    };
+
+    static constexpr size_t DefaultMaxBytes = 1024 * 1024;
+
+    AppendCoalescer();
+    AppendCoalescer(AppendCoalescer const&) = delete;
+    AppendCoalescer& operator=(AppendCoalescer const&) = delete;
+
+    // Writes whatever was submitted and is still waiting
+    ~AppendCoalescer() noexcept;
+
+    void Configure(Settings settings) noexcept;
+    Settings Current() const noexcept;
+
+    Lease Reserve(std::filesystem::path const& path);
+
+    // `done` runs on the thread that wrote the bytes
+    void Submit(Lease const& lease, std::vector<uint8_t> bytes, Completion done);
+
+    // Gives up a ticket whose bytes could not be prepared
+    void Skip(Lease const& lease);
+
+    size_t Pending() const noexcept; // paths with appends not written yet
+    Counters Snapshot() const noexcept;
+    void Reset() noexcept;
+
+private:
+    struct State;
+
+    static void Enqueue(std::shared_ptr<State> const& state, Lease const& lease, std::vector<uint8_t> bytes, Completion done, bool skipped);
+    static void Drain(std::shared_ptr<State> const& state, std::shared_ptr<Queue> const& queue, bool now);
+    static void Forget(State& state, std::shared_ptr<Queue> const& queue) noexcept;
+
+    std::shared_ptr<State> m_state; // shared with the delay timers
+};
@@ -0,0 +1,144 @@
+#include "pch.h"
+
+#include "BandwidthLimiter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+BandwidthLimiter::Registration::Registration(BandwidthLimiter& limiter, JobId jobId) noexcept
+    : m_limiter{ &limiter },
+      m_jobId{ jobId }
+{
+}
+
+BandwidthLimiter::Registration::Registration(Registration&& other) noexcept
+    : m_limiter{ std::exchange(other.m_limiter, nullptr) },
+      m_jobId{ other.m_jobId }
+{
+}
+
+BandwidthLimiter::Registration::~Registration() noexcept
+{
+    if (m_limiter)
+    {
+        m_limiter->Remove(m_jobId);
+    }
+}
+
+BandwidthLimiter::Registration BandwidthLimiter::Track(JobId jobId, uint64_t maxBytesPerSecond) noexcept
+{
+    std::scoped_lock lock{ m_mutex };
+    auto& bucket{ m_buckets[jobId] };
+    auto adjusted{ m_jobLimits.find(jobId) };
+    bucket.limit = adjusted != m_jobLimits.end() ? adjusted->second : maxBytesPerSecond;
+    bucket.tokens = 0;
+    bucket.updated = std::chrono::steady_clock::now();
+    bucket.busyUntil = bucket.updated;
+    return Registration{ *this, jobId };
+}
+
+void BandwidthLimiter::SetGlobalLimit(uint64_t maxBytesPerSecond) noexcept
+{
+    std::scoped_lock lock{ m_mutex };
+    m_globalLimit = maxBytesPerSecond;
+}
+
+void BandwidthLimiter::SetJobLimit(JobId jobId, uint64_t maxBytesPerSecond) noexcept
+{
+    std::scoped_lock lock{ m_mutex };
+    if (auto it{ m_buckets.find(jobId) }; it != m_buckets.end())
+    {
+        it->second.limit = maxBytesPerSecond;
+    }
+    m_jobLimits[jobId] = maxBytesPerSecond;
+}
+
+void BandwidthLimiter::Forget(JobId jobId) noexcept
+{
+    std::scoped_lock lock{ m_mutex };
+    m_jobLimits.erase(jobId);
+}
+
+std::chrono::milliseconds BandwidthLimiter::Acquire(JobId jobId, uint64_t bytes) noexcept
+{
+    std::scoped_lock lock{ m_mutex };
+    auto it{ m_buckets.find(jobId) };
+    if (it == m_buckets.end())
+    {
+        return std::chrono::milliseconds{ 0 };
+    }
+
+    auto& bucket{ it->second };
+    auto const now{ std::chrono::steady_clock::now() };
+    auto const elapsed{ std::chrono::duration<double>(now - bucket.updated).count() };
+    bucket.updated = now;
+    bucket.busyUntil = std::max(bucket.busyUntil, now);
+
+    auto const rate{ RateOf(bucket, now) };
+    if (rate <= 0)
+    {
+        bucket.tokens = 0;
+        return std::chrono::milliseconds{ 0 };
+    }
+
+    // Bytes beyond the available tokens are borrowed and paid back by waiting
+    bucket.tokens = std::min(bucket.tokens + elapsed * rate, rate * BurstSeconds) - static_cast<double>(bytes);
+    if (bucket.tokens >= 0)
+    {
+        return std::chrono::milliseconds{ 0 };
+    }
+    std::chrono::milliseconds delay{ static_cast<int64_t>(std::ceil(-bucket.tokens / rate * 1000)) };
+    bucket.busyUntil = now + delay;
+    return delay;
+}
+
+void BandwidthLimiter::Remove(JobId jobId) noexcept
+{
+    std::scoped_lock lock{ m_mutex };
+    m_buckets.erase(jobId);
+}
+
+double BandwidthLimiter::RateOf(Bucket const& bucket, std::chrono::steady_clock::time_point now) const noexcept
+{
+    double rate{ 0 };
+    if (m_globalLimit > 0)
+    {
+        rate = GlobalShare(now);
+    }
+    if (bucket.limit > 0 && (rate == 0 || bucket.limit < rate))
+    {
+        rate = static_cast<double>(bucket.limit);
+    }
+    return rate;
+}
+
+double BandwidthLimiter::GlobalShare(std::chrono::steady_clock::time_point now) const noexcept
+{
+    // The limits of the jobs transferring, lowest first; 0 (none) sorts last
+    std::vector<uint64_t> limits;
+    for (auto const& [jobId, bucket] : m_buckets)
+    {
+        if (now - bucket.busyUntil < IdleAfter)
+        {
+            limits.push_back(bucket.limit > 0 ? bucket.limit : std::numeric_limits<uint64_t>::max());
+        }
+    }
+    std::sort(limits.begin(), limits.end());
+
+    // A job held below an equal share of what is left takes only its limit, and the others split the rest
+    auto remaining{ static_cast<double>(m_globalLimit) };
+    auto sharing{ limits.size() };
+    for (auto limit : limits)
+    {
+        if (static_cast<double>(limit) >= remaining / sharing)
+        {
+            break;
+        }
+        remaining -= static_cast<double>(limit);
+        --sharing;
+    }
+    return sharing > 0 ? remaining / sharing : remaining;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+//
+// Token buckets that pace downloads and uploads. Every tracked job has its own
+// bucket; its rate is the job's own limit, or its share of the global limit,
+// whichever is lower. The global limit is split among the jobs that are
+// actually transferring: one that has not taken any bytes for IdleAfter, such
+// as a job waiting out a retry delay, leaves its share to the others, and so
+// does the part of an equal share that a job's own lower limit keeps it from
+// using. Limits may change while jobs are running.
+//
+struct BandwidthLimiter final
+{
+    using JobId = int32_t;
+
+    // Keeps a job's bucket alive for the duration of a transfer
+    struct Registration final
+    {
+        Registration(BandwidthLimiter& limiter, JobId jobId) noexcept;
+        Registration(Registration&& other) noexcept;
+        Registration& operator=(Registration&&) = delete;
+        ~Registration() noexcept;
+
+    private:
+        BandwidthLimiter* m_limiter;
+        JobId m_jobId;
+    };
+
+    BandwidthLimiter() = default;
+    BandwidthLimiter(BandwidthLimiter const&) = delete;
+    BandwidthLimiter& operator=(BandwidthLimiter const&) = delete;
+
+    // maxBytesPerSecond 0 leaves the job limited only by its share of the global limit
+    [[nodiscard]] Registration Track(JobId jobId, uint64_t maxBytesPerSecond) noexcept;
+
+    // 0 removes the limit. A job limit wins over the one passed to Track, also
+    // when it is set before the job's transfer starts, until Forget is called.
+    void SetGlobalLimit(uint64_t maxBytesPerSecond) noexcept;
+    void SetJobLimit(JobId jobId, uint64_t maxBytesPerSecond) noexcept;
+
+    // Drops the limit set for a job once the job is gone, so a later job with the same id is not held to it
+    void Forget(JobId jobId) noexcept;
+
+    // Takes `bytes` from the job's bucket and returns how long to wait before
+    // transferring more so the job stays within its rate.
+    std::chrono::milliseconds Acquire(JobId jobId, uint64_t bytes) noexcept;
+
+private:
+    static constexpr double BurstSeconds = 0.25; // credit an idle job may build up
+    static constexpr std::chrono::seconds IdleAfter{ 1 }; // without taking bytes for this long a job stops counting towards the global limit
+
+    struct Bucket
+    {
+        uint64_t limit{ 0 };
+        double tokens{ 0 };
+        std::chrono::steady_clock::time_point updated;
+        std::chrono::steady_clock::time_point busyUntil; // when the wait asked for by the last Acquire ends
+    };
+
+    void Remove(JobId jobId) noexcept;
+    double RateOf(Bucket const& bucket, std::chrono::steady_clock::time_point now) const noexcept; // requires m_mutex
+    double GlobalShare(std::chrono::steady_clock::time_point now) const noexcept; // requires m_mutex
+
+    std::mutex m_mutex; // to protect everything below
+    uint64_t m_globalLimit{ 0 };
+    std::map<JobId, Bucket> m_buckets;
+    std::map<JobId, uint64_t> m_jobLimits; // limits set through SetJobLimit, which win over the ones passed to Track
+};
@@ -0,0 +1,204 @@
+#include "pch.h"
+
+#include "Deflate.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr int WindowBits{ 15 };           // 32K, the most DEFLATE allows
+    constexpr int GzipWindowBits{ 15 + 16 };  // same window, gzip framing
+    constexpr int MemLevel{ 9 };              // 32K symbols per block, so incompressible input costs few stored block headers
+    constexpr size_t OutputChunk{ 64 * 1024 };
+    constexpr size_t MaxPiece{ 1u << 30 };    // zlib counts in uInt, so larger inputs are fed in parts
+}
+
+StreamingInflater::StreamingInflater(Format format) noexcept
+    : m_format{ format }
+{
+}
+
+StreamingInflater::~StreamingInflater() noexcept
+{
+    if (m_started)
+    {
+        inflateEnd(&m_stream);
+    }
+}
+
+void StreamingInflater::Start(Format format)
+{
+    auto windowBits{ format == Format::Raw ? -WindowBits : format == Format::Zlib ? WindowBits : GzipWindowBits };
+    if (inflateInit2(&m_stream, windowBits) != Z_OK)
+    {
+        throw DeflateError("Cannot initialize zlib");
+    }
+    m_format = format;
+    m_started = true;
+}
+
+void StreamingInflater::Write(uint8_t const* data, size_t size, std::vector<uint8_t>& output)
+{
+    m_totalIn += size;
+    if (m_started)
+    {
+        Inflate(data, size, output);
+        return;
+    }
+    if (m_format != Format::Auto)
+    {
+        Start(m_format);
+        Inflate(data, size, output);
+        return;
+    }
+
+    // Two bytes tell a gzip magic number and a zlib header with a valid check from a bare stream
+    m_detect.insert(m_detect.end(), data, data + size);
+    if (m_detect.size() < 2)
+    {
+        return;
+    }
+    auto const header{ (m_detect[0] << 8) | m_detect[1] };
+    if (m_detect[0] == 0x1f && m_detect[1] == 0x8b)
+    {
+        Start(Format::Gzip);
+    }
+    else if ((m_detect[0] & 0x0f) == Z_DEFLATED && header % 31 == 0)
+    {
+        Start(Format::Zlib);
+    }
+    else
+    {
+        Start(Format::Raw);
+    }
+    auto const held{ std::move(m_detect) };
+    Inflate(held.data(), held.size(), output);
+}
+
+void StreamingInflater::Finish(std::vector<uint8_t>& output)
+{
+    if (!m_started)
+    {
+        // Auto given fewer than two bytes can only be looking at a bare stream
+        Start(m_format == Format::Auto ? Format::Raw : m_format);
+        auto const held{ std::move(m_detect) };
+        Inflate(held.data(), held.size(), output);
+    }
+    if (!m_done)
+    {
+        throw DeflateError("Unexpected end of compressed data");
+    }
+}
+
+void StreamingInflater::Inflate(uint8_t const* data, size_t size, std::vector<uint8_t>& output)
+{
+    while (size > 0)
+    {
+        if (m_done)
+        {
+            // Only gzip allows another member after the end of a stream
+            if (m_format != Format::Gzip)
+            {
+                throw DeflateError("Unexpected data after the end of the compressed stream");
+            }
+            inflateReset(&m_stream);
+            m_done = false;
+        }
+
+        auto const piece{ std::min(size, MaxPiece) };
+        m_stream.next_in = const_cast<Bytef*>(data);
+        m_stream.avail_in = static_cast<uInt>(piece);
+        do
+        {
+            auto const offset{ output.size() };
+            output.resize(offset + OutputChunk);
+            m_stream.next_out = output.data() + offset;
+            m_stream.avail_out = static_cast<uInt>(OutputChunk);
+            auto const result{ inflate(&m_stream, Z_NO_FLUSH) };
+            auto const produced{ OutputChunk - m_stream.avail_out };
+            output.resize(offset + produced);
+            m_totalOut += produced;
+
+            if (result == Z_STREAM_END)
+            {
+                m_done = true;
+                break;
+            }
+            if (result == Z_NEED_DICT)
+            {
+                throw DeflateError("Preset zlib dictionaries are not supported");
+            }
+            if (result != Z_OK && result != Z_BUF_ERROR)
+            {
+                throw DeflateError(m_stream.msg ? m_stream.msg : "Invalid compressed data");
+            }
+        } while (m_stream.avail_in > 0 || m_stream.avail_out == 0);
+
+        auto const consumed{ piece - m_stream.avail_in };
+        data += consumed;
+        size -= consumed;
+    }
+}
+
+StreamingDeflater::StreamingDeflater(Format format)
+{
+    auto windowBits{ format == Format::Raw ? -WindowBits : format == Format::Zlib ? WindowBits : GzipWindowBits };
+    if (deflateInit2(&m_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, MemLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw DeflateError("Cannot initialize zlib");
+    }
+}
+
+StreamingDeflater::~StreamingDeflater() noexcept
+{
+    deflateEnd(&m_stream);
+}
+
+void StreamingDeflater::Write(uint8_t const* data, size_t size, std::vector<uint8_t>& output)
+{
+    if (m_finished)
+    {
+        throw DeflateError("Write after Finish");
+    }
+    m_totalIn += size;
+    Deflate(data, size, Z_NO_FLUSH, output);
+}
+
+void StreamingDeflater::Finish(std::vector<uint8_t>& output)
+{
+    if (m_finished)
+    {
+        throw DeflateError("Finish called twice");
+    }
+    Deflate(nullptr, 0, Z_FINISH, output);
+    m_finished = true;
+}
+
+void StreamingDeflater::Deflate(uint8_t const* data, size_t size, int flush, std::vector<uint8_t>& output)
+{
+    do
+    {
+        auto const piece{ std::min(size, MaxPiece) };
+        m_stream.next_in = const_cast<Bytef*>(data);
+        m_stream.avail_in = static_cast<uInt>(piece);
+        auto const mode{ piece == size ? flush : Z_NO_FLUSH };
+        do
+        {
+            auto const offset{ output.size() };
+            output.resize(offset + OutputChunk);
+            m_stream.next_out = output.data() + offset;
+            m_stream.avail_out = static_cast<uInt>(OutputChunk);
+            auto const result{ deflate(&m_stream, mode) };
+            auto const produced{ OutputChunk - m_stream.avail_out };
+            output.resize(offset + produced);
+            m_totalOut += produced;
+            if (result == Z_STREAM_ERROR)
+            {
+                throw DeflateError("zlib stream error");
+            }
+        } while (m_stream.avail_out == 0);
+
+        data += piece;
+        size -= piece;
+    } while (size > 0);
+}
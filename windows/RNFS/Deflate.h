@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+
+//
+// Incremental DEFLATE (RFC 1951) decoding and encoding with optional zlib
+// (RFC 1950) and gzip (RFC 1952) framing, on top of zlib. Input may arrive in
+// arbitrarily sized pieces, as it does when reading an HTTP response body or a
+// file being uploaded; output is handed back as soon as zlib produces it.
+//
+struct DeflateError final : std::runtime_error
+{
+    using std::runtime_error::runtime_error;
+};
+
+struct StreamingInflater final
+{
+    enum class Format
+    {
+        Raw,  // bare deflate stream
+        Zlib, // 2 byte header, adler32 trailer
+        Gzip, // gzip members, crc32/size trailer
+        Auto, // detected from the first bytes: gzip, then zlib, otherwise raw
+    };
+
+    explicit StreamingInflater(Format format) noexcept;
+    ~StreamingInflater() noexcept;
+
+    // zlib's state points back at the stream, so it stays where it was made
+    StreamingInflater(StreamingInflater const&) = delete;
+    StreamingInflater& operator=(StreamingInflater const&) = delete;
+
+    // Consumes compressed bytes and appends any completed output to `output`.
+    // Throws DeflateError on corrupt input.
+    void Write(uint8_t const* data, size_t size, std::vector<uint8_t>& output);
+
+    // Signals the end of input, decoding everything still buffered. Throws
+    // DeflateError if the compressed stream is truncated.
+    void Finish(std::vector<uint8_t>& output);
+
+    uint64_t TotalIn() const noexcept { return m_totalIn; }
+    uint64_t TotalOut() const noexcept { return m_totalOut; }
+
+private:
+    void Start(Format format);
+    void Inflate(uint8_t const* data, size_t size, std::vector<uint8_t>& output);
+
+    Format m_format;
+    z_stream m_stream{};
+    bool m_started{ false };        // inflateInit2 ran, once the format is known
+    bool m_done{ false };           // the stream, or the last gzip member, ended
+    std::vector<uint8_t> m_detect;  // first bytes held back until Auto can tell the format
+
+    uint64_t m_totalIn{ 0 };
+    uint64_t m_totalOut{ 0 };
+};
+
+struct StreamingDeflater final
+{
+    enum class Format
+    {
+        Raw,  // bare deflate stream
+        Zlib, // 2 byte header, adler32 trailer
+        Gzip, // single gzip member, crc32/size trailer
+    };
+
+    explicit StreamingDeflater(Format format);
+    ~StreamingDeflater() noexcept;
+
+    StreamingDeflater(StreamingDeflater const&) = delete;
+    StreamingDeflater& operator=(StreamingDeflater const&) = delete;
+
+    // Consumes uncompressed bytes and appends whatever compressed output zlib
+    // has completed to `output`.
+    void Write(uint8_t const* data, size_t size, std::vector<uint8_t>& output);
+
+    // Compresses everything still buffered and appends the final block and
+    // trailer. The deflater cannot be written to afterwards.
+    void Finish(std::vector<uint8_t>& output);
+
+    uint64_t TotalIn() const noexcept { return m_totalIn; }
+    uint64_t TotalOut() const noexcept { return m_totalOut; }
+
+private:
+    void Deflate(uint8_t const* data, size_t size, int flush, std::vector<uint8_t>& output);
+
+    z_stream m_stream{};
+    bool m_finished{ false };
+
+    uint64_t m_totalIn{ 0 };
+    uint64_t m_totalOut{ 0 };
+};
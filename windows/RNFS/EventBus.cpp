@@ -0,0 +1,156 @@
+#include "pch.h"
+
+#include "EventBus.h"
+
+namespace RN = winrt::Microsoft::ReactNative;
+
+EventBus::EventBus(std::chrono::milliseconds interval)
+    : m_interval{ interval },
+      m_thread{ [this] { Run(); } }
+{
+}
+
+EventBus::~EventBus() noexcept
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        m_stopping = true;
+    }
+    m_posted.notify_all();
+    m_thread.join();
+}
+
+void EventBus::SetSink(Sink sink) noexcept
+{
+    {
+        std::lock_guard deliver{ m_deliverMutex };
+        m_sink = std::move(sink);
+    }
+    m_posted.notify_all();
+}
+
+void EventBus::Post(std::string name, RN::JSValueObject body)
+{
+    Enqueue(Event{ std::move(name), std::move(body) }, nullptr);
+}
+
+void EventBus::PostProgress(std::string name, JobId jobId, RN::JSValueObject body)
+{
+    Enqueue(Event{ std::move(name), std::move(body) }, &jobId);
+}
+
+void EventBus::Enqueue(Event event, JobId const* progressOf)
+{
+    m_postedCount.fetch_add(1, std::memory_order_relaxed);
+    bool wake{ false };
+    {
+        std::lock_guard lock{ m_mutex };
+        if (progressOf)
+        {
+            // The newer event goes to the back, so it still follows whatever the job posted in between
+            auto [it, added] { m_progress.try_emplace({ event.name, *progressOf }, m_queue.size()) };
+            if (!added)
+            {
+                auto& previous{ m_queue[it->second] };
+                previous.superseded = true;
+                previous.body = {};
+                it->second = m_queue.size();
+                --m_live;
+                m_supersededCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        m_queue.push_back(std::move(event));
+        ++m_live;
+        wake = m_live == 1 || m_live >= MaxBatch;
+    }
+    if (wake)
+    {
+        m_posted.notify_one();
+    }
+}
+
+void EventBus::Flush() noexcept
+{
+    Deliver();
+}
+
+bool EventBus::Deliver() noexcept
+{
+    std::lock_guard deliver{ m_deliverMutex };
+    if (!m_sink)
+    {
+        return false;
+    }
+
+    std::vector<Event> events;
+    {
+        std::lock_guard lock{ m_mutex };
+        events.swap(m_queue);
+        m_progress.clear();
+        m_live = 0;
+    }
+
+    RN::JSValueArray batch;
+    for (auto& event : events)
+    {
+        if (!event.superseded)
+        {
+            batch.push_back(RN::JSValueObject{ { "name", std::move(event.name) }, { "body", std::move(event.body) } });
+        }
+    }
+    if (!batch.empty())
+    {
+        m_deliveredCount.fetch_add(batch.size(), std::memory_order_relaxed);
+        m_batchCount.fetch_add(1, std::memory_order_relaxed);
+        m_sink(std::move(batch));
+    }
+    return true;
+}
+
+void EventBus::Run() noexcept
+{
+    std::unique_lock lock{ m_mutex };
+    for (;;)
+    {
+        m_posted.wait(lock, [this] { return m_stopping || m_live > 0; });
+        if (m_stopping)
+        {
+            return;
+        }
+
+        // Let the rest of the frame's events join the batch
+        m_posted.wait_for(lock, m_interval, [this] { return m_stopping || m_live >= MaxBatch; });
+        if (m_stopping)
+        {
+            return;
+        }
+
+        lock.unlock();
+        auto delivered{ Deliver() };
+        lock.lock();
+
+        // Without a sink the events stay queued; check again a frame later rather than spin
+        if (!delivered)
+        {
+            m_posted.wait_for(lock, m_interval, [this] { return m_stopping; });
+        }
+    }
+}
+
+EventBus::Counters EventBus::Snapshot() const noexcept
+{
+    Counters counters;
+    counters.posted = m_postedCount.load(std::memory_order_relaxed);
+    counters.superseded = m_supersededCount.load(std::memory_order_relaxed);
+    counters.delivered = m_deliveredCount.load(std::memory_order_relaxed);
+    counters.batches = m_batchCount.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void EventBus::Reset() noexcept
+{
+    m_postedCount.store(0, std::memory_order_relaxed);
+    m_supersededCount.store(0, std::memory_order_relaxed);
+    m_deliveredCount.store(0, std::memory_order_relaxed);
+    m_batchCount.store(0, std::memory_order_relaxed);
+}
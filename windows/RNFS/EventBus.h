@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "JSValue.h"
+
+//
+// Queues the module's JS events and hands everything queued to the sink as one
+// batch about once a frame, instead of one bridge call per event. A progress
+// event supersedes the job's previous one of the same name that has not been
+// delivered yet, so a batch carries at most one progress event per job and name
+// however fast the transfers report; other events are always delivered, in the
+// order they were posted. A batch is sent early once MaxBatch events are
+// queued. Nothing wakes up while no events are queued.
+//
+struct EventBus final
+{
+    using Sink = std::function<void(winrt::Microsoft::ReactNative::JSValueArray)>;
+    using JobId = int32_t;
+
+    struct Counters
+    {
+        uint64_t posted{ 0 };
+        uint64_t superseded{ 0 }; // progress events dropped for a newer one
+        uint64_t delivered{ 0 };
+        uint64_t batches{ 0 };
+    };
+
+    static constexpr std::chrono::milliseconds DefaultInterval{ 16 };
+    static constexpr size_t MaxBatch = 256;
+
+    explicit EventBus(std::chrono::milliseconds interval = DefaultInterval);
+    EventBus(EventBus const&) = delete;
+    EventBus& operator=(EventBus const&) = delete;
+
+    // Stops delivering; events still queued are dropped
+    ~EventBus() noexcept;
+
+    // Events posted before the sink is set wait for it
+    void SetSink(Sink sink) noexcept;
+
+    void Post(std::string name, winrt::Microsoft::ReactNative::JSValueObject body);
+    void PostProgress(std::string name, JobId jobId, winrt::Microsoft::ReactNative::JSValueObject body);
+
+    // Delivers whatever is queued right away, for instance before resolving
+    // the promise of a job whose final progress must reach JS first
+    void Flush() noexcept;
+
+    Counters Snapshot() const noexcept;
+    void Reset() noexcept;
+
+private:
+    struct Event
+    {
+        std::string name;
+        winrt::Microsoft::ReactNative::JSValueObject body;
+        bool superseded{ false };
+    };
+
+    void Enqueue(Event event, JobId const* progressOf);
+    bool Deliver() noexcept; // false while there is no sink
+    void Run() noexcept;
+
+    std::chrono::milliseconds const m_interval;
+
+    std::mutex m_deliverMutex; // held while a batch is taken and sent, so batches arrive in order
+    Sink m_sink; // guarded by m_deliverMutex
+
+    std::mutex m_mutex; // to protect everything below
+    std::condition_variable m_posted;
+    std::vector<Event> m_queue;
+    std::map<std::pair<std::string, JobId>, size_t> m_progress; // queued progress event of each job and name
+    size_t m_live{ 0 }; // events in m_queue that are not superseded
+    bool m_stopping{ false };
+
+    std::atomic<uint64_t> m_postedCount{ 0 };
+    std::atomic<uint64_t> m_supersededCount{ 0 };
+    std::atomic<uint64_t> m_deliveredCount{ 0 };
+    std::atomic<uint64_t> m_batchCount{ 0 };
+
+    std::thread m_thread; // declared last so it starts with everything above initialized
+};
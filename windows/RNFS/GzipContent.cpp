@@ -0,0 +1,166 @@
+#include "pch.h"
+
+#include "GzipContent.h"
+
+#include <algorithm>
+
+using namespace winrt;
+using namespace winrt::Windows::Foundation;
+using namespace winrt::Windows::Storage::Streams;
+using namespace winrt::Windows::Web::Http;
+using namespace winrt::Windows::Web::Http::Headers;
+
+namespace
+{
+    // The stream the inner content writes itself to; compressed blocks go on to the connection
+    struct CompressingOutputStream : implements<CompressingOutputStream, IOutputStream, IClosable>
+    {
+        CompressingOutputStream(IOutputStream const& target, std::atomic<uint64_t>& sourceBytesWritten)
+            : m_target{ target },
+              m_deflater{ StreamingDeflater::Format::Gzip },
+              m_sourceBytesWritten{ sourceBytesWritten }
+        {
+        }
+
+        IAsyncOperationWithProgress<uint32_t, uint32_t> WriteAsync(IBuffer buffer)
+        {
+            auto strong{ get_strong() };
+            auto const length{ buffer.Length() };
+
+            co_await resume_background();
+            std::vector<uint8_t> compressed;
+            m_deflater.Write(buffer.data(), length, compressed);
+            co_await SendAsync(std::move(compressed));
+            m_sourceBytesWritten += length;
+            co_return length;
+        }
+
+        IAsyncOperation<bool> FlushAsync()
+        {
+            auto strong{ get_strong() };
+            co_await WaitAsync();
+            co_return co_await m_target.FlushAsync();
+        }
+
+        void Close()
+        {
+            // The connection owns the target stream
+        }
+
+        // Writes the last block and trailer and returns the compressed size
+        IAsyncOperation<uint64_t> FinishAsync()
+        {
+            auto strong{ get_strong() };
+
+            co_await resume_background();
+            std::vector<uint8_t> compressed;
+            m_deflater.Finish(compressed);
+            co_await SendAsync(std::move(compressed));
+            co_await WaitAsync();
+            co_return m_deflater.TotalOut();
+        }
+
+    private:
+        // Hands a block to the connection once the previous one is written, and returns while it
+        // is still going out, so the caller can compress the next block in the meantime
+        IAsyncAction SendAsync(std::vector<uint8_t> bytes)
+        {
+            auto strong{ get_strong() };
+
+            co_await WaitAsync();
+            if (bytes.empty())
+            {
+                co_return;
+            }
+            Buffer block{ static_cast<uint32_t>(bytes.size()) };
+            std::copy(bytes.begin(), bytes.end(), block.data());
+            block.Length(static_cast<uint32_t>(bytes.size()));
+            m_sending = m_target.WriteAsync(block);
+        }
+
+        IAsyncAction WaitAsync()
+        {
+            auto strong{ get_strong() };
+
+            if (auto sending{ std::exchange(m_sending, nullptr) })
+            {
+                co_await sending;
+            }
+        }
+
+        IOutputStream m_target;
+        StreamingDeflater m_deflater;
+        std::atomic<uint64_t>& m_sourceBytesWritten;
+        IAsyncOperationWithProgress<uint32_t, uint32_t> m_sending{ nullptr }; // the block being written
+    };
+}
+
+GzipContent::GzipContent(IHttpContent const& inner)
+    : m_inner{ inner }
+{
+    // The inner content's type (with the multipart boundary) and disposition describe the decoded body
+    for (auto const& header : inner.Headers())
+    {
+        if (header.Key() != L"Content-Length")
+        {
+            m_headers.TryAppendWithoutValidation(header.Key(), header.Value());
+        }
+    }
+    m_headers.TryAppendWithoutValidation(L"Content-Encoding", L"gzip");
+}
+
+HttpContentHeaderCollection GzipContent::Headers() const noexcept
+{
+    return m_headers;
+}
+
+IAsyncOperationWithProgress<uint64_t, uint64_t> GzipContent::BufferAllAsync()
+{
+    // Nothing is buffered; the body is compressed while it is written
+    co_return 0;
+}
+
+IAsyncOperationWithProgress<IBuffer, uint64_t> GzipContent::ReadAsBufferAsync()
+{
+    auto strong{ get_strong() };
+
+    InMemoryRandomAccessStream stream;
+    co_await WriteToStreamAsync(stream);
+    auto const size{ static_cast<uint32_t>(stream.Size()) };
+    Buffer buffer{ size };
+    co_return co_await stream.GetInputStreamAt(0).ReadAsync(buffer, size, InputStreamOptions::None);
+}
+
+IAsyncOperationWithProgress<IInputStream, uint64_t> GzipContent::ReadAsInputStreamAsync()
+{
+    auto strong{ get_strong() };
+
+    InMemoryRandomAccessStream stream;
+    co_await WriteToStreamAsync(stream);
+    co_return stream.GetInputStreamAt(0);
+}
+
+IAsyncOperationWithProgress<hstring, uint64_t> GzipContent::ReadAsStringAsync()
+{
+    throw hresult_illegal_method_call(L"Compressed content is not text");
+}
+
+bool GzipContent::TryComputeLength(uint64_t& length) noexcept
+{
+    length = 0;
+    return false;
+}
+
+IAsyncOperationWithProgress<uint64_t, uint64_t> GzipContent::WriteToStreamAsync(IOutputStream outputStream)
+{
+    auto strong{ get_strong() };
+
+    auto compressing{ make_self<CompressingOutputStream>(outputStream, m_sourceBytesWritten) };
+    co_await m_inner.WriteToStreamAsync(compressing.as<IOutputStream>());
+    co_return co_await compressing->FinishAsync();
+}
+
+void GzipContent::Close()
+{
+    m_inner.Close();
+}
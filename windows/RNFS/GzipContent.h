@@ -0,0 +1,37 @@
+#pragma once
+#include "Deflate.h"
+#include <atomic>
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.Storage.Streams.h>
+#include <winrt/Windows.Web.Http.h>
+#include <winrt/Windows.Web.Http.Headers.h>
+
+//
+// Request content that gzip-compresses another one as it is sent, for request
+// bodies. The whole body is compressed and the request carries a top-level
+// Content-Encoding: gzip, which servers decode before parsing a multipart body.
+// The compressed size is not known up front, so the body goes out chunked. Each
+// block is compressed on the thread pool while the previous one is being sent.
+//
+struct GzipContent : winrt::implements<GzipContent, winrt::Windows::Web::Http::IHttpContent, winrt::Windows::Foundation::IClosable>
+{
+    explicit GzipContent(winrt::Windows::Web::Http::IHttpContent const& inner);
+
+    winrt::Windows::Web::Http::Headers::HttpContentHeaderCollection Headers() const noexcept;
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<uint64_t, uint64_t> BufferAllAsync();
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Windows::Storage::Streams::IBuffer, uint64_t> ReadAsBufferAsync();
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Windows::Storage::Streams::IInputStream, uint64_t> ReadAsInputStreamAsync();
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::hstring, uint64_t> ReadAsStringAsync();
+    bool TryComputeLength(uint64_t& length) noexcept;
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<uint64_t, uint64_t> WriteToStreamAsync(
+        winrt::Windows::Storage::Streams::IOutputStream outputStream);
+    void Close();
+
+    // Uncompressed bytes of the inner content sent so far, callable from any thread
+    uint64_t SourceBytesWritten() const noexcept { return m_sourceBytesWritten; }
+
+private:
+    winrt::Windows::Web::Http::IHttpContent m_inner;
+    winrt::Windows::Web::Http::Headers::HttpContentHeaderCollection m_headers;
+    std::atomic<uint64_t> m_sourceBytesWritten{ 0 };
+};
@@ -0,0 +1,70 @@
+#include "pch.h"
+
+#include "HttpClientPool.h"
+
+#include <winrt/Windows.Web.Http.Filters.h>
+#include <winrt/Windows.Web.Http.Headers.h>
+
+using namespace winrt::Windows::Web::Http;
+
+std::optional<TransferPriority> ParseTransferPriority(std::string_view name) noexcept
+{
+    if (name.empty() || name == "normal")
+    {
+        return TransferPriority::Normal;
+    }
+    else if (name == "interactive")
+    {
+        return TransferPriority::Interactive;
+    }
+    else if (name == "background")
+    {
+        return TransferPriority::Background;
+    }
+    return std::nullopt;
+}
+
+HttpClientPool::HttpClientPool() noexcept
+{
+    m_settings[static_cast<size_t>(TransferPriority::Interactive)].maxConnectionsPerServer = 8;
+    m_settings[static_cast<size_t>(TransferPriority::Background)].maxConnectionsPerServer = 2;
+}
+
+HttpClient HttpClientPool::Get(TransferPriority priority)
+{
+    std::scoped_lock lock{ m_mutex };
+    auto& client{ m_clients[static_cast<size_t>(priority)] };
+    if (!client)
+    {
+        auto const& settings{ m_settings[static_cast<size_t>(priority)] };
+
+        Filters::HttpBaseProtocolFilter filter;
+        filter.MaxConnectionsPerServer(settings.maxConnectionsPerServer);
+        filter.MaxVersion(settings.preferHttp2 ? HttpVersion::Http20 : HttpVersion::Http11);
+        if (settings.bypassCache)
+        {
+            filter.CacheControl().ReadBehavior(Filters::HttpCacheReadBehavior::NoCache);
+            filter.CacheControl().WriteBehavior(Filters::HttpCacheWriteBehavior::NoCache);
+        }
+
+        client = HttpClient{ filter };
+        if (!settings.keepAlive)
+        {
+            client.DefaultRequestHeaders().Connection().TryParseAdd(L"close");
+        }
+    }
+    return client;
+}
+
+HttpClientSettings HttpClientPool::Settings(TransferPriority priority) noexcept
+{
+    std::scoped_lock lock{ m_mutex };
+    return m_settings[static_cast<size_t>(priority)];
+}
+
+void HttpClientPool::Configure(TransferPriority priority, HttpClientSettings const& settings) noexcept
+{
+    std::scoped_lock lock{ m_mutex };
+    m_settings[static_cast<size_t>(priority)] = settings;
+    m_clients[static_cast<size_t>(priority)] = nullptr; // rebuilt with the new settings on next use
+}
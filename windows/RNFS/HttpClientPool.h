@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <winrt/Windows.Web.Http.h>
+
+enum class TransferPriority
+{
+    Interactive, // user is waiting on it
+    Normal,
+    Background,  // prefetch and sync that must not crowd out the others
+};
+
+std::optional<TransferPriority> ParseTransferPriority(std::string_view name) noexcept;
+
+struct HttpClientSettings
+{
+    uint32_t maxConnectionsPerServer{ 6 };
+    bool preferHttp2{ true }; // negotiate HTTP/2 so requests to one host share a connection
+    bool bypassCache{ true }; // skip the WinINet cache; downloads have their own
+    bool keepAlive{ true };   // false asks servers to close each connection after its response
+};
+
+//
+// One HttpClient per priority class, each over its own protocol filter so the
+// classes have separate connection limits. Reconfiguring a class replaces its
+// client; requests already in flight finish on the old one.
+//
+struct HttpClientPool final
+{
+    HttpClientPool() noexcept;
+
+    HttpClientPool(HttpClientPool const&) = delete;
+    HttpClientPool& operator=(HttpClientPool const&) = delete;
+
+    winrt::Windows::Web::Http::HttpClient Get(TransferPriority priority);
+
+    HttpClientSettings Settings(TransferPriority priority) noexcept;
+    void Configure(TransferPriority priority, HttpClientSettings const& settings) noexcept;
+
+private:
+    static constexpr size_t ClassCount = 3;
+
+    std::mutex m_mutex; // to protect m_settings and m_clients
+    std::array<HttpClientSettings, ClassCount> m_settings;
+    std::array<winrt::Windows::Web::Http::HttpClient, ClassCount> m_clients{ nullptr, nullptr, nullptr };
+};
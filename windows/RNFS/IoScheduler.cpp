@@ -0,0 +1,236 @@
+#include "pch.h"
+
+#include "IoScheduler.h"
+
+#include <algorithm>
+
+using Clock = std::chrono::steady_clock;
+
+struct IoScheduler::State
+{
+    struct Lane
+    {
+        std::deque<Awaiter*> waiting; // guarded by State::mutex
+        std::atomic<uint64_t> queued{ 0 };
+        std::atomic<uint64_t> scheduled{ 0 };
+        std::atomic<uint64_t> totalWaitMicroseconds{ 0 };
+        std::atomic<uint64_t> maxWaitMicroseconds{ 0 };
+        std::array<std::atomic<uint64_t>, OperationStats::LatencyBuckets> wait{};
+    };
+
+    explicit State(uint32_t workers) noexcept : workers{ workers } {}
+
+    // Operations of a lane are only admitted while fewer than this many slots are taken
+    uint32_t Limit(size_t lane) const noexcept
+    {
+        switch (static_cast<TransferPriority>(lane))
+        {
+        case TransferPriority::Interactive:
+            return workers;
+        case TransferPriority::Normal:
+            return std::max(workers - 1, 1u);
+        default:
+            return std::max(workers / 2, 1u);
+        }
+    }
+
+    // Takes the next operation to admit off its queue, if any may run now; requires mutex
+    Awaiter* Pick(Clock::time_point now) noexcept
+    {
+        std::deque<Awaiter*>* from{ nullptr };
+        for (size_t lane = 0; lane < LaneCount; ++lane)
+        {
+            auto& waiting{ lanes[lane].waiting };
+            if (!waiting.empty() && busy < Limit(lane) && now - waiting.front()->queued >= StarvationLimit &&
+                (!from || waiting.front()->queued < from->front()->queued))
+            {
+                from = &waiting;
+            }
+        }
+        for (size_t lane = 0; lane < LaneCount && !from; ++lane)
+        {
+            if (!lanes[lane].waiting.empty() && busy < Limit(lane))
+            {
+                from = &lanes[lane].waiting;
+            }
+        }
+        if (!from)
+        {
+            return nullptr;
+        }
+
+        auto next{ from->front() };
+        from->pop_front();
+        ++busy;
+        return next;
+    }
+
+    uint32_t const workers;
+    std::mutex mutex; // to protect the lanes' queues, busy and stopping
+    std::condition_variable changed;
+    std::array<Lane, LaneCount> lanes;
+    uint32_t busy{ 0 };
+    bool stopping{ false };
+};
+
+IoScheduler::Slot::Slot(std::shared_ptr<State> state) noexcept
+    : m_state{ std::move(state) }
+{
+}
+
+IoScheduler::Slot::~Slot() noexcept
+{
+    if (m_state)
+    {
+        {
+            std::lock_guard lock{ m_state->mutex };
+            --m_state->busy;
+        }
+        m_state->changed.notify_one();
+    }
+}
+
+bool IoScheduler::Awaiter::await_suspend(std::experimental::coroutine_handle<> coroutine)
+{
+    handle = coroutine;
+    queued = Clock::now();
+
+    // A worker may resume the coroutine, and end this awaiter, as soon as the lock is released
+    auto shared{ state };
+    auto& lane{ shared->lanes[static_cast<size_t>(priority)] };
+    {
+        std::lock_guard lock{ shared->mutex };
+        if (shared->stopping)
+        {
+            return false;
+        }
+        lane.waiting.push_back(this);
+        lane.queued.fetch_add(1, std::memory_order_relaxed);
+    }
+    shared->changed.notify_one();
+    return true;
+}
+
+IoScheduler::Slot IoScheduler::Awaiter::await_resume()
+{
+    if (!admitted)
+    {
+        throw winrt::hresult_canceled();
+    }
+    return Slot{ std::move(state) };
+}
+
+IoScheduler::IoScheduler(uint32_t workers)
+    : m_state{ std::make_shared<State>(std::max(workers, 1u)) }
+{
+    for (uint32_t i = 0; i < m_state->workers; ++i)
+    {
+        m_workers.emplace_back([this] { Run(); });
+    }
+}
+
+IoScheduler::~IoScheduler() noexcept
+{
+    {
+        std::lock_guard lock{ m_state->mutex };
+        m_state->stopping = true;
+    }
+    m_state->changed.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+
+    std::vector<Awaiter*> abandoned;
+    {
+        std::lock_guard lock{ m_state->mutex };
+        for (auto& lane : m_state->lanes)
+        {
+            abandoned.insert(abandoned.end(), lane.waiting.begin(), lane.waiting.end());
+            lane.queued.fetch_sub(lane.waiting.size(), std::memory_order_relaxed);
+            lane.waiting.clear();
+        }
+    }
+    for (auto awaiter : abandoned)
+    {
+        awaiter->handle();
+    }
+}
+
+uint32_t IoScheduler::DefaultWorkers() noexcept
+{
+    // Enough slots to keep a disk's queue busy without letting every caller through
+    return std::clamp(std::thread::hardware_concurrency() * 2, 4u, 16u);
+}
+
+IoScheduler::Awaiter IoScheduler::Schedule(TransferPriority priority) noexcept
+{
+    return Awaiter{ m_state, priority };
+}
+
+uint32_t IoScheduler::Workers() const noexcept
+{
+    return m_state->workers;
+}
+
+void IoScheduler::Run() noexcept
+{
+    SetThreadDescription(GetCurrentThread(), L"RNFS I/O");
+    auto& state{ *m_state };
+    for (;;)
+    {
+        Awaiter* next{ nullptr };
+        {
+            std::unique_lock lock{ state.mutex };
+            state.changed.wait(lock, [&] { return state.stopping || (next = state.Pick(Clock::now())) != nullptr; });
+            if (!next)
+            {
+                return;
+            }
+        }
+
+        // The awaiter lives in the coroutine's frame, so finish with it before resuming
+        auto& lane{ state.lanes[static_cast<size_t>(next->priority)] };
+        auto micros{ static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - next->queued).count()) };
+        lane.queued.fetch_sub(1, std::memory_order_relaxed);
+        lane.scheduled.fetch_add(1, std::memory_order_relaxed);
+        lane.totalWaitMicroseconds.fetch_add(micros, std::memory_order_relaxed);
+        lane.wait[OperationStats::Bucket(micros)].fetch_add(1, std::memory_order_relaxed);
+        auto max{ lane.maxWaitMicroseconds.load(std::memory_order_relaxed) };
+        while (micros > max && !lane.maxWaitMicroseconds.compare_exchange_weak(max, micros, std::memory_order_relaxed))
+        {
+        }
+
+        next->admitted = true;
+        next->handle();
+    }
+}
+
+IoScheduler::LaneStats IoScheduler::Snapshot(TransferPriority priority) const noexcept
+{
+    auto const& lane{ m_state->lanes[static_cast<size_t>(priority)] };
+    LaneStats stats;
+    stats.scheduled = lane.scheduled.load(std::memory_order_relaxed);
+    stats.queued = lane.queued.load(std::memory_order_relaxed);
+    stats.totalWaitMicroseconds = lane.totalWaitMicroseconds.load(std::memory_order_relaxed);
+    stats.maxWaitMicroseconds = lane.maxWaitMicroseconds.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < stats.wait.size(); ++i)
+    {
+        stats.wait[i] = lane.wait[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void IoScheduler::Reset() noexcept
+{
+    for (auto& lane : m_state->lanes)
+    {
+        lane.scheduled.store(0, std::memory_order_relaxed);
+        lane.totalWaitMicroseconds.store(0, std::memory_order_relaxed);
+        lane.maxWaitMicroseconds.store(0, std::memory_order_relaxed);
+        for (auto& count : lane.wait)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <experimental/coroutine>
+#include "HttpClientPool.h"
+#include "OperationStats.h"
+
+//
+// Admits the module's file operations onto a fixed number of worker threads,
+// interactive ones before normal and normal before background. An operation
+// awaits Schedule, which queues it in the lane of its priority; a worker picks
+// it once a slot is free and resumes it. The operation holds its Slot until it
+// finishes, also while it awaits WinRT I/O completing on other threads, so the
+// number of operations running at once is bounded by the worker count.
+//
+// Normal operations may take all slots but one and background ones half of
+// them, so a burst of bulk copies never leaves a read waiting for a whole copy
+// to finish. A queued operation older than StarvationLimit goes before the
+// lanes above it, as far as its lane's share allows.
+//
+struct IoScheduler final
+{
+    struct State;
+
+    // Frees the slot an operation runs in when it goes out of scope
+    struct Slot final
+    {
+        explicit Slot(std::shared_ptr<State> state) noexcept;
+        Slot(Slot&& other) noexcept = default;
+        Slot& operator=(Slot&&) = delete;
+        ~Slot() noexcept;
+
+    private:
+        std::shared_ptr<State> m_state;
+    };
+
+    struct Awaiter final
+    {
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::experimental::coroutine_handle<> coroutine);
+        Slot await_resume(); // throws hresult_canceled when the scheduler shut down first
+
+        std::shared_ptr<State> state;
+        TransferPriority priority;
+        std::experimental::coroutine_handle<> handle{};
+        std::chrono::steady_clock::time_point queued{};
+        bool admitted{ false };
+    };
+
+    struct LaneStats
+    {
+        uint64_t scheduled{ 0 };   // operations admitted
+        uint64_t queued{ 0 };      // operations waiting right now
+        uint64_t totalWaitMicroseconds{ 0 };
+        uint64_t maxWaitMicroseconds{ 0 };
+        OperationStats::Histogram wait{}; // queue wait, bucketed like the latencies of OperationStats
+    };
+
+    static constexpr size_t LaneCount = 3;
+    static constexpr std::chrono::milliseconds StarvationLimit{ 500 };
+
+    explicit IoScheduler(uint32_t workers = DefaultWorkers());
+    IoScheduler(IoScheduler const&) = delete;
+    IoScheduler& operator=(IoScheduler const&) = delete;
+
+    // Stops the workers; operations still queued resume on this thread and throw hresult_canceled
+    ~IoScheduler() noexcept;
+
+    static uint32_t DefaultWorkers() noexcept;
+
+    // co_await m_io.Schedule(priority) resumes on a worker and yields the operation's Slot
+    Awaiter Schedule(TransferPriority priority) noexcept;
+
+    uint32_t Workers() const noexcept;
+    LaneStats Snapshot(TransferPriority priority) const noexcept;
+
+    // Zeroes everything but the queue lengths
+    void Reset() noexcept;
+
+private:
+    void Run() noexcept;
+
+    std::shared_ptr<State> m_state;
+    std::vector<std::thread> m_workers;
+};
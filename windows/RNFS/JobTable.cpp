@@ -0,0 +1,196 @@
+#include "pch.h"
+
+#include "JobTable.h"
+#include "TestHooks.h"
+
+#include <mutex>
+#include <utility>
+
+using namespace winrt::Windows::Foundation;
+
+static void cancel_action(IAsyncAction const& action) noexcept
+{
+    if (action && action.Status() == AsyncStatus::Started)
+    {
+        action.Cancel();
+    }
+}
+
+JobTable::Job::Job(JobId id) noexcept
+    : m_id{ id }
+{
+}
+
+JobTable::JobId JobTable::Job::Id() const noexcept
+{
+    return m_id;
+}
+
+JobState JobTable::Job::State() const noexcept
+{
+    return m_state.load(std::memory_order_acquire);
+}
+
+void JobTable::Job::SetState(JobState state) noexcept
+{
+    m_state.store(state, std::memory_order_release);
+}
+
+bool JobTable::Job::Cancelled() const noexcept
+{
+    return m_cancelled.load(std::memory_order_acquire);
+}
+
+uint64_t JobTable::Job::BytesTransferred() const noexcept
+{
+    return m_bytesTransferred.load(std::memory_order_relaxed);
+}
+
+uint64_t JobTable::Job::BytesExpected() const noexcept
+{
+    return m_bytesExpected.load(std::memory_order_relaxed);
+}
+
+void JobTable::Job::Progress(uint64_t transferred, uint64_t expected) noexcept
+{
+    m_bytesExpected.store(expected, std::memory_order_relaxed);
+    Progress(transferred);
+}
+
+void JobTable::Job::Progress(uint64_t transferred) noexcept
+{
+    m_bytesTransferred.store(transferred, std::memory_order_relaxed);
+#ifdef RNFS_TEST_HOOKS
+    if (TestHooks::JobProgress)
+    {
+        TestHooks::JobProgress(m_id);
+    }
+#endif
+}
+
+JobTable::~JobTable() noexcept
+{
+    // Cancel whatever is still running while the transfers can still use the
+    // members of the module declared before this table
+    for (auto& shard : m_shards)
+    {
+        std::unordered_map<JobId, std::shared_ptr<Job>> jobs;
+        {
+            std::unique_lock lock{ shard.mutex };
+            jobs.swap(shard.jobs);
+        }
+        for (auto& [jobId, job] : jobs)
+        {
+            cancel_action(std::exchange(job->m_action, nullptr));
+        }
+    }
+}
+
+JobTable::Shard& JobTable::ShardOf(JobId jobId) noexcept
+{
+    // Job ids are handed out in sequence, so consecutive jobs land in different shards
+    return m_shards[static_cast<uint32_t>(jobId) % ShardCount];
+}
+
+JobTable::Shard const& JobTable::ShardOf(JobId jobId) const noexcept
+{
+    return m_shards[static_cast<uint32_t>(jobId) % ShardCount];
+}
+
+std::shared_ptr<JobTable::Job> JobTable::Add(JobId jobId)
+{
+    auto& shard{ ShardOf(jobId) };
+    std::unique_lock lock{ shard.mutex };
+    auto& job{ shard.jobs[jobId] };
+    if (!job)
+    {
+        job = std::make_shared<Job>(jobId);
+    }
+    return job;
+}
+
+IAsyncAction JobTable::Start(std::shared_ptr<Job> const& job, IAsyncAction const& action) noexcept
+{
+    {
+        std::unique_lock lock{ ShardOf(job->m_id).mutex };
+        if (!job->Cancelled())
+        {
+            job->m_action = action;
+            job->SetState(JobState::Running);
+            return action;
+        }
+    }
+
+    // Cancelled while it was being prepared
+    cancel_action(action);
+    return action;
+}
+
+std::shared_ptr<JobTable::Job> JobTable::Find(JobId jobId) const noexcept
+{
+    auto const& shard{ ShardOf(jobId) };
+    std::shared_lock lock{ shard.mutex };
+    auto it{ shard.jobs.find(jobId) };
+    return it != shard.jobs.end() ? it->second : nullptr;
+}
+
+std::vector<std::shared_ptr<JobTable::Job>> JobTable::Jobs() const
+{
+    std::vector<std::shared_ptr<Job>> jobs;
+    for (auto const& shard : m_shards)
+    {
+        std::shared_lock lock{ shard.mutex };
+        for (auto const& [jobId, job] : shard.jobs)
+        {
+            jobs.push_back(job);
+        }
+    }
+    return jobs;
+}
+
+void JobTable::Cancel(JobId jobId) noexcept
+{
+    IAsyncAction action{ nullptr };
+    {
+        auto& shard{ ShardOf(jobId) };
+        std::unique_lock lock{ shard.mutex };
+        auto it{ shard.jobs.find(jobId) };
+        if (it == shard.jobs.end())
+        {
+            return;
+        }
+
+        auto& job{ *it->second };
+        job.m_cancelled.store(true, std::memory_order_release);
+        job.SetState(JobState::Done);
+        action = std::move(job.m_action);
+        shard.jobs.erase(it);
+    }
+
+    // The action may complete on this thread, so cancel it outside of the lock
+    cancel_action(action);
+}
+
+void JobTable::Remove(JobId jobId) noexcept
+{
+    auto& shard{ ShardOf(jobId) };
+    std::unique_lock lock{ shard.mutex };
+    if (auto it{ shard.jobs.find(jobId) }; it != shard.jobs.end())
+    {
+        // The action's coroutine holds the job, so let go of the action to let both be freed
+        it->second->m_action = nullptr;
+        it->second->SetState(JobState::Done);
+        shard.jobs.erase(it);
+    }
+}
+
+size_t JobTable::Size() const noexcept
+{
+    size_t size{ 0 };
+    for (auto const& shard : m_shards)
+    {
+        std::shared_lock lock{ shard.mutex };
+        size += shard.jobs.size();
+    }
+    return size;
+}
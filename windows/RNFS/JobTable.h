@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include <winrt/Windows.Foundation.h>
+
+enum class JobState : uint8_t
+{
+    Queued,  // registered, still preparing its request
+    Running,
+    Paused,  // waiting out a retry delay
+    Done,
+};
+
+//
+// Downloads, uploads and fetches in progress, by job id. Jobs are spread over
+// a fixed number of shards, each a hash map behind its own reader/writer lock,
+// so looking one up is O(1) and jobs in different shards never wait for each
+// other; the shard lock is only held to add, find or remove an entry. A job's
+// state and byte counts are atomics of the job itself, which the transfer
+// updates and anyone holding the job reads without touching the table.
+//
+// A job is added before its request is built, so stopDownload and stopUpload
+// also cancel jobs that have not started yet: Start then cancels the action
+// right away.
+//
+struct JobTable final
+{
+    using JobId = int32_t;
+
+    struct Job final
+    {
+        explicit Job(JobId id) noexcept;
+        Job(Job const&) = delete;
+        Job& operator=(Job const&) = delete;
+
+        JobId Id() const noexcept;
+        JobState State() const noexcept;
+        void SetState(JobState state) noexcept;
+        bool Cancelled() const noexcept;
+
+        uint64_t BytesTransferred() const noexcept;
+        uint64_t BytesExpected() const noexcept; // 0 while unknown
+        void Progress(uint64_t transferred, uint64_t expected) noexcept;
+        void Progress(uint64_t transferred) noexcept;
+
+    private:
+        friend JobTable;
+
+        JobId const m_id;
+        std::atomic<JobState> m_state{ JobState::Queued };
+        std::atomic<bool> m_cancelled{ false };
+        std::atomic<uint64_t> m_bytesTransferred{ 0 };
+        std::atomic<uint64_t> m_bytesExpected{ 0 };
+        winrt::Windows::Foundation::IAsyncAction m_action{ nullptr }; // guarded by the lock of the job's shard
+    };
+
+    JobTable() = default;
+    ~JobTable() noexcept;
+
+    JobTable(JobTable const&) = delete;
+    JobTable& operator=(JobTable const&) = delete;
+
+    // Registers a queued job, or returns the one already registered under jobId
+    std::shared_ptr<Job> Add(JobId jobId);
+
+    // Marks the job running on `action` and returns the action, cancelled already if the job was
+    winrt::Windows::Foundation::IAsyncAction Start(std::shared_ptr<Job> const& job,
+        winrt::Windows::Foundation::IAsyncAction const& action) noexcept;
+
+    std::shared_ptr<Job> Find(JobId jobId) const noexcept;
+
+    // Every registered job, in no particular order; each shard is locked only while it is copied
+    std::vector<std::shared_ptr<Job>> Jobs() const;
+
+    // Cancels the job's action if it is still running and forgets the job
+    void Cancel(JobId jobId) noexcept;
+
+    // Marks a finished job done and forgets it
+    void Remove(JobId jobId) noexcept;
+
+    size_t Size() const noexcept;
+
+private:
+    static constexpr size_t ShardCount = 64;
+
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<JobId, std::shared_ptr<Job>> jobs;
+    };
+
+    Shard& ShardOf(JobId jobId) noexcept;
+    Shard const& ShardOf(JobId jobId) const noexcept;
+
+    std::array<Shard, ShardCount> m_shards;
+};
@@ -0,0 +1,208 @@
+#include "pch.h"
+
+#include "OperationStats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef RNFS_TRACELOGGING
+#include <TraceLoggingProvider.h>
+
+// {6f1b3c52-8d0e-4a7b-9c4f-2e5d7a1b8c93}
+TRACELOGGING_DEFINE_PROVIDER(g_traceProvider, "ReactNativeFS",
+    (0x6f1b3c52, 0x8d0e, 0x4a7b, 0x9c, 0x4f, 0x2e, 0x5d, 0x7a, 0x1b, 0x8c, 0x93));
+
+namespace {
+    struct TraceRegistration
+    {
+        TraceRegistration() noexcept { TraceLoggingRegister(g_traceProvider); }
+        ~TraceRegistration() noexcept { TraceLoggingUnregister(g_traceProvider); }
+    } const g_traceRegistration;
+}
+#endif
+
+static constexpr std::array<std::string_view, static_cast<size_t>(OperationStats::Operation::Count)> OperationNames{
+    "mkdir", "moveFile", "copyFile", "copyFolder", "getFSInfo", "unlink", "exists", "readDir", "stat", "statBatch", "readFile", "read", "hash",
+    "writeFile", "appendFile", "write", "openWrite", "writeChunk", "closeWrite",
+    "openRead", "readChunk", "closeRead", "downloadFile", "fetchToMemory", "uploadFiles", "touch" };
+
+static std::chrono::system_clock::rep now_ticks() noexcept
+{
+    return std::chrono::system_clock::now().time_since_epoch().count();
+}
+
+size_t OperationStats::Bucket(uint64_t microseconds) noexcept
+{
+    size_t bucket{ 0 };
+    while (bucket + 1 < LatencyBuckets && (uint64_t{ 1 } << bucket) <= microseconds)
+    {
+        ++bucket;
+    }
+    return bucket;
+}
+
+uint64_t OperationStats::Percentile(Histogram const& histogram, double fraction) noexcept
+{
+    uint64_t total{ 0 };
+    for (auto count : histogram)
+    {
+        total += count;
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    auto rank{ std::max<uint64_t>(static_cast<uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * total)), 1) };
+    uint64_t seen{ 0 };
+    for (size_t bucket = 0; bucket < histogram.size(); ++bucket)
+    {
+        seen += histogram[bucket];
+        if (seen >= rank)
+        {
+            return uint64_t{ 1 } << bucket;
+        }
+    }
+    return uint64_t{ 1 } << (histogram.size() - 1);
+}
+
+uint64_t OperationStats::Counters::Percentile(double fraction) const noexcept
+{
+    return OperationStats::Percentile(latency, fraction);
+}
+
+OperationStats::OperationStats() noexcept
+    : m_since{ now_ticks() }
+{
+}
+
+std::string_view OperationStats::Name(Operation operation) noexcept
+{
+    return OperationNames[static_cast<size_t>(operation)];
+}
+
+OperationStats::SharedCounters& OperationStats::Local(Operation operation) noexcept
+{
+    // Threads take shards round-robin the first time they record
+    static std::atomic<size_t> nextShard{ 0 };
+    thread_local size_t const shard{ nextShard.fetch_add(1, std::memory_order_relaxed) % ShardCount };
+    return m_shards[shard].operations[static_cast<size_t>(operation)];
+}
+
+void OperationStats::Begin(Operation operation) noexcept
+{
+    Local(operation).inFlight.fetch_add(1, std::memory_order_relaxed);
+}
+
+void OperationStats::End(Operation operation, std::chrono::steady_clock::duration elapsed) noexcept
+{
+    auto micros{ static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(), 0)) };
+    auto bucket{ Bucket(micros) };
+
+    auto& counters{ Local(operation) };
+    counters.inFlight.fetch_sub(1, std::memory_order_relaxed);
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.totalMicroseconds.fetch_add(micros, std::memory_order_relaxed);
+    counters.latency[bucket].fetch_add(1, std::memory_order_relaxed);
+
+#ifdef RNFS_TRACELOGGING
+    TraceLoggingWrite(g_traceProvider, "Operation",
+        TraceLoggingString(Name(operation).data(), "Name"),
+        TraceLoggingUInt64(micros, "Microseconds"));
+#endif
+}
+
+void OperationStats::AddBytes(Operation operation, uint64_t bytesIn, uint64_t bytesOut) noexcept
+{
+    auto& counters{ Local(operation) };
+    if (bytesIn)
+    {
+        counters.bytesIn.fetch_add(bytesIn, std::memory_order_relaxed);
+    }
+    if (bytesOut)
+    {
+        counters.bytesOut.fetch_add(bytesOut, std::memory_order_relaxed);
+    }
+}
+
+void OperationStats::Fail(Operation operation, std::string_view code) noexcept
+{
+    auto known{ std::find(ErrorCodes.begin(), ErrorCodes.end(), code) };
+    auto index{ known != ErrorCodes.end() ? static_cast<size_t>(known - ErrorCodes.begin()) : ErrorCodes.size() - 1 };
+
+    auto& counters{ Local(operation) };
+    counters.errors.fetch_add(1, std::memory_order_relaxed);
+    counters.errorCodes[index].fetch_add(1, std::memory_order_relaxed);
+
+#ifdef RNFS_TRACELOGGING
+    TraceLoggingWrite(g_traceProvider, "OperationFailed",
+        TraceLoggingString(Name(operation).data(), "Name"),
+        TraceLoggingString(ErrorCodes[index].data(), "Code"));
+#endif
+}
+
+OperationStats::Counters OperationStats::Snapshot(Operation operation) const noexcept
+{
+    Counters total;
+    for (auto const& shard : m_shards)
+    {
+        auto const& counters{ shard.operations[static_cast<size_t>(operation)] };
+        total.calls += counters.calls.load(std::memory_order_relaxed);
+        total.inFlight += counters.inFlight.load(std::memory_order_relaxed);
+        total.errors += counters.errors.load(std::memory_order_relaxed);
+        total.bytesIn += counters.bytesIn.load(std::memory_order_relaxed);
+        total.bytesOut += counters.bytesOut.load(std::memory_order_relaxed);
+        total.totalMicroseconds += counters.totalMicroseconds.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < LatencyBuckets; ++i)
+        {
+            total.latency[i] += counters.latency[i].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < ErrorCodes.size(); ++i)
+        {
+            total.errorCodes[i] += counters.errorCodes[i].load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+std::chrono::system_clock::time_point OperationStats::Since() const noexcept
+{
+    return std::chrono::system_clock::time_point{ std::chrono::system_clock::duration{ m_since.load() } };
+}
+
+void OperationStats::Reset() noexcept
+{
+    for (auto& shard : m_shards)
+    {
+        for (auto& counters : shard.operations)
+        {
+            counters.calls.store(0, std::memory_order_relaxed);
+            counters.errors.store(0, std::memory_order_relaxed);
+            counters.bytesIn.store(0, std::memory_order_relaxed);
+            counters.bytesOut.store(0, std::memory_order_relaxed);
+            counters.totalMicroseconds.store(0, std::memory_order_relaxed);
+            for (auto& count : counters.latency)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+            for (auto& count : counters.errorCodes)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    m_since.store(now_ticks());
+}
+
+OperationScope::OperationScope(OperationStats& stats, OperationStats::Operation operation) noexcept
+    : m_stats{ stats },
+      m_operation{ operation },
+      m_start{ std::chrono::steady_clock::now() }
+{
+    m_stats.Begin(m_operation);
+}
+
+OperationScope::~OperationScope() noexcept
+{
+    m_stats.End(m_operation, std::chrono::steady_clock::now() - m_start);
+}
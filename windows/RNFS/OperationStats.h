@@ -0,0 +1,113 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+//
+// Call counts, bytes, latency histograms and error codes of the module's
+// operations, reported by getStats. A thread always records into the same one
+// of a fixed number of shards with relaxed atomic adds, so recording takes no
+// lock and threads rarely write to the same cache line; Snapshot adds the
+// shards up. With RNFS_TRACELOGGING defined, finished and failed operations are
+// also written as TraceLogging events of the "ReactNativeFS" provider.
+//
+struct OperationStats final
+{
+    enum class Operation : uint8_t
+    {
+        Mkdir, MoveFile, CopyFile, CopyFolder, GetFSInfo, Unlink, Exists, ReadDir, Stat, StatBatch, ReadFile, Read, Hash,
+        WriteFile, AppendFile, Write, OpenWrite, WriteChunk, CloseWrite,
+        OpenRead, ReadChunk, CloseRead, DownloadFile, FetchToMemory, UploadFiles, Touch,
+        Count
+    };
+
+    // Codes the module rejects with; any other counts as "Error"
+    static constexpr std::array<std::string_view, 9> ErrorCodes{
+        "ENOENT", "EISDIR", "EFBIG", "ETIMEDOUT", "EINTEGRITY", "EUPLOAD", "CANCELLED", "EBADF", "Error" };
+
+    // Bucket 0 counts calls under 1 microsecond, bucket i > 0 those from 2^(i-1) up to 2^i
+    // microseconds, and the last bucket everything longer
+    static constexpr size_t LatencyBuckets = 32;
+    using Histogram = std::array<uint64_t, LatencyBuckets>;
+
+    // Bucket of a latency of `microseconds`
+    static size_t Bucket(uint64_t microseconds) noexcept;
+
+    // Upper bound in microseconds of the bucket below which `fraction` of the histogram's counts fall
+    static uint64_t Percentile(Histogram const& histogram, double fraction) noexcept;
+
+    struct Counters
+    {
+        uint64_t calls{ 0 };
+        int64_t inFlight{ 0 };
+        uint64_t errors{ 0 };
+        uint64_t bytesIn{ 0 };
+        uint64_t bytesOut{ 0 };
+        uint64_t totalMicroseconds{ 0 };
+        Histogram latency{};
+        std::array<uint64_t, ErrorCodes.size()> errorCodes{};
+
+        // Upper bound in microseconds of the bucket below which `fraction` of the calls finished
+        uint64_t Percentile(double fraction) const noexcept;
+    };
+
+    OperationStats() noexcept;
+    OperationStats(OperationStats const&) = delete;
+    OperationStats& operator=(OperationStats const&) = delete;
+
+    static std::string_view Name(Operation operation) noexcept;
+
+    void Begin(Operation operation) noexcept;
+    void End(Operation operation, std::chrono::steady_clock::duration elapsed) noexcept;
+    void AddBytes(Operation operation, uint64_t bytesIn, uint64_t bytesOut) noexcept;
+    void Fail(Operation operation, std::string_view code) noexcept;
+
+    Counters Snapshot(Operation operation) const noexcept;
+
+    // When the counters were last reset, or created
+    std::chrono::system_clock::time_point Since() const noexcept;
+
+    // Zeroes everything but the in-flight counts, which belong to calls still running
+    void Reset() noexcept;
+
+private:
+    static constexpr size_t ShardCount = 16;
+
+    struct SharedCounters
+    {
+        std::atomic<uint64_t> calls{ 0 };
+        std::atomic<int64_t> inFlight{ 0 };
+        std::atomic<uint64_t> errors{ 0 };
+        std::atomic<uint64_t> bytesIn{ 0 };
+        std::atomic<uint64_t> bytesOut{ 0 };
+        std::atomic<uint64_t> totalMicroseconds{ 0 };
+        std::array<std::atomic<uint64_t>, LatencyBuckets> latency{};
+        std::array<std::atomic<uint64_t>, ErrorCodes.size()> errorCodes{};
+    };
+
+    struct alignas(64) Shard
+    {
+        std::array<SharedCounters, static_cast<size_t>(Operation::Count)> operations;
+    };
+
+    SharedCounters& Local(Operation operation) noexcept;
+
+    std::array<Shard, ShardCount> m_shards;
+    std::atomic<std::chrono::system_clock::rep> m_since;
+};
+
+// Counts one call of an operation from construction to destruction
+struct OperationScope final
+{
+    OperationScope(OperationStats& stats, OperationStats::Operation operation) noexcept;
+    OperationScope(OperationScope const&) = delete;
+    OperationScope& operator=(OperationScope const&) = delete;
+    ~OperationScope() noexcept;
+
+private:
+    OperationStats& m_stats;
+    OperationStats::Operation m_operation;
+    std::chrono::steady_clock::time_point m_start;
+};
@@ -3,7 +3,11 @@
 #include "pch.h"
 
 #include "RNFSManager.h"
+#include "GzipContent.h"
+#include "ThrottledInputStream.h"
+#include "TransferWatchdog.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <sstream>
 #include <stack>
@@ -24,6 +28,8 @@ using namespace winrt::Windows::Storage::Streams;
 using namespace winrt::Windows::Foundation;
 using namespace winrt::Windows::Web::Http;
 
+using Operation = OperationStats::Operation;
+
 
 union touchTime {
     int64_t initialTime;
@@ -31,113 +37,360 @@ union touchTime {
 };
 
 //
-// For downloads and uploads
+// For stat implementation
 //
-CancellationDisposable::CancellationDisposable(IAsyncInfo const& async, std::function<void()>&& onCancel) noexcept
-    : m_async{ async }
-    , m_onCancel{ std::move(onCancel) }
+struct handle_closer
 {
-}
+    void operator()(HANDLE h) noexcept
+    {
+        assert(h != INVALID_HANDLE_VALUE); if (h) CloseHandle(h);
+    }
+};
 
-CancellationDisposable::CancellationDisposable(CancellationDisposable&& other) noexcept
-    : m_async{ std::move(other.m_async) }
-    , m_onCancel{ std::move(other.m_onCancel) }
+static inline HANDLE safe_handle(HANDLE h) noexcept
 {
+    return (h == INVALID_HANDLE_VALUE) ? nullptr : h;
 }
 
-CancellationDisposable& CancellationDisposable::operator=(CancellationDisposable&& other) noexcept
+//
+// For readDir and statBatch with options: the fields a caller asked for, read
+// with FindFirstFileExW and GetFileAttributesExW rather than a WinRT round trip
+// per entry
+//
+struct find_closer
+{
+    void operator()(HANDLE h) noexcept
+    {
+        FindClose(h);
+    }
+};
+
+struct stat_fields
+{
+    bool name{ true };
+    bool path{ true };
+    bool size{ true };
+    bool mtime{ true };
+    bool ctime{ true };
+    bool type{ true };
+
+    bool needs_attributes_ex() const noexcept
+    {
+        return size || mtime || ctime;
+    }
+};
+
+static stat_fields parse_stat_fields(RN::JSValue const& fields)
 {
-    if (this != &other)
+    if (fields.IsNull())
     {
-        CancellationDisposable temp{ std::move(*this) };
-        m_async = std::move(other.m_async);
-        m_onCancel = std::move(other.m_onCancel);
+        return {};
     }
-    return *this;
+
+    stat_fields parsed{ false, false, false, false, false, false };
+    for (auto const& field : fields.AsArray())
+    {
+        auto const& name{ field.AsString() };
+        if (name == "name") parsed.name = true;
+        else if (name == "path") parsed.path = true;
+        else if (name == "size") parsed.size = true;
+        else if (name == "mtime") parsed.mtime = true;
+        else if (name == "ctime") parsed.ctime = true;
+        else if (name == "type") parsed.type = true;
+        else throw winrt::hresult_invalid_argument{ winrt::to_hstring("Invalid field " + name) };
+    }
+    return parsed;
+}
+
+static int64_t unix_seconds(FILETIME const& time) noexcept
+{
+    ULARGE_INTEGER ticks{ time.dwLowDateTime, time.dwHighDateTime };
+    return (static_cast<int64_t>(ticks.QuadPart) - 116444736000000000) / 10000000;
 }
 
-CancellationDisposable::~CancellationDisposable() noexcept
+static uint64_t file_size(DWORD high, DWORD low) noexcept
 {
-    Cancel();
+    return (uint64_t{ high } << 32) | low;
 }
 
-void CancellationDisposable::Cancel() noexcept
+// Calls visit with the WIN32_FIND_DATAW of every entry of folder but . and ..
+template <typename TVisit>
+static void for_each_entry(std::filesystem::path const& folder, TVisit&& visit)
 {
-    if (m_async)
+    WIN32_FIND_DATAW data;
+    auto pattern{ (folder / L"*").wstring() };
+    std::unique_ptr<void, find_closer> find{ safe_handle(FindFirstFileExW(pattern.c_str(), FindExInfoBasic, &data,
+        FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH)) };
+    if (!find)
     {
-        if (m_async.Status() == AsyncStatus::Started)
+        if (GetLastError() == ERROR_FILE_NOT_FOUND)
         {
-            m_async.Cancel();
+            return; // a drive root without entries
         }
+        winrt::throw_last_error();
+    }
 
-        if (m_onCancel)
+    do
+    {
+        if (wcscmp(data.cFileName, L".") != 0 && wcscmp(data.cFileName, L"..") != 0)
         {
-            m_onCancel();
+            visit(data);
         }
+    } while (FindNextFileW(find.get(), &data));
+    if (GetLastError() != ERROR_NO_MORE_FILES)
+    {
+        winrt::throw_last_error();
     }
 }
 
-TaskCancellationManager::~TaskCancellationManager() noexcept
+// One array per field, each with an element per entry, rather than an object per entry
+static RN::JSValueObject read_dir_columns(std::filesystem::path const& folder, stat_fields const& fields)
 {
-    // Do the explicit cleaning to make sure that CancellationDisposable
-    // destructors run while this instance still has valid fields because
-    // they are used by the onCancel callback.
-    // We also want to clear the m_pendingTasks before running the
-    // CancellationDisposable destructors since they touch the m_pendingTasks.
-    std::map<JobId, CancellationDisposable> pendingTasks;
-    {
-        std::scoped_lock lock{ m_mutex };
-        pendingTasks = std::move(m_pendingTasks);
-    }
+    RN::JSValueArray names, paths, sizes, mtimes, ctimes, types;
+    int64_t count{ 0 };
+    for_each_entry(folder, [&](WIN32_FIND_DATAW const& data)
+        {
+            ++count;
+            if (fields.name) names.push_back(winrt::to_string(data.cFileName));
+            if (fields.path) paths.push_back(winrt::to_string((folder / data.cFileName).wstring()));
+            if (fields.size) sizes.push_back(file_size(data.nFileSizeHigh, data.nFileSizeLow));
+            if (fields.mtime) mtimes.push_back(unix_seconds(data.ftLastWriteTime));
+            if (fields.ctime) ctimes.push_back(unix_seconds(data.ftCreationTime));
+            if (fields.type) types.push_back(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ? 1 : 0);
+        });
+
+    RN::JSValueObject columns{ { "count", count } };
+    if (fields.name) columns["names"] = std::move(names);
+    if (fields.path) columns["paths"] = std::move(paths);
+    if (fields.size) columns["sizes"] = std::move(sizes);
+    if (fields.mtime) columns["mtimes"] = std::move(mtimes);
+    if (fields.ctime) columns["ctimes"] = std::move(ctimes);
+    if (fields.type) columns["types"] = std::move(types);
+    return columns;
 }
 
-IAsyncAction TaskCancellationManager::Add(JobId jobId, IAsyncAction const& asyncAction) noexcept
+// The usual readDir items, with only the given fields
+static RN::JSValueArray read_dir_rows(std::filesystem::path const& folder, stat_fields const& fields)
 {
-    std::scoped_lock lock{ m_mutex };
-    m_pendingTasks.try_emplace(jobId, asyncAction, [this, jobId]()
+    RN::JSValueArray rows;
+    for_each_entry(folder, [&](WIN32_FIND_DATAW const& data)
         {
-            Cancel(jobId);
+            RN::JSValueObject row;
+            if (fields.name) row["name"] = winrt::to_string(data.cFileName);
+            if (fields.path) row["path"] = winrt::to_string((folder / data.cFileName).wstring());
+            if (fields.size) row["size"] = file_size(data.nFileSizeHigh, data.nFileSizeLow);
+            if (fields.mtime) row["mtime"] = unix_seconds(data.ftLastWriteTime);
+            if (fields.ctime) row["ctime"] = unix_seconds(data.ftCreationTime);
+            if (fields.type) row["type"] = data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ? 1 : 0;
+            rows.push_back(std::move(row));
         });
-    return asyncAction;
+    return rows;
+}
+
+//
+// For the download cache and the upload journal: opens the folder a module setting named, or `name`
+// under the app data folder `appFolder` returns. A process without package identity has no app
+// data, so it keeps `name` under the temp directory instead.
+//
+static IAsyncOperation<StorageFolder> open_state_folder(std::wstring configured, std::function<StorageFolder()> appFolder, winrt::hstring name)
+{
+    if (!configured.empty())
+    {
+        std::error_code ignored; // GetFolderFromPathAsync reports a folder that could not be made
+        std::filesystem::create_directories(configured, ignored);
+        co_return co_await StorageFolder::GetFolderFromPathAsync(configured);
+    }
+
+    StorageFolder parent{ nullptr };
+    try
+    {
+        parent = appFolder();
+    }
+    catch (const hresult_error&)
+    {
+        // No package identity
+    }
+    if (!parent)
+    {
+        parent = co_await StorageFolder::GetFolderFromPathAsync(std::filesystem::temp_directory_path().wstring());
+    }
+    co_return co_await parent.CreateFolderAsync(name, CreationCollisionOption::OpenIfExists);
 }
 
-void TaskCancellationManager::Cancel(JobId jobId) noexcept
+//
+// For downloads and copyFile: removes the partially written temp file unless it was committed
+//
+struct partial_file_remover
 {
-    // The destructor of the token does the cancellation. We must do it outside of lock.
-    CancellationDisposable token;
+    std::wstring path;
+    bool committed{ false };
 
+    ~partial_file_remover() noexcept
     {
-        std::scoped_lock lock{ m_mutex };
-        if (!m_pendingTasks.empty())
+        if (!committed && !path.empty())
         {
-            if (auto it = m_pendingTasks.find(jobId); it != m_pendingTasks.end())
-            {
-                token = std::move(it->second);
-                m_pendingTasks.erase(it);
-            }
+            DeleteFileW(path.c_str());
+        }
+    }
+};
+
+//
+// For downloads and uploads: forgets the job, and the bandwidth limit set for it, when the method that added it returns, however it returns
+//
+struct job_remover
+{
+    JobTable& jobs;
+    BandwidthLimiter& bandwidth;
+    int32_t jobId;
+
+    ~job_remover() noexcept
+    {
+        jobs.Remove(jobId);
+        bandwidth.Forget(jobId);
+    }
+};
+
+//
+// For file operations: registers the optional jobId of a call so that cancelJob can stop it between chunks
+//
+struct cancellable_job
+{
+    JobTable& jobs;
+    BandwidthLimiter& bandwidth; // setBandwidthLimit accepts any registered job, so its limit is forgotten here too
+    std::shared_ptr<JobTable::Job> job; // null when the caller gave no jobId
+
+    cancellable_job(JobTable& jobs, BandwidthLimiter& bandwidth, RN::JSValue const& jobId)
+        : jobs{ jobs },
+          bandwidth{ bandwidth }
+    {
+        if (!jobId.IsNull())
+        {
+            job = jobs.Add(jobId.AsInt32());
+            job->SetState(JobState::Running);
+        }
+    }
+
+    cancellable_job(cancellable_job const&) = delete;
+    cancellable_job& operator=(cancellable_job const&) = delete;
+
+    ~cancellable_job() noexcept
+    {
+        if (job)
+        {
+            jobs.Remove(job->Id());
+            bandwidth.Forget(job->Id());
+        }
+    }
+
+    // Throws hresult_canceled once cancelJob has been called for the job
+    void check() const
+    {
+        if (job && job->Cancelled())
+        {
+            throw winrt::hresult_canceled();
+        }
+    }
+
+    void progress(uint64_t done, uint64_t total) const noexcept
+    {
+        if (job)
+        {
+            job->Progress(done, total);
         }
     }
+};
+
+//
+// For file operations: the scheduler lane named by the `priority` option
+//
+static TransferPriority io_priority(RN::JSValueObject const& options, TransferPriority fallback)
+{
+    auto const& name{ options["priority"] };
+    if (name.IsNull())
+    {
+        return fallback;
+    }
+    if (auto priority{ ParseTransferPriority(name.AsString()) })
+    {
+        return *priority;
+    }
+    throw winrt::hresult_invalid_argument{ winrt::to_hstring("Invalid priority " + name.AsString()) };
+}
+
+// Rejection of a cancelled file operation, shaped like that of a stopped download
+static RN::ReactError cancelled_error(winrt::hresult code, RN::JSValue const& jobId, std::string const& path)
+{
+    return RN::ReactError{ std::to_string(code), "CANCELLED: job '" + std::to_string(jobId.AsInt32()) + "' on '" + path + "'", RN::JSValueObject{} };
+}
+
+// For copyFile: reports each chunk to the job and stops the copy once it is cancelled
+static COPYFILE2_MESSAGE_ACTION CALLBACK copy_progress(COPYFILE2_MESSAGE const* message, PVOID context) noexcept
+{
+    auto job{ static_cast<JobTable::Job*>(context) };
+    if (message->Type == COPYFILE2_CALLBACK_CHUNK_FINISHED)
+    {
+        job->Progress(message->Info.ChunkFinished.uliTotalBytesTransferred.QuadPart, message->Info.ChunkFinished.uliTotalFileSize.QuadPart);
+    }
+    return job->Cancelled() ? COPYFILE2_PROGRESS_CANCEL : COPYFILE2_PROGRESS_CONTINUE;
 }
 
 //
-// For stat implementation
+// For uploads: limits UploadProgress events to one per interval, always letting the last byte through
 //
-struct handle_closer
+struct upload_progress_throttle
 {
-    void operator()(HANDLE h) noexcept
+    explicit upload_progress_throttle(int64_t interval) noexcept : interval{ interval } {}
+
+    bool should_emit(uint64_t sent, uint64_t total) noexcept
     {
-        assert(h != INVALID_HANDLE_VALUE); if (h) CloseHandle(h);
+        if (sent == lastSent.load())
+        {
+            return false;
+        }
+
+        int64_t now{ winrt::clock::now().time_since_epoch().count() / 10000 };
+        if (sent < total && now - lastTime.load() < interval)
+        {
+            return false;
+        }
+        lastTime.store(now);
+        lastSent.store(sent);
+        return true;
     }
+
+    int64_t interval; // ms
+    std::atomic<int64_t> lastTime{ 0 };
+    std::atomic<uint64_t> lastSent{ 0 };
 };
 
-static inline HANDLE safe_handle(HANDLE h) noexcept
+//
+// For uploads: the bytes of an upload item that carries its own `data` (base64, or text when its
+// `encoding` is "utf8") instead of naming a file, or nullptr for items that name a file
+//
+static IBuffer upload_part_data(RN::JSValueObject const& item)
 {
-    return (h == INVALID_HANDLE_VALUE) ? nullptr : h;
+    if (item["data"].IsNull())
+    {
+        return nullptr;
+    }
+    if (item["encoding"].AsString() == "utf8")
+    {
+        auto const& text{ item["data"].AsString() };
+        Buffer buffer{ static_cast<uint32_t>(text.size()) };
+        std::copy(text.begin(), text.end(), buffer.data());
+        buffer.Length(static_cast<uint32_t>(text.size()));
+        return buffer;
+    }
+    return Cryptography::CryptographicBuffer::DecodeFromBase64String(winrt::to_hstring(item["data"].AsString()));
 }
 
 void RNFSManager::Initialize(RN::ReactContext const& reactContext) noexcept
 {
     m_reactContext = reactContext;
+    m_events.SetSink([reactContext](RN::JSValueArray events)
+        {
+            reactContext.CallJSFunction(L"RCTDeviceEventEmitter", L"emit", L"RNFSEventBatch", std::move(events));
+        });
 }
 
 
@@ -187,9 +440,12 @@ void RNFSManager::ConstantsViaConstantsProvider(RN::ReactConstantProvider& const
 winrt::fire_and_forget RNFSManager::mkdir(std::string directory, RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::Mkdir };
+    auto slot{ co_await m_io.Schedule(io_priority(options, TransferPriority::Normal)) };
     size_t pathLength{ directory.length() };
 
     if (pathLength <= 0) {
+        m_stats.Fail(Operation::Mkdir, "Error");
         promise.Reject("Invalid path length");
     }
     else {
@@ -214,6 +470,7 @@ try
                     parentPath = parentPath.substr(0, index);
                 }
                 else {
+                    m_stats.Fail(Operation::Mkdir, "Error");
                     promise.Reject(winrt::to_string(ex.message()).c_str());
                 }
             }
@@ -229,6 +486,7 @@ try
 catch (const hresult_error& ex)
 {
     // "Unexpected error while making directory."
+    m_stats.Fail(Operation::Mkdir, "Error");
     promise.Reject( winrt::to_string(ex.message()).c_str() );
 }
 
@@ -236,6 +494,8 @@ catch (const hresult_error& ex)
 winrt::fire_and_forget RNFSManager::moveFile(std::string filepath, std::string destpath, RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::MoveFile };
+    auto slot{ co_await m_io.Schedule(io_priority(options, TransferPriority::Normal)) };
     winrt::hstring srcDirectoryPath, srcFileName;
     splitPath(filepath, srcDirectoryPath, srcFileName);
 
@@ -253,6 +513,7 @@ try
 catch (const hresult_error& ex)
 {
     // "Failed to move file."
+    m_stats.Fail(Operation::MoveFile, "Error");
     promise.Reject(winrt::to_string(ex.message()).c_str());
 }
 
@@ -260,6 +521,10 @@ catch (const hresult_error& ex)
 winrt::fire_and_forget RNFSManager::copyFile(std::string filepath, std::string destpath, RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::CopyFile };
+    cancellable_job cancellable{ m_jobs, m_bandwidth, options["jobId"] };
+    auto slot{ co_await m_io.Schedule(io_priority(options, TransferPriority::Normal)) };
+    cancellable.check(); // cancelled while queued
     winrt::hstring srcDirectoryPath, srcFileName;
     splitPath(filepath, srcDirectoryPath, srcFileName);
 
@@ -270,13 +535,41 @@ try
     StorageFolder destFolder{ co_await StorageFolder::GetFolderFromPathAsync(destDirectoryPath) };
     StorageFile file{ co_await srcFolder.GetFileAsync(srcFileName) };
 
-    co_await file.CopyAsync(destFolder, destFileName, NameCollisionOption::ReplaceExisting);
+    if (cancellable.job)
+    {
+        // CopyFile2 calls copy_progress after every chunk and deletes its target when it cancels, so it
+        // copies into a sibling that is renamed over destpath once complete, as downloads do
+        std::wstring destination{ destFolder.Path() + L"\\" + destFileName };
+        partial_file_remover partialFile{ destination + L"." + std::to_wstring(cancellable.job->Id()) + L".copy" };
+        co_await winrt::resume_background();
+        COPYFILE2_EXTENDED_PARAMETERS parameters{ sizeof(parameters) };
+        parameters.pProgressRoutine = copy_progress;
+        parameters.pvCallbackContext = cancellable.job.get();
+        auto result{ CopyFile2(file.Path().c_str(), partialFile.path.c_str(), &parameters) };
+        if (result == HRESULT_FROM_WIN32(ERROR_REQUEST_ABORTED))
+        {
+            throw winrt::hresult_canceled();
+        }
+        winrt::check_hresult(result);
+        winrt::check_bool(MoveFileExW(partialFile.path.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING));
+        partialFile.committed = true;
+    }
+    else
+    {
+        co_await file.CopyAsync(destFolder, destFileName, NameCollisionOption::ReplaceExisting);
+    }
 
     promise.Resolve();
 }
+catch (winrt::hresult_canceled const& ex)
+{
+    m_stats.Fail(Operation::CopyFile, "CANCELLED");
+    promise.Reject(cancelled_error(ex.code(), options["jobId"], destpath));
+}
 catch (const hresult_error& ex)
 {
     // "Failed to copy file."
+    m_stats.Fail(Operation::CopyFile, "Error");
     promise.Reject(winrt::to_string(ex.message()).c_str());
 }
 
@@ -284,9 +577,14 @@ catch (const hresult_error& ex)
 winrt::fire_and_forget RNFSManager::copyFolder(
     std::string srcFolderPath,
     std::string destFolderPath,
+    RN::JSValueObject options,
     RN::ReactPromise<void> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::CopyFolder };
+    cancellable_job cancellable{ m_jobs, m_bandwidth, options["jobId"] };
+    auto slot{ co_await m_io.Schedule(io_priority(options, TransferPriority::Normal)) };
+    cancellable.check(); // cancelled while queued
     std::filesystem::path srcPath{ srcFolderPath };
     srcPath.make_preferred();
     std::filesystem::path destPath{ destFolderPath };
@@ -295,61 +593,93 @@ try
     StorageFolder srcFolder{ co_await StorageFolder::GetFolderFromPathAsync(winrt::to_hstring(srcPath.c_str())) };
     StorageFolder destFolder{ co_await StorageFolder::GetFolderFromPathAsync(winrt::to_hstring(destPath.c_str())) };
 
-    auto items{ co_await srcFolder.GetItemsAsync() };
-    for (auto item : items)
+    // Depth first, finishing every subfolder before resolving; when the copy can be
+    // cancelled, the files and folders it creates are kept to be removed again. Files
+    // it overwrote were there before, so they stay.
+    std::stack<std::pair<StorageFolder, StorageFolder>> folders;
+    folders.emplace(srcFolder, destFolder);
+    std::vector<IStorageItem> added;
+    uint64_t copied{ 0 };
+    bool cancelled{ false };
+    try
     {
-        if (item.IsOfType(StorageItemTypes::File))
+        while (!folders.empty())
         {
-            StorageFile file{ co_await StorageFile::GetFileFromPathAsync(item.Path()) };
-            co_await file.CopyAsync(destFolder, file.Name(), NameCollisionOption::ReplaceExisting);
+            auto next{ folders.top() };
+            folders.pop();
+
+            auto items{ co_await next.first.GetItemsAsync() };
+            for (auto const& item : items)
+            {
+                cancellable.check();
+                bool existed{ false };
+                if (cancellable.job)
+                {
+                    existed = (co_await next.second.TryGetItemAsync(item.Name())) != nullptr;
+                }
+                if (item.IsOfType(StorageItemTypes::File))
+                {
+                    auto copy{ co_await item.as<StorageFile>().CopyAsync(next.second, item.Name(), NameCollisionOption::ReplaceExisting) };
+                    if (cancellable.job && !existed)
+                    {
+                        added.push_back(copy);
+                    }
+                    cancellable.progress(++copied, 0);
+                }
+                else if (item.IsOfType(StorageItemTypes::Folder))
+                {
+                    StorageFolder dest{ co_await next.second.CreateFolderAsync(item.Name(), CreationCollisionOption::OpenIfExists) };
+                    if (cancellable.job && !existed)
+                    {
+                        added.push_back(dest);
+                    }
+                    folders.emplace(item.as<StorageFolder>(), dest);
+                }
+            }
         }
-        else if (item.IsOfType(StorageItemTypes::Folder))
+    }
+    catch (winrt::hresult_canceled const&)
+    {
+        cancelled = true;
+    }
+
+    if (cancelled)
+    {
+        // Newest first, so files go before the folders holding them
+        for (auto it = added.rbegin(); it != added.rend(); ++it)
         {
-            StorageFolder src{ co_await StorageFolder::GetFolderFromPathAsync(item.Path()) };
-            StorageFolder dest{ co_await destFolder.CreateFolderAsync(item.Name(), CreationCollisionOption::OpenIfExists) };
-            copyFolderHelper(src, dest);
+            try
+            {
+                co_await (*it).DeleteAsync(StorageDeleteOption::PermanentDelete);
+            }
+            catch (const hresult_error&)
+            {
+                // Already removed with a folder it was in
+            }
         }
+        throw winrt::hresult_canceled();
     }
 
     promise.Resolve();
-    co_return;
+}
+catch (winrt::hresult_canceled const& ex)
+{
+    m_stats.Fail(Operation::CopyFolder, "CANCELLED");
+    promise.Reject(cancelled_error(ex.code(), options["jobId"], destFolderPath));
 }
 catch (const hresult_error& ex)
 {
     // "Failed to copy file."
+    m_stats.Fail(Operation::CopyFolder, "Error");
     promise.Reject(winrt::to_string(ex.message()).c_str());
 }
 
-winrt::fire_and_forget RNFSManager::copyFolderHelper(
-    winrt::Windows::Storage::StorageFolder src,
-    winrt::Windows::Storage::StorageFolder dest) noexcept
-try
-{
-    auto items{ co_await src.GetItemsAsync() };
-    for (auto item : items)
-    {
-        if (item.IsOfType(StorageItemTypes::File))
-        {
-            StorageFile file{ co_await StorageFile::GetFileFromPathAsync(item.Path()) };
-            co_await file.CopyAsync(dest, file.Name(), NameCollisionOption::ReplaceExisting);
-        }
-        else if (item.IsOfType(StorageItemTypes::Folder))
-        {
-            StorageFolder srcFolder{ co_await StorageFolder::GetFolderFromPathAsync(item.Path()) };
-            StorageFolder destFolder{ co_await dest.CreateFolderAsync(item.Name(), CreationCollisionOption::OpenIfExists) };
-            copyFolderHelper(srcFolder, destFolder);
-        }
-    }
-}
-catch (...)
-{
-    co_return;
-}
-
 
 winrt::fire_and_forget RNFSManager::getFSInfo(RN::ReactPromise<RN::JSValueObject> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::GetFSInfo };
+    auto slot{ co_await m_io.Schedule(TransferPriority::Interactive) };
     auto localFolder{ Windows::Storage::ApplicationData::Current().LocalFolder() };
     auto properties{ co_await localFolder.Properties().RetrievePropertiesAsync({L"System.FreeSpace", L"System.Capacity"}) };
 
@@ -362,16 +692,22 @@ try
 catch (const hresult_error& ex)
 {
     // "Failed to retrieve file system info."
+    m_stats.Fail(Operation::GetFSInfo, "Error");
     promise.Reject(winrt::to_string(ex.message()).c_str());
 }
 
 
-winrt::fire_and_forget RNFSManager::unlink(std::string filepath, RN::ReactPromise<void> promise) noexcept
+winrt::fire_and_forget RNFSManager::unlink(std::string filepath, RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::Unlink };
+    cancellable_job cancellable{ m_jobs, m_bandwidth, options["jobId"] };
+    auto slot{ co_await m_io.Schedule(io_priority(options, TransferPriority::Normal)) };
+    cancellable.check(); // cancelled while queued
     size_t pathLength{ filepath.length() };
 
     if (pathLength <= 0) {
+        m_stats.Fail(Operation::Unlink, "Error");
         promise.Reject("Invalid path.");
     }
     else {
@@ -381,21 +717,59 @@ try
 
         StorageFolder folder{ co_await StorageFolder::GetFolderFromPathAsync(path.parent_path().wstring()) };
         auto target{ co_await folder.GetItemAsync(path.filename().wstring()) };
-        co_await target.DeleteAsync();
+        if (cancellable.job && target.IsOfType(StorageItemTypes::Folder))
+        {
+            // One entry at a time so that cancelJob can stop in between; what is gone stays gone
+            co_await winrt::resume_background();
+            std::error_code error;
+            std::vector<std::filesystem::path> entries;
+            for (std::filesystem::recursive_directory_iterator it{ path, error }, end; !error && it != end; it.increment(error))
+            {
+                entries.push_back(it->path());
+            }
+
+            // Entries come after the folder holding them, so going backwards empties each folder before removing it
+            uint64_t removed{ 0 };
+            for (auto it = entries.rbegin(); !error && it != entries.rend(); ++it)
+            {
+                cancellable.check();
+                std::filesystem::remove(*it, error);
+                cancellable.progress(++removed, entries.size());
+            }
+            if (!error)
+            {
+                std::filesystem::remove(path, error);
+            }
+            if (error)
+            {
+                winrt::throw_hresult(HRESULT_FROM_WIN32(error.value()));
+            }
+        }
+        else
+        {
+            co_await target.DeleteAsync();
+        }
 
         promise.Resolve();
     }
 }
+catch (winrt::hresult_canceled const& ex)
+{
+    m_stats.Fail(Operation::Unlink, "CANCELLED");
+    promise.Reject(cancelled_error(ex.code(), options["jobId"], filepath));
+}
 catch (const hresult_error& ex)
 {
     hresult result{ ex.code() };
     if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) // FileNotFoundException
     {
+        m_stats.Fail(Operation::Unlink, "ENOENT");
         promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
     }
     else
     {
         // "Failed to unlink file" 
+        m_stats.Fail(Operation::Unlink, "Error");
         promise.Reject( winrt::to_string(ex.message()).c_str() );
     }
 }
@@ -404,6 +778,8 @@ catch (const hresult_error& ex)
 winrt::fire_and_forget RNFSManager::exists(std::string filepath, RN::ReactPromise<bool> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::Exists };
+    auto slot{ co_await m_io.Schedule(TransferPriority::Interactive) };
     size_t fileLength{ filepath.length() };
 
     if (fileLength <= 0) {
@@ -428,50 +804,101 @@ catch (const hresult_error& ex)
     if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) {
         promise.Resolve(false);
     }
-    // "Failed to check if file or directory exists.
-    promise.Reject(winrt::to_string(ex.message()).c_str());
+    else {
+        // "Failed to check if file or directory exists.
+        m_stats.Fail(Operation::Exists, "Error");
+        promise.Reject(winrt::to_string(ex.message()).c_str());
+    }
 }
 
 
 void RNFSManager::stopDownload(int32_t jobID) noexcept
 {
-    m_tasks.Cancel(jobID);
+    m_jobs.Cancel(jobID);
 }
 
 
 void RNFSManager::stopUpload(int32_t jobID) noexcept
 {
-    m_tasks.Cancel(jobID);
+    m_jobs.Cancel(jobID);
+}
+
+
+void RNFSManager::cancelJob(int32_t jobID) noexcept
+{
+    m_jobs.Cancel(jobID);
 }
 
 
-winrt::fire_and_forget RNFSManager::readFile(std::string filepath, RN::ReactPromise<std::string> promise) noexcept
+winrt::fire_and_forget RNFSManager::readFile(std::string filepath, RN::JSValueObject options, RN::ReactPromise<std::string> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::ReadFile };
+    cancellable_job cancellable{ m_jobs, m_bandwidth, options["jobId"] };
+    auto slot{ co_await m_io.Schedule(io_priority(options, TransferPriority::Normal)) };
+    cancellable.check(); // cancelled while queued
     winrt::hstring directoryPath, fileName;
     splitPath(filepath, directoryPath, fileName);
 
     StorageFolder folder{ co_await StorageFolder::GetFolderFromPathAsync(directoryPath) };
     StorageFile file{ co_await folder.GetFileAsync(fileName) };
 
-    Streams::IBuffer buffer{ co_await FileIO::ReadBufferAsync(file) };
+    Streams::IBuffer buffer{ nullptr };
+    if (cancellable.job)
+    {
+        // A chunk at a time, checking for cancelJob in between
+        Streams::IRandomAccessStream stream{ co_await file.OpenReadAsync() };
+        auto size{ stream.Size() };
+        Streams::Buffer contents{ static_cast<uint32_t>(size) };
+        Streams::Buffer chunk{ CancellableChunkSize };
+        uint32_t length{ 0 };
+        while (length < contents.Capacity())
+        {
+            cancellable.check();
+            auto read{ co_await stream.ReadAsync(chunk, CancellableChunkSize, Streams::InputStreamOptions::None) };
+            if (read.Length() == 0)
+            {
+                break;
+            }
+            auto count{ std::min(read.Length(), contents.Capacity() - length) };
+            std::copy_n(read.data(), count, contents.data() + length);
+            length += count;
+            cancellable.progress(length, size);
+        }
+        contents.Length(length);
+        buffer = contents;
+    }
+    else
+    {
+        buffer = co_await FileIO::ReadBufferAsync(file);
+    }
+
     winrt::hstring base64Content{ Cryptography::CryptographicBuffer::EncodeToBase64String(buffer) };
+    m_stats.AddBytes(Operation::ReadFile, buffer.Length(), 0);
     promise.Resolve(winrt::to_string(base64Content));
 }
+catch (winrt::hresult_canceled const& ex)
+{
+    m_stats.Fail(Operation::ReadFile, "CANCELLED");
+    promise.Reject(cancelled_error(ex.code(), options["jobId"], filepath));
+}
 catch (const hresult_error& ex)
 {
     hresult result{ ex.code() };
     if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) // FileNotFoundException
     {
+        m_stats.Fail(Operation::ReadFile, "ENOENT");
         promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
     }
     else if (result == HRESULT_FROM_WIN32(E_ACCESSDENIED)) // UnauthorizedAccessException
     {
+        m_stats.Fail(Operation::ReadFile, "EISDIR");
         promise.Reject(RN::ReactError{ "EISDIR", "EISDIR: illegal operation on a directory, read" });
     }
     else
     {
         // "Failed to read file."
+        m_stats.Fail(Operation::ReadFile, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
 }
@@ -480,9 +907,12 @@ catch (const hresult_error& ex)
 winrt::fire_and_forget RNFSManager::stat(std::string filepath, RN::ReactPromise<RN::JSValueObject> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::Stat };
+    auto slot{ co_await m_io.Schedule(TransferPriority::Interactive) };
     size_t pathLength{ filepath.length() };
 
     if (pathLength <= 0) {
+        m_stats.Fail(Operation::Stat, "Error");
         promise.Reject("Invalid path.");
     }
     else {
@@ -504,15 +934,91 @@ try
 }
 catch (...)
 {
+    m_stats.Fail(Operation::Stat, "ENOENT");
     promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
 }
 
 
-winrt::fire_and_forget RNFSManager::readDir(std::string directory, RN::ReactPromise<RN::JSValueArray> promise) noexcept
+winrt::fire_and_forget RNFSManager::statBatch(RN::JSValueArray filepaths, RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept
+try
+{
+    OperationScope scope{ m_stats, Operation::StatBatch };
+    auto slot{ co_await m_io.Schedule(TransferPriority::Interactive) };
+    auto fields{ parse_stat_fields(options["fields"]) };
+
+    RN::JSValueArray exists, sizes, mtimes, ctimes, types;
+    for (auto const& filepath : filepaths)
+    {
+        std::filesystem::path path(filepath.AsString());
+        path.make_preferred();
+
+        // Without sizes or times the attributes alone will do
+        WIN32_FILE_ATTRIBUTE_DATA data{};
+        bool found{ false };
+        if (fields.needs_attributes_ex())
+        {
+            found = GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data);
+        }
+        else
+        {
+            data.dwFileAttributes = GetFileAttributesW(path.c_str());
+            found = data.dwFileAttributes != INVALID_FILE_ATTRIBUTES;
+        }
+        if (!found)
+        {
+            auto error{ GetLastError() };
+            if (error != ERROR_FILE_NOT_FOUND && error != ERROR_PATH_NOT_FOUND && error != ERROR_INVALID_NAME)
+            {
+                winrt::throw_hresult(HRESULT_FROM_WIN32(error));
+            }
+            data = {};
+        }
+
+        exists.push_back(found);
+        if (fields.size) sizes.push_back(file_size(data.nFileSizeHigh, data.nFileSizeLow));
+        if (fields.mtime) mtimes.push_back(found ? unix_seconds(data.ftLastWriteTime) : 0);
+        if (fields.ctime) ctimes.push_back(found ? unix_seconds(data.ftCreationTime) : 0);
+        if (fields.type) types.push_back(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ? 1 : 0);
+    }
+
+    RN::JSValueObject columns{ { "count", static_cast<int64_t>(filepaths.size()) }, { "exists", std::move(exists) } };
+    if (fields.size) columns["sizes"] = std::move(sizes);
+    if (fields.mtime) columns["mtimes"] = std::move(mtimes);
+    if (fields.ctime) columns["ctimes"] = std::move(ctimes);
+    if (fields.type) columns["types"] = std::move(types);
+    promise.Resolve(std::move(columns));
+}
+catch (const hresult_error& ex)
+{
+    m_stats.Fail(Operation::StatBatch, "Error");
+    promise.Reject(winrt::to_string(ex.message()).c_str());
+}
+
+
+winrt::fire_and_forget RNFSManager::readDir(std::string directory, RN::JSValueObject options, RN::ReactPromise<RN::JSValue> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::ReadDir };
+    auto slot{ co_await m_io.Schedule(TransferPriority::Interactive) };
     std::filesystem::path path(directory);
     path.make_preferred();
+
+    //Columns or chosen fields, listed on this worker without a call per entry
+    bool columnar{ options["columnar"].AsBoolean() };
+    if (columnar || !options["fields"].IsNull())
+    {
+        auto fields{ parse_stat_fields(options["fields"]) };
+        if (columnar)
+        {
+            promise.Resolve(RN::JSValue{ read_dir_columns(path, fields) });
+        }
+        else
+        {
+            promise.Resolve(RN::JSValue{ read_dir_rows(path, fields) });
+        }
+        co_return;
+    }
+
     StorageFolder targetDirectory{ co_await StorageFolder::GetFolderFromPathAsync(path.c_str()) };
 
     RN::JSValueArray resultsArray;
@@ -533,11 +1039,12 @@ try
         resultsArray.push_back(std::move(itemInfo));
     }
 
-    promise.Resolve(resultsArray);
+    promise.Resolve(RN::JSValue{ std::move(resultsArray) });
 }
 catch (const hresult_error& ex)
 {
     // "Failed to read directory."
+    m_stats.Fail(Operation::ReadDir, "Error");
     promise.Reject(winrt::to_string(ex.message()).c_str());
 }
 
@@ -545,6 +1052,8 @@ catch (const hresult_error& ex)
 winrt::fire_and_forget RNFSManager::read(std::string filepath, uint32_t length, uint64_t position, RN::ReactPromise<std::string> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::Read };
+    auto slot{ co_await m_io.Schedule(TransferPriority::Interactive) };
     winrt::hstring directoryPath, fileName;
     splitPath(filepath, directoryPath, fileName);
 
@@ -556,9 +1065,10 @@ try
     Streams::IRandomAccessStream stream{ co_await file.OpenReadAsync() };
     stream.Seek(position);
 
-    stream.ReadAsync(buffer, length, Streams::InputStreamOptions::None);
-    std::string result{ winrt::to_string(Cryptography::CryptographicBuffer::EncodeToBase64String(buffer)) };
+    auto read{ co_await stream.ReadAsync(buffer, length, Streams::InputStreamOptions::None) };
+    std::string result{ winrt::to_string(Cryptography::CryptographicBuffer::EncodeToBase64String(read)) };
 
+    m_stats.AddBytes(Operation::Read, read.Length(), 0);
     promise.Resolve(result);
 }
 catch (const hresult_error& ex)
@@ -566,26 +1076,34 @@ catch (const hresult_error& ex)
     hresult result{ ex.code() };
     if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) // FileNotFoundException
     {
+        m_stats.Fail(Operation::Read, "ENOENT");
         promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
     }
     else if (result == HRESULT_FROM_WIN32(E_ACCESSDENIED)) // UnauthorizedAccessException
     {
+        m_stats.Fail(Operation::Read, "EISDIR");
         promise.Reject(RN::ReactError{"EISDIR", "EISDIR: Could not open file for reading" });
     }
     else 
     {
         // "Failed to read from file."
+        m_stats.Fail(Operation::Read, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
 }
 
 
-winrt::fire_and_forget RNFSManager::hash(std::string filepath, std::string algorithm, RN::ReactPromise<std::string> promise) noexcept
+winrt::fire_and_forget RNFSManager::hash(std::string filepath, std::string algorithm, RN::JSValueObject options, RN::ReactPromise<std::string> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::Hash };
+    cancellable_job cancellable{ m_jobs, m_bandwidth, options["jobId"] };
+    auto slot{ co_await m_io.Schedule(io_priority(options, TransferPriority::Normal)) };
+    cancellable.check(); // cancelled while queued
     // Note: SHA224 is not part of winrt 
     if (algorithm.compare("sha224") == 0)
     {
+        m_stats.Fail(Operation::Hash, "Error");
         promise.Reject(RN::ReactError{ "Error", "WinRT does not offer sha224 encryption." });
         co_return;
     }
@@ -599,32 +1117,58 @@ try
     auto search{ availableHashes.find(algorithm) };
     if (search == availableHashes.end())
     {
+        m_stats.Fail(Operation::Hash, "Error");
         promise.Reject(RN::ReactError{ "Error", "Invalid hash algorithm " + algorithm});
         co_return;
     }
 
+    // Hash a chunk at a time rather than holding the whole file, checking for cancelJob in between
     CryptographyCore::HashAlgorithmProvider provider{ search->second() };
-    Streams::IBuffer buffer{ co_await FileIO::ReadBufferAsync(file) };
+    auto hasher{ provider.CreateHash() };
+    Streams::IRandomAccessStream stream{ co_await file.OpenReadAsync() };
+    auto size{ stream.Size() };
+    Streams::Buffer chunk{ CancellableChunkSize };
+    uint64_t length{ 0 };
+    for (;;)
+    {
+        cancellable.check();
+        auto read{ co_await stream.ReadAsync(chunk, CancellableChunkSize, Streams::InputStreamOptions::None) };
+        if (read.Length() == 0)
+        {
+            break;
+        }
+        hasher.Append(read);
+        length += read.Length();
+        cancellable.progress(length, size);
+    }
 
-    auto hashedBuffer{ provider.HashData(buffer) };
-    auto result{ winrt::to_string(Cryptography::CryptographicBuffer::EncodeToHexString(hashedBuffer)) };
+    auto result{ winrt::to_string(Cryptography::CryptographicBuffer::EncodeToHexString(hasher.GetValueAndReset())) };
 
+    m_stats.AddBytes(Operation::Hash, length, 0);
     promise.Resolve(result);
 }
+catch (winrt::hresult_canceled const& ex)
+{
+    m_stats.Fail(Operation::Hash, "CANCELLED");
+    promise.Reject(cancelled_error(ex.code(), options["jobId"], filepath));
+}
 catch (const hresult_error& ex)
 {
     hresult result{ ex.code() };
     if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) // FileNotFoundException
     {
+        m_stats.Fail(Operation::Hash, "ENOENT");
         promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
     }
     else if (result == HRESULT_FROM_WIN32(E_ACCESSDENIED)) // UnauthorizedAccessException
     {
+        m_stats.Fail(Operation::Hash, "EISDIR");
         promise.Reject(RN::ReactError{ "EISDIR", "EISDIR: illegal operation on a directory, read" });
     }
     else
     {
         // "Failed to get checksum from file."
+        m_stats.Fail(Operation::Hash, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
 }
@@ -633,6 +1177,8 @@ catch (const hresult_error& ex)
 winrt::fire_and_forget RNFSManager::writeFile(std::string filepath, std::string base64Content, RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::WriteFile };
+    auto slot{ co_await m_io.Schedule(io_priority(options, TransferPriority::Normal)) };
     winrt::hstring base64ContentStr{ winrt::to_hstring(base64Content) };
     Streams::IBuffer buffer{ Cryptography::CryptographicBuffer::DecodeFromBase64String(base64ContentStr) };
 
@@ -645,6 +1191,7 @@ try
     Streams::IRandomAccessStream stream{ co_await file.OpenAsync(FileAccessMode::ReadWrite) };
     co_await stream.WriteAsync(buffer);
 
+    m_stats.AddBytes(Operation::WriteFile, 0, buffer.Length());
     promise.Resolve();
 }
 catch (const hresult_error& ex)
@@ -652,11 +1199,13 @@ catch (const hresult_error& ex)
     hresult result{ ex.code() };
     if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) // FileNotFoundException
     {
+        m_stats.Fail(Operation::WriteFile, "ENOENT");
         promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
     }
     else
     {
         // Failed to write to file."
+        m_stats.Fail(Operation::WriteFile, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
 }
@@ -665,41 +1214,73 @@ catch (const hresult_error& ex)
 winrt::fire_and_forget RNFSManager::appendFile(std::string filepath, std::string base64Content, RN::ReactPromise<void> promise) noexcept
 try
 {
+    // Held by the completion, so a coalesced append is timed until its shared write is done
+    auto scope{ std::make_shared<OperationScope>(m_stats, Operation::AppendFile) };
     size_t fileLength = filepath.length();
     bool hasTrailingSlash{ filepath[fileLength - 1] == '\\' || filepath[fileLength - 1] == '/' };
     std::filesystem::path path(hasTrailingSlash ? filepath.substr(0, fileLength - 1) : filepath);
 
-    winrt::hstring directoryPath, fileName;
-    splitPath(filepath, directoryPath, fileName);
+    //Taken before the first suspension, so appends to a file land in the order they were called
+    auto lease{ m_appends.Reserve(path.make_preferred()) };
 
-    StorageFolder folder{ co_await StorageFolder::GetFolderFromPathAsync(directoryPath) };
-    StorageFile file{ co_await folder.CreateFileAsync(fileName, CreationCollisionOption::OpenIfExists) };
-
-    winrt::hstring base64ContentStr{ winrt::to_hstring(base64Content) };
-    Streams::IBuffer buffer{ Cryptography::CryptographicBuffer::DecodeFromBase64String(base64ContentStr) };
-    Streams::IRandomAccessStream stream{ co_await file.OpenAsync(FileAccessMode::ReadWrite) };
-
-    stream.Seek(stream.Size()); // Writes to end of file
-    co_await stream.WriteAsync(buffer);
-
-    promise.Resolve();
+    bool submitted{ false };
+    try
+    {
+        auto slot{ co_await m_io.Schedule(TransferPriority::Normal) };
+        Streams::IBuffer buffer{ Cryptography::CryptographicBuffer::DecodeFromBase64String(winrt::to_hstring(base64Content)) };
+        std::vector<uint8_t> bytes(buffer.data(), buffer.data() + buffer.Length());
+
+        // Appends queued behind this one, or within the coalescing delay, share its write
+        auto size{ bytes.size() };
+        submitted = true;
+        m_appends.Submit(lease, std::move(bytes), [this, promise, filepath, size, scope](hresult result)
+            {
+                if (result == S_OK)
+                {
+                    m_stats.AddBytes(Operation::AppendFile, 0, size);
+                    promise.Resolve();
+                }
+                else if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) || result == HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND))
+                {
+                    m_stats.Fail(Operation::AppendFile, "ENOENT");
+                    promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
+                }
+                else
+                {
+                    m_stats.Fail(Operation::AppendFile, "Error");
+                    promise.Reject(winrt::to_string(hresult_error{ result }.message()).c_str());
+                }
+            });
+    }
+    catch (const hresult_error&)
+    {
+        if (!submitted)
+        {
+            m_appends.Skip(lease); // the appends after this one still go through
+        }
+        throw;
+    }
 }
 catch (const hresult_error& ex)
 {
     hresult result{ ex.code() };
     if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) // FileNotFoundException
     {
+        m_stats.Fail(Operation::AppendFile, "ENOENT");
         promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
     }
     else
     {
         // "Failed to append to file."
+        m_stats.Fail(Operation::AppendFile, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
 }
 winrt::fire_and_forget RNFSManager::write(std::string filepath, std::string base64Content, int position, RN::ReactPromise<void> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::Write };
+    auto slot{ co_await m_io.Schedule(TransferPriority::Normal) };
     winrt::hstring directoryPath, fileName;
     splitPath(filepath, directoryPath, fileName);
 
@@ -719,6 +1300,7 @@ try
         stream.Seek(position);
     }
     co_await stream.WriteAsync(buffer);
+    m_stats.AddBytes(Operation::Write, 0, buffer.Length());
     promise.Resolve();
 }
 catch (const hresult_error& ex)
@@ -726,20 +1308,289 @@ catch (const hresult_error& ex)
     hresult result{ ex.code() };
     if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) // FileNotFoundException
     {
+        m_stats.Fail(Operation::Write, "ENOENT");
         promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
     }
     else
     {
         // Failed to write to file."
+        m_stats.Fail(Operation::Write, "Error");
+        promise.Reject(winrt::to_string(ex.message()).c_str());
+    }
+}
+
+
+//
+// For write sessions
+//
+static RN::ReactError bad_session_error(int32_t sessionId)
+{
+    return RN::ReactError{ "EBADF", "EBADF: no open write session " + std::to_string(sessionId) };
+}
+
+winrt::fire_and_forget RNFSManager::openWrite(std::string filepath, RN::JSValueObject options, RN::ReactPromise<int32_t> promise) noexcept
+try
+{
+    OperationScope scope{ m_stats, Operation::OpenWrite };
+    auto slot{ co_await m_io.Schedule(io_priority(options, TransferPriority::Normal)) };
+    std::filesystem::path path(filepath);
+    path.make_preferred();
+
+    bool append{ options["append"].AsBoolean() };
+    auto bufferSize{ options["bufferSize"].IsNull() ? WriteSession::DefaultBufferSize :
+        static_cast<size_t>(std::clamp<int64_t>(options["bufferSize"].AsInt64(), 0, MaxWriteSessionBufferSize)) };
+    auto idleTimeout{ options["idleTimeout"].IsNull() ? WriteSessionTable::DefaultIdleTimeout :
+        std::chrono::milliseconds{ std::max<int64_t>(options["idleTimeout"].AsInt64(), 0) } };
+
+    promise.Resolve(m_writeSessions.Add(std::make_shared<WriteSession>(path, append, bufferSize), idleTimeout));
+}
+catch (const hresult_error& ex)
+{
+    hresult result{ ex.code() };
+    if (result == HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND))
+    {
+        m_stats.Fail(Operation::OpenWrite, "ENOENT");
+        promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
+    }
+    else
+    {
+        m_stats.Fail(Operation::OpenWrite, "Error");
+        promise.Reject(winrt::to_string(ex.message()).c_str());
+    }
+}
+
+winrt::fire_and_forget RNFSManager::writeChunk(int32_t sessionId, std::string base64Content, RN::ReactPromise<void> promise) noexcept
+try
+{
+    // Held by the completion, so the time spent queued behind earlier chunks counts too
+    auto scope{ std::make_shared<OperationScope>(m_stats, Operation::WriteChunk) };
+
+    //Taken before the first suspension, so chunks reach the file in the order they were called
+    auto lease{ m_writeSessions.Reserve(sessionId) };
+    if (!lease.session)
+    {
+        m_stats.Fail(Operation::WriteChunk, "EBADF");
+        promise.Reject(bad_session_error(sessionId));
+        co_return;
+    }
+
+    bool submitted{ false };
+    try
+    {
+        auto slot{ co_await m_io.Schedule(TransferPriority::Normal) };
+        Streams::IBuffer buffer{ Cryptography::CryptographicBuffer::DecodeFromBase64String(winrt::to_hstring(base64Content)) };
+        std::vector<uint8_t> bytes(buffer.data(), buffer.data() + buffer.Length());
+
+        auto size{ bytes.size() };
+        submitted = true;
+        lease.session->Submit(lease.ticket, std::move(bytes), [this, promise, size, scope](hresult result)
+            {
+                if (result == S_OK)
+                {
+                    m_stats.AddBytes(Operation::WriteChunk, 0, size);
+                    promise.Resolve();
+                }
+                else
+                {
+                    m_stats.Fail(Operation::WriteChunk, "Error");
+                    promise.Reject(winrt::to_string(hresult_error{ result }.message()).c_str());
+                }
+            });
+    }
+    catch (const hresult_error&)
+    {
+        if (!submitted)
+        {
+            lease.session->Skip(lease.ticket); // the chunks after this one still go through
+        }
+        throw;
+    }
+}
+catch (const hresult_error& ex)
+{
+    m_stats.Fail(Operation::WriteChunk, "Error");
+    promise.Reject(winrt::to_string(ex.message()).c_str());
+}
+
+winrt::fire_and_forget RNFSManager::closeWrite(int32_t sessionId, RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept
+try
+{
+    auto scope{ std::make_shared<OperationScope>(m_stats, Operation::CloseWrite) };
+
+    //Likewise, the close follows every chunk called before it
+    auto lease{ m_writeSessions.Remove(sessionId) };
+    if (!lease.session)
+    {
+        m_stats.Fail(Operation::CloseWrite, "EBADF");
+        promise.Reject(bad_session_error(sessionId));
+        co_return;
+    }
+
+    auto session{ lease.session };
+    bool submitted{ false };
+    try
+    {
+        auto slot{ co_await m_io.Schedule(TransferPriority::Normal) };
+        submitted = true;
+        session->SubmitClose(lease.ticket, options["fsync"].AsBoolean(), [this, promise, session, scope](hresult result)
+            {
+                if (result == S_OK)
+                {
+                    promise.Resolve(RN::JSValueObject{ { "bytesWritten", session->BytesWritten() } });
+                }
+                else
+                {
+                    m_stats.Fail(Operation::CloseWrite, "Error");
+                    promise.Reject(winrt::to_string(hresult_error{ result }.message()).c_str());
+                }
+            });
+    }
+    catch (const hresult_error&)
+    {
+        if (!submitted)
+        {
+            // The session is already out of the table, so nothing else would ever close its file
+            session->SubmitClose(lease.ticket, false, [](hresult) {});
+        }
+        throw;
+    }
+}
+catch (const hresult_error& ex)
+{
+    m_stats.Fail(Operation::CloseWrite, "Error");
+    promise.Reject(winrt::to_string(ex.message()).c_str());
+}
+
+
+//
+// For read sessions
+//
+winrt::fire_and_forget RNFSManager::openRead(std::string filepath, RN::JSValueObject options, RN::ReactPromise<int32_t> promise) noexcept
+try
+{
+    OperationScope scope{ m_stats, Operation::OpenRead };
+    auto priority{ io_priority(options, TransferPriority::Normal) };
+    auto slot{ co_await m_io.Schedule(priority) };
+    std::filesystem::path path(filepath);
+    path.make_preferred();
+
+    auto chunkSize{ options["chunkSize"].IsNull() ? ReadSession::DefaultChunkSize :
+        static_cast<size_t>(std::clamp<int64_t>(options["chunkSize"].AsInt64(), 1, MaxReadSessionChunkSize)) };
+    auto readAhead{ options["readAhead"].IsNull() ? ReadSession::DefaultReadAhead :
+        static_cast<size_t>(std::clamp<int64_t>(options["readAhead"].AsInt64(), 0, MaxReadSessionReadAhead)) };
+    auto idleTimeout{ options["idleTimeout"].IsNull() ? ReadSessionTable::DefaultIdleTimeout :
+        std::chrono::milliseconds{ std::max<int64_t>(options["idleTimeout"].AsInt64(), 0) } };
+
+    auto session{ ReadSession::Open(path, m_io, chunkSize, readAhead, priority) };
+    promise.Resolve(m_readSessions.Add(std::move(session), idleTimeout));
+}
+catch (const hresult_error& ex)
+{
+    hresult result{ ex.code() };
+    if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND) || result == HRESULT_FROM_WIN32(ERROR_PATH_NOT_FOUND))
+    {
+        m_stats.Fail(Operation::OpenRead, "ENOENT");
+        promise.Reject(RN::ReactError{ "ENOENT", "ENOENT: no such file or directory, open " + filepath });
+    }
+    else
+    {
+        m_stats.Fail(Operation::OpenRead, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
 }
 
+void RNFSManager::readChunk(int32_t sessionId, RN::ReactPromise<RN::JSValueObject> promise) noexcept
+try
+{
+    // Held by the completion, so a chunk that was not read ahead yet is timed until it is
+    auto scope{ std::make_shared<OperationScope>(m_stats, Operation::ReadChunk) };
+    auto session{ m_readSessions.Find(sessionId) };
+    if (!session)
+    {
+        m_stats.Fail(Operation::ReadChunk, "EBADF");
+        promise.Reject(RN::ReactError{ "EBADF", "EBADF: no open read session " + std::to_string(sessionId) });
+        return;
+    }
+
+    //Usually read ahead already; otherwise resolved by the read once it is done
+    session->Next([this, promise, sessionId, scope](ReadSession::Chunk chunk)
+        {
+            if (chunk.error == HRESULT_FROM_WIN32(ERROR_OPERATION_ABORTED))
+            {
+                m_stats.Fail(Operation::ReadChunk, "EBADF");
+                promise.Reject(RN::ReactError{ "EBADF", "EBADF: read session " + std::to_string(sessionId) + " was closed" });
+            }
+            else if (chunk.error != S_OK)
+            {
+                m_stats.Fail(Operation::ReadChunk, "Error");
+                promise.Reject(winrt::to_string(hresult_error{ chunk.error }.message()).c_str());
+            }
+            else
+            {
+                m_stats.AddBytes(Operation::ReadChunk, chunk.bytes.size(), 0);
+                auto data{ Cryptography::CryptographicBuffer::EncodeToBase64String(
+                    Cryptography::CryptographicBuffer::CreateFromByteArray(chunk.bytes)) };
+                promise.Resolve(RN::JSValueObject{ { "data", winrt::to_string(data) }, { "eof", chunk.eof } });
+            }
+        });
+}
+catch (const hresult_error& ex)
+{
+    m_stats.Fail(Operation::ReadChunk, "Error");
+    promise.Reject(winrt::to_string(ex.message()).c_str());
+}
+
+void RNFSManager::closeRead(int32_t sessionId, RN::ReactPromise<void> promise) noexcept
+{
+    OperationScope scope{ m_stats, Operation::CloseRead };
+    if (!m_readSessions.Remove(sessionId))
+    {
+        m_stats.Fail(Operation::CloseRead, "EBADF");
+        promise.Reject(RN::ReactError{ "EBADF", "EBADF: no open read session " + std::to_string(sessionId) });
+        return;
+    }
+    promise.Resolve();
+}
+
+
+// retry: { maxAttempts, initialDelay, maxDelay, retryableStatusCodes }, shared by downloads and uploads;
+// `fallback` applies when the option is absent
+static RetryPolicy retry_policy(RN::JSValueObject const& options, RetryPolicy fallback = {})
+{
+    auto const& retry{ options["retry"].AsObject() };
+    if (retry.empty())
+    {
+        return fallback;
+    }
+
+    RetryPolicy policy;
+    policy.maxAttempts = retry["maxAttempts"].IsNull() ? 3 : static_cast<uint32_t>(std::clamp<int64_t>(retry["maxAttempts"].AsInt64(), 1, 100));
+    if (!retry["initialDelay"].IsNull())
+    {
+        policy.initialDelay = std::chrono::milliseconds{ std::max<int64_t>(retry["initialDelay"].AsInt64(), 0) };
+    }
+    if (!retry["maxDelay"].IsNull())
+    {
+        policy.maxDelay = std::chrono::milliseconds{ std::max<int64_t>(retry["maxDelay"].AsInt64(), 0) };
+    }
+    if (!retry["retryableStatusCodes"].IsNull())
+    {
+        policy.retryableStatusCodes.clear();
+        for (auto const& code : retry["retryableStatusCodes"].AsArray())
+        {
+            policy.retryableStatusCodes.push_back(code.AsInt32());
+        }
+    }
+    return policy;
+}
 
 winrt::fire_and_forget RNFSManager::downloadFile(RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept
 {
+    OperationScope scope{ m_stats, Operation::DownloadFile };
     //JobID
     auto jobId{ options["jobId"].AsInt32() };
+    auto job{ m_jobs.Add(jobId) };
+    job_remover removeJob{ m_jobs, m_bandwidth, jobId };
     try
     {
         //Filepath
@@ -747,6 +1598,7 @@ winrt::fire_and_forget RNFSManager::downloadFile(RN::JSValueObject options, RN::
         path.make_preferred();
         if (path.filename().empty())
         {
+            m_stats.Fail(Operation::DownloadFile, "Error");
             promise.Reject("Failed to determine filename in path");
             co_return;
         }
@@ -760,11 +1612,79 @@ winrt::fire_and_forget RNFSManager::downloadFile(RN::JSValueObject options, RN::
         //Headers
         auto const& headers{ options["headers"].AsObject() };
 
+        DownloadParams params;
+        params.jobId = jobId;
+        params.job = job;
+
         //Progress Interval
-        auto progressInterval{ options["progressInterval"].AsInt64() };
+        params.progressInterval = options["progressInterval"].AsInt64();
 
         //Progress Divider
-        auto progressDivider{ options["progressDivider"].AsInt64() };
+        params.progressDivider = options["progressDivider"].AsInt64();
+
+        //Priority class, which picks the HTTP client and its connection limits
+        auto priority{ ParseTransferPriority(options["priority"].AsString()) };
+        if (!priority)
+        {
+            m_stats.Fail(Operation::DownloadFile, "Error");
+            promise.Reject(RN::ReactError{ "Error", "Invalid priority " + options["priority"].AsString() });
+            co_return;
+        }
+        params.priority = *priority;
+
+        //Timeouts: time to the response headers, and longest wait for the next piece of the body
+        params.connectionTimeout = std::chrono::milliseconds{ std::max<int64_t>(options["connectionTimeout"].AsInt64(), 0) };
+        params.readTimeout = std::chrono::milliseconds{ std::max<int64_t>(options["readTimeout"].AsInt64(), 0) };
+
+        //Retries, which resume from the last byte received rather than starting over
+        params.retry = retry_policy(options);
+
+        //Checksum, computed incrementally over the bytes written to toFile
+        auto const& checksum{ options["checksum"].AsObject() };
+        if (!checksum.empty())
+        {
+            auto algorithm{ checksum["algorithm"].AsString() };
+            auto search{ availableHashes.find(algorithm) };
+            if (search == availableHashes.end())
+            {
+                m_stats.Fail(Operation::DownloadFile, "Error");
+                promise.Reject(RN::ReactError{ "Error", "Invalid hash algorithm " + algorithm });
+                co_return;
+            }
+            params.checksumHash = search->second().CreateHash();
+
+            params.expectedChecksum = checksum["expected"].AsString();
+            std::transform(params.expectedChecksum.begin(), params.expectedChecksum.end(), params.expectedChecksum.begin(),
+                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        }
+
+        //Decompression of the response body before it is written to toFile
+        auto decompress{ options["decompress"].AsString() };
+        if (decompress == "gzip")
+        {
+            params.decompression = StreamingInflater::Format::Gzip;
+        }
+        else if (decompress == "deflate" || decompress == "auto")
+        {
+            // "deflate" bodies come both zlib wrapped and raw in the wild, so detect which one we got
+            params.decompression = StreamingInflater::Format::Auto;
+        }
+        else if (decompress == "zstd")
+        {
+            m_stats.Fail(Operation::DownloadFile, "Error");
+            promise.Reject("zstd decompression is not supported on Windows");
+            co_return;
+        }
+        else if (!decompress.empty())
+        {
+            m_stats.Fail(Operation::DownloadFile, "Error");
+            promise.Reject(RN::ReactError{ "Error", "Invalid decompression format " + decompress });
+            co_return;
+        }
+
+        //Preallocation
+        params.preallocate = options["preallocate"].AsBoolean();
+        params.maxBytesPerSecond = static_cast<uint64_t>(std::max<int64_t>(options["maxBytesPerSecond"].AsInt64(), 0));
 
         winrt::Windows::Web::Http::HttpRequestMessage request{ winrt::Windows::Web::Http::HttpMethod::Get(), uri };
         Buffer buffer{ 8 * 1024 };
@@ -778,80 +1698,261 @@ winrt::fire_and_forget RNFSManager::downloadFile(RN::JSValueObject options, RN::
         }
         request.Content(content);
 
-        co_await m_tasks.Add(jobId, ProcessDownloadRequestAsync(promise, request, filePath, jobId, progressInterval, progressDivider));
+        //HTTP cache: revalidate the stored copy of this URL instead of downloading it again
+        if (options["cache"].AsBoolean())
+        {
+            auto urlBuffer{ Cryptography::CryptographicBuffer::ConvertStringToBinary(winrt::to_hstring(fromURLString), Cryptography::BinaryStringEncoding::Utf8) };
+            params.cacheKey = Cryptography::CryptographicBuffer::EncodeToHexString(availableHashes.at("sha256")().HashData(urlBuffer));
+            std::wstring cacheFolderPath;
+            {
+                std::lock_guard lock{ m_foldersMutex };
+                cacheFolderPath = m_cacheFolderPath;
+            }
+            params.cacheFolder = co_await open_state_folder(std::move(cacheFolderPath),
+                [] { return ApplicationData::Current().LocalCacheFolder(); }, L"RNFSHttpCache");
+
+            auto metaItem{ co_await params.cacheFolder.TryGetItemAsync(params.cacheKey + L".meta") };
+            auto bodyItem{ co_await params.cacheFolder.TryGetItemAsync(params.cacheKey + L".body") };
+            if (metaItem && bodyItem)
+            {
+                // One "<header>: <value>" validator per line
+                auto lines{ co_await FileIO::ReadLinesAsync(metaItem.as<StorageFile>()) };
+                for (auto const& line : lines)
+                {
+                    std::wstring_view entry{ line };
+                    auto separator{ entry.find(L": ") };
+                    if (separator == std::wstring_view::npos)
+                    {
+                        continue;
+                    }
+
+                    auto name{ entry.substr(0, separator) };
+                    winrt::hstring value{ entry.substr(separator + 2) };
+                    if (name == L"ETag" && !request.Headers().HasKey(L"If-None-Match"))
+                    {
+                        params.cacheValidatorsSent |= request.Headers().TryAppendWithoutValidation(L"If-None-Match", value);
+                    }
+                    else if (name == L"Last-Modified" && !request.Headers().HasKey(L"If-Modified-Since"))
+                    {
+                        params.cacheValidatorsSent |= request.Headers().TryAppendWithoutValidation(L"If-Modified-Since", value);
+                    }
+                }
+            }
+        }
+
+        co_await m_jobs.Start(job, ProcessDownloadRequestAsync(promise, request, filePath, std::move(params)));
+    }
+    catch (winrt::hresult_canceled const&)
+    {
+        // The cancelled transfer has already recorded and rejected it
     }
     catch (const hresult_error& ex)
     {
         // "Failed to download file." 
+        m_stats.Fail(Operation::DownloadFile, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
-    m_tasks.Cancel(jobId);
 }
 
 
-winrt::fire_and_forget RNFSManager::uploadFiles(RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept
+winrt::fire_and_forget RNFSManager::fetchToMemory(RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept
 {
+    OperationScope scope{ m_stats, Operation::FetchToMemory };
+    //JobID
     auto jobId{ options["jobId"].AsInt32() };
+    auto job{ m_jobs.Add(jobId) };
+    job_remover removeJob{ m_jobs, m_bandwidth, jobId };
     try
     {
-        auto method{ options["method"].AsString() };
+        //URL
+        Uri uri{ winrt::to_hstring(options["fromUrl"].AsString()) };
 
-        winrt::Windows::Web::Http::HttpMethod httpMethod{ winrt::Windows::Web::Http::HttpMethod::Post() };
-        if (method.compare("POST") != 0)
+        DownloadParams params;
+        params.jobId = jobId;
+        params.job = job;
+
+        //Priority class, which picks the HTTP client and its connection limits
+        auto priority{ ParseTransferPriority(options["priority"].AsString()) };
+        if (!priority)
         {
-            if (method.compare("PUT") == 0)
-            {
-                httpMethod = winrt::Windows::Web::Http::HttpMethod::Put();
-            }
-            else
-            {
-                promise.Reject("Invalid HTTP request: neither a POST nor a PUT request.");
-                co_return;
-            }
+            m_stats.Fail(Operation::FetchToMemory, "Error");
+            promise.Reject(RN::ReactError{ "Error", "Invalid priority " + options["priority"].AsString() });
+            co_return;
         }
+        params.priority = *priority;
 
-        auto const& files{ options["files"].AsArray() };
-        uint64_t totalUploadSize = 0;
-        for (const auto& fileInfo : files)
+        //Timeouts, retries and rate limit, as for downloadFile
+        params.connectionTimeout = std::chrono::milliseconds{ std::max<int64_t>(options["connectionTimeout"].AsInt64(), 0) };
+        params.readTimeout = std::chrono::milliseconds{ std::max<int64_t>(options["readTimeout"].AsInt64(), 0) };
+        params.retry = retry_policy(options);
+        params.maxBytesPerSecond = static_cast<uint64_t>(std::max<int64_t>(options["maxBytesPerSecond"].AsInt64(), 0));
+
+        //Size cap: the whole body is held in memory and crosses the bridge in one piece
+        uint64_t maxSize{ static_cast<uint64_t>(std::max<int64_t>(options["maxSize"].AsInt64(), 0)) };
+        if (maxSize == 0)
         {
-            auto const& fileObj{ fileInfo.AsObject() };
-            auto filepath{ fileObj["filepath"].AsString() };
+            maxSize = DefaultFetchMaxSize;
+        }
 
-            winrt::hstring directoryPath, fileName;
-            splitPath(filepath, directoryPath, fileName);
+        //Encoding of the body in the result
+        auto encoding{ options["encoding"].AsString() };
+        if (!encoding.empty() && encoding != "base64" && encoding != "utf8")
+        {
+            m_stats.Fail(Operation::FetchToMemory, "Error");
+            promise.Reject(RN::ReactError{ "Error", "Invalid encoding " + encoding });
+            co_return;
+        }
 
-            try
-            {
-                StorageFolder folder{ co_await StorageFolder::GetFolderFromPathAsync(directoryPath) };
-                StorageFile file{ co_await folder.GetFileAsync(fileName) };
-                auto fileProperties{ co_await file.GetBasicPropertiesAsync() };
-                totalUploadSize += fileProperties.Size();
-            }
-            catch (...)
+        winrt::Windows::Web::Http::HttpRequestMessage request{ winrt::Windows::Web::Http::HttpMethod::Get(), uri };
+        HttpBufferContent content{ Buffer{ 0u } };
+        for (const auto& header : options["headers"].AsObject())
+        {
+            if (!request.Headers().TryAppendWithoutValidation(winrt::to_hstring(header.first), winrt::to_hstring(header.second.AsString())))
             {
-                continue;
+                content.Headers().TryAppendWithoutValidation(winrt::to_hstring(header.first), winrt::to_hstring(header.second.AsString()));
             }
         }
-        if (totalUploadSize <= 0)
-        {
-            promise.Reject("No files to upload");
-            co_return;
-        }
+        request.Content(content);
 
-        co_await m_tasks.Add(jobId, ProcessUploadRequestAsync(promise, options, httpMethod, files, jobId, totalUploadSize));
+        co_await m_jobs.Start(job, ProcessFetchRequestAsync(promise, request, std::move(params), maxSize, encoding != "utf8"));
+    }
+    catch (winrt::hresult_canceled const&)
+    {
+        // The cancelled transfer has already recorded and rejected it
     }
     catch (const hresult_error& ex)
     {
-        // "Failed to upload file."
+        m_stats.Fail(Operation::FetchToMemory, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
-    m_tasks.Cancel(jobId);
 }
 
 
-void RNFSManager::touch(std::string filepath, int64_t mtime, int64_t ctime, bool modifyCreationTime, RN::ReactPromise<std::string> promise) noexcept
+winrt::fire_and_forget RNFSManager::uploadFiles(RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept
+{
+    OperationScope scope{ m_stats, Operation::UploadFiles };
+    auto jobId{ options["jobId"].AsInt32() };
+    auto job{ m_jobs.Add(jobId) };
+    job_remover removeJob{ m_jobs, m_bandwidth, jobId };
+    try
+    {
+        auto method{ options["method"].AsString() };
+
+        winrt::Windows::Web::Http::HttpMethod httpMethod{ winrt::Windows::Web::Http::HttpMethod::Post() };
+        if (method.compare("POST") != 0)
+        {
+            if (method.compare("PUT") == 0)
+            {
+                httpMethod = winrt::Windows::Web::Http::HttpMethod::Put();
+            }
+            else
+            {
+                m_stats.Fail(Operation::UploadFiles, "Error");
+                promise.Reject("Invalid HTTP request: neither a POST nor a PUT request.");
+                co_return;
+            }
+        }
+
+        if (!ParseTransferPriority(options["priority"].AsString()))
+        {
+            m_stats.Fail(Operation::UploadFiles, "Error");
+            promise.Reject(RN::ReactError{ "Error", "Invalid priority " + options["priority"].AsString() });
+            co_return;
+        }
+
+        auto compress{ options["compress"].AsString() };
+        if (compress == "zstd")
+        {
+            m_stats.Fail(Operation::UploadFiles, "Error");
+            promise.Reject("zstd compression is not supported on Windows");
+            co_return;
+        }
+        else if (!compress.empty() && compress != "gzip")
+        {
+            m_stats.Fail(Operation::UploadFiles, "Error");
+            promise.Reject(RN::ReactError{ "Error", "Invalid compression format " + compress });
+            co_return;
+        }
+        else if (!compress.empty() && options["resumable"].AsBoolean())
+        {
+            m_stats.Fail(Operation::UploadFiles, "Error");
+            promise.Reject("Resumable uploads cannot be compressed, the server tracks offsets in the original file");
+            co_return;
+        }
+
+        auto const& files{ options["files"].AsArray() };
+        std::vector<IBuffer> partData; // decoded once here and reused by every attempt
+        uint64_t totalUploadSize = 0;
+        for (const auto& fileInfo : files)
+        {
+            auto const& fileObj{ fileInfo.AsObject() };
+            partData.push_back(upload_part_data(fileObj));
+            if (partData.back())
+            {
+                // The tus journal recognises a file by its path and modification time
+                if (options["resumable"].AsBoolean())
+                {
+                    m_stats.Fail(Operation::UploadFiles, "Error");
+                    promise.Reject("Resumable uploads need files on disk, not in-memory data");
+                    co_return;
+                }
+                totalUploadSize += partData.back().Length();
+                continue;
+            }
+            auto filepath{ fileObj["filepath"].AsString() };
+
+            winrt::hstring directoryPath, fileName;
+            splitPath(filepath, directoryPath, fileName);
+
+            try
+            {
+                StorageFolder folder{ co_await StorageFolder::GetFolderFromPathAsync(directoryPath) };
+                StorageFile file{ co_await folder.GetFileAsync(fileName) };
+                auto fileProperties{ co_await file.GetBasicPropertiesAsync() };
+                totalUploadSize += fileProperties.Size();
+            }
+            catch (...)
+            {
+                continue;
+            }
+        }
+        if (totalUploadSize <= 0)
+        {
+            m_stats.Fail(Operation::UploadFiles, "Error");
+            promise.Reject("No files to upload");
+            co_return;
+        }
+
+        if (options["resumable"].AsBoolean())
+        {
+            co_await m_jobs.Start(job, ProcessResumableUploadAsync(promise, options, files, job, totalUploadSize));
+        }
+        else if (options["parallel"].AsBoolean())
+        {
+            co_await m_jobs.Start(job, ProcessParallelUploadAsync(promise, options, httpMethod, files, partData, job, totalUploadSize));
+        }
+        else
+        {
+            co_await m_jobs.Start(job, ProcessUploadRequestAsync(promise, options, httpMethod, files, partData, job, totalUploadSize));
+        }
+    }
+    catch (winrt::hresult_canceled const&)
+    {
+        // The cancelled transfer has already recorded and rejected it
+    }
+    catch (const hresult_error& ex)
+    {
+        // "Failed to upload file."
+        m_stats.Fail(Operation::UploadFiles, "Error");
+        promise.Reject(winrt::to_string(ex.message()).c_str());
+    }
+}
+
+
+void RNFSManager::touch(std::string filepath, int64_t mtime, int64_t ctime, bool modifyCreationTime, RN::ReactPromise<std::string> promise) noexcept
 try
 {
+    OperationScope scope{ m_stats, Operation::Touch };
 
     std::filesystem::path path(filepath);
     path.make_preferred();
@@ -864,6 +1965,7 @@ try
     std::unique_ptr<void, handle_closer> handle(safe_handle(CreateFile2(actual_path, accessMode, shareMode, creationMode, nullptr)));
     if (!handle)
     {
+        m_stats.Fail(Operation::Touch, "Error");
         promise.Reject("Failed to create handle for file to touch.");
         return;
     }
@@ -882,6 +1984,7 @@ try
 
         if (SetFileTime(handle.get(), &cFileTime, nullptr, &mFileTime) == 0)
         {
+            m_stats.Fail(Operation::Touch, "Error");
             promise.Reject("Failed to set new creation time and modified time of file.");
         }
         else
@@ -893,6 +1996,7 @@ try
     {
         if (SetFileTime(handle.get(), nullptr, nullptr, &mFileTime) == 0)
         {
+            m_stats.Fail(Operation::Touch, "Error");
             promise.Reject("Failed to set new creation time and modified time of file.");
         }
         else
@@ -906,11 +2010,13 @@ catch (const hresult_error& ex)
     hresult result{ ex.code() };
     if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)) // FileNotFoundException
     {
+        m_stats.Fail(Operation::Touch, "ENOENT");
         promise.Reject("ENOENT: no such file.");
     }
     else
     {
         // "Failed to touch file."
+        m_stats.Fail(Operation::Touch, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
 }
@@ -926,212 +2032,2040 @@ void RNFSManager::splitPath(const std::string& fullPath, winrt::hstring& directo
 }
 
 
-IAsyncAction RNFSManager::ProcessDownloadRequestAsync(RN::ReactPromise<RN::JSValueObject> promise,
-    winrt::Windows::Web::Http::HttpRequestMessage request, std::wstring_view filePath, int32_t jobId, int64_t progressInterval, int64_t progressDivider)
+// A request can only be sent once, so every download attempt sends a copy of the one downloadFile built
+static HttpRequestMessage copy_request(HttpRequestMessage const& request)
 {
-    try
+    HttpRequestMessage copy{ request.Method(), request.RequestUri() };
+    for (auto const& header : request.Headers())
+    {
+        copy.Headers().TryAppendWithoutValidation(header.Key(), header.Value());
+    }
+    if (auto content{ request.Content() })
     {
-        HttpResponseMessage response = co_await m_httpClient.SendRequestAsync(request, HttpCompletionOption::ResponseHeadersRead);
-        IReference<uint64_t> contentLength{ response.Content().Headers().ContentLength() };
+        HttpBufferContent body{ Buffer{ 0u } };
+        for (auto const& header : content.Headers())
         {
-            RN::JSValueObject headersMap;
-            for (auto const& header : response.Headers())
-            {
-                headersMap[to_string(header.Key())] = to_string(header.Value());
-            }
+            body.Headers().TryAppendWithoutValidation(header.Key(), header.Value());
+        }
+        copy.Content(body);
+    }
+    return copy;
+}
 
-            m_reactContext.CallJSFunction(L"RCTDeviceEventEmitter", L"emit", L"DownloadBegin",
-                RN::JSValueObject{
-                    { "jobId", jobId },
-                    { "statusCode", (int)response.StatusCode() },
-                    { "contentLength", contentLength.Type() == PropertyType::UInt64 ? RN::JSValue(contentLength.Value()) : RN::JSValue{nullptr} },
-                    { "headers", std::move(headersMap) },
-                });
+// HttpClient does not tell when the connection is up, so the wait for the response headers is allowed
+// connectionTimeout to connect plus readTimeout for the server to answer, rather than connectionTimeout
+// alone, which a slow server would exceed. Without a readTimeout it is not bounded, like the reads.
+static std::chrono::milliseconds header_timeout(DownloadParams const& params) noexcept
+{
+    if (params.readTimeout.count() == 0)
+    {
+        return std::chrono::milliseconds{ 0 };
+    }
+    return params.connectionTimeout + params.readTimeout;
+}
+
+static std::optional<std::chrono::milliseconds> retry_after(HttpResponseMessage const& response)
+{
+    try
+    {
+        auto value{ response.Headers().RetryAfter() };
+        if (value && value.Delta())
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(value.Delta().Value());
+        }
+        if (value && value.Date())
+        {
+            return std::max(std::chrono::milliseconds{ 0 },
+                std::chrono::duration_cast<std::chrono::milliseconds>(value.Date().Value() - winrt::clock::now()));
         }
+    }
+    catch (const hresult_error&)
+    {
+        // A malformed Retry-After is ignored
+    }
+    return std::nullopt;
+}
 
-        uint64_t totalRead{ 0 };
+// The If-Range validator that lets a retry continue `response` with a Range request, or an empty
+// string when it has to start over. Bodies the connection decoded cannot be resumed, as the byte
+// offsets we know are not the ones the server would count.
+static winrt::hstring resume_validator(HttpResponseMessage const& response)
+{
+    auto const& contentHeaders{ response.Content().Headers() };
+    if (response.StatusCode() != HttpStatusCode::Ok || contentHeaders.ContentEncoding().Size() > 0)
+    {
+        return {};
+    }
+    if (response.Headers().HasKey(L"ETag"))
+    {
+        auto etag{ response.Headers().Lookup(L"ETag") };
+        if (std::wstring_view{ etag }.substr(0, 2) != L"W/") // If-Range requires a strong validator
+        {
+            return etag;
+        }
+    }
+    if (contentHeaders.HasKey(L"Last-Modified"))
+    {
+        return contentHeaders.Lookup(L"Last-Modified");
+    }
+    return {};
+}
 
+IAsyncAction RNFSManager::ProcessDownloadRequestAsync(RN::ReactPromise<RN::JSValueObject> promise,
+    winrt::Windows::Web::Http::HttpRequestMessage request, std::wstring_view filePath, DownloadParams params)
+{
+    auto jobId{ params.jobId };
+    auto bandwidth{ m_bandwidth.Track(jobId, params.maxBytesPerSecond) };
+    TransferWatchdog watchdog;
+    try
+    {
+        // Stream into a sibling temp file and rename it over filePath once complete, so that
+        // readers never observe a truncated file after a failed or cancelled download.
         std::filesystem::path fsFilePath{ filePath };
+        std::wstring tempFileName{ fsFilePath.filename().wstring() + L"." + std::to_wstring(jobId) + L".download" };
+        partial_file_remover partialFile{ (fsFilePath.parent_path() / tempFileName).wstring() };
 
         StorageFolder storageFolder{ co_await StorageFolder::GetFolderFromPathAsync(fsFilePath.parent_path().wstring()) };
-        StorageFile storageFile{ co_await storageFolder.CreateFileAsync(fsFilePath.filename().wstring(), CreationCollisionOption::ReplaceExisting) };
-        IRandomAccessStream  stream{ co_await storageFile.OpenAsync(FileAccessMode::ReadWrite) };
-        IOutputStream outputStream{ stream.GetOutputStreamAt(0) };
 
-        auto contentStream = co_await response.Content().ReadAsInputStreamAsync();
-        auto contentLengthForProgress = contentLength.Type() == PropertyType::UInt64 ? contentLength.Value() : -1;
-        
+        HttpResponseMessage response{ nullptr }; // the response that started the body being written
+        IReference<uint64_t> contentLength{ nullptr };
+        winrt::hstring resumeValidator;
+        uint64_t totalRead{ 0 };    // bytes received, before decompression
+        uint64_t totalWritten{ 0 }; // bytes written to filePath
+
+        StorageFile storageFile{ nullptr };
+        IRandomAccessStream stream{ nullptr };
+        IOutputStream outputStream{ nullptr };
+        std::unique_ptr<void, handle_closer> allocationHandle;
+        std::optional<StreamingInflater> inflater;
+        std::vector<uint8_t> inflated;
+        Buffer inflatedBuffer{ 0u };
+
         Buffer buffer{ 8 * 1024 };
         uint32_t read = 0;
         int64_t initialProgressTime{ winrt::clock::now().time_since_epoch().count() / 10000 };
         int64_t currentProgressTime;
-        uint64_t progressDividerUnsigned{ uint64_t(progressDivider) };
+        uint64_t progressDividerUnsigned{ uint64_t(params.progressDivider) };
+
+        auto emitProgress = [&]()
+        {
+            m_events.PostProgress("DownloadProgress", jobId,
+                RN::JSValueObject{
+                    { "jobId", jobId },
+                    { "contentLength", contentLength.Type() == PropertyType::UInt64 ? RN::JSValue(contentLength.Value()) : RN::JSValue{nullptr} },
+                    { "bytesWritten", totalWritten },
+                    { "bytesRead", totalRead },
+                });
+        };
 
+        uint32_t attempt{ 0 };
+        std::optional<std::chrono::milliseconds> retryDelay;
         for (;;)
         {
-            buffer.Length(0);
-            auto readBuffer = co_await contentStream.ReadAsync(buffer, buffer.Capacity(), InputStreamOptions::None);
-            read = readBuffer.Length();
-            if (readBuffer.Length() == 0)
+            if (retryDelay)
             {
-                break;
+                params.job->SetState(JobState::Paused);
+                co_await winrt::resume_after(*retryDelay);
+                params.job->SetState(JobState::Running);
+                retryDelay.reset();
             }
+            ++attempt;
+
+            std::exception_ptr failure; // rethrown when the attempt is not retried
+            bool awaitingNetwork{ false };
+            try
+            {
+                //Resume where the previous attempt stopped if the server can tell us that nothing changed
+                auto attemptRequest{ copy_request(request) };
+                bool resuming{ response && totalRead > 0 && !resumeValidator.empty() && !request.Headers().HasKey(L"Range") };
+                if (resuming)
+                {
+                    attemptRequest.Headers().TryAppendWithoutValidation(L"Range", L"bytes=" + winrt::to_hstring(totalRead) + L"-");
+                    attemptRequest.Headers().TryAppendWithoutValidation(L"If-Range", resumeValidator);
+                }
+
+                watchdog.Reset();
+                awaitingNetwork = true;
+                auto sendOperation{ m_httpClients.Get(params.priority).SendRequestAsync(attemptRequest, HttpCompletionOption::ResponseHeadersRead) };
+                watchdog.Watch(sendOperation, header_timeout(params));
+                HttpResponseMessage attemptResponse = co_await sendOperation;
+                awaitingNetwork = false;
 
-            co_await outputStream.WriteAsync(readBuffer);
-            totalRead += read;
+                auto statusCode{ int32_t(attemptResponse.StatusCode()) };
+                if (params.retry.IsRetryableStatus(statusCode))
+                {
+                    retryDelay = params.retry.Delay(attempt, retry_after(attemptResponse));
+                    if (retryDelay)
+                    {
+                        attemptResponse.Close();
+                        continue;
+                    }
+                }
+
+                auto contentRange{ attemptResponse.Content().Headers().ContentRange() };
+                if (resuming && attemptResponse.StatusCode() == HttpStatusCode::PartialContent &&
+                    contentRange && contentRange.FirstBytePosition() && contentRange.FirstBytePosition().Value() == totalRead)
+                {
+                    // Keep appending; the hash and the decompressor continue where they were
+                }
+                else if (response && attemptResponse.StatusCode() == response.StatusCode())
+                {
+                    // The resource changed, ranges are not supported, or we could not ask for one: start over
+                    response = attemptResponse;
+                    contentLength = response.Content().Headers().ContentLength();
+                    resumeValidator = resume_validator(response);
+                    totalRead = 0;
+                    totalWritten = 0;
+                    stream.Size(0);
+                    outputStream = stream.GetOutputStreamAt(0);
+                    if (params.checksumHash)
+                    {
+                        params.checksumHash.GetValueAndReset();
+                    }
+                    if (params.decompression)
+                    {
+                        inflater.emplace(*params.decompression);
+                    }
+                }
+                else if (response)
+                {
+                    std::stringstream ss;
+                    ss << "Failed to resume job '" << jobId << "' at byte " << totalRead << ", server answered " << statusCode;
+                    m_stats.Fail(Operation::DownloadFile, "Error");
+                    promise.Reject(RN::ReactError{ "Error", ss.str() });
+                    co_return;
+                }
+                else
+                {
+                    response = attemptResponse;
+                    contentLength = response.Content().Headers().ContentLength();
+                    resumeValidator = resume_validator(response);
+                    {
+                        RN::JSValueObject headersMap;
+                        for (auto const& header : response.Headers())
+                        {
+                            headersMap[to_string(header.Key())] = to_string(header.Value());
+                        }
+
+                        m_events.Post("DownloadBegin",
+                            RN::JSValueObject{
+                                { "jobId", jobId },
+                                { "statusCode", (int)response.StatusCode() },
+                                { "contentLength", contentLength.Type() == PropertyType::UInt64 ? RN::JSValue(contentLength.Value()) : RN::JSValue{nullptr} },
+                                { "headers", std::move(headersMap) },
+                            });
+                    }
+
+                    if (params.cacheValidatorsSent && response.StatusCode() == HttpStatusCode::NotModified)
+                    {
+                        // Our copy is still current: serve it through the same temp file + rename commit
+                        StorageFile cachedBody{ co_await params.cacheFolder.GetFileAsync(params.cacheKey + L".body") };
+                        StorageFile cachedCopy{ co_await cachedBody.CopyAsync(storageFolder, tempFileName, NameCollisionOption::ReplaceExisting) };
+
+                        if (params.checksumHash)
+                        {
+                            IInputStream cachedStream{ co_await cachedCopy.OpenSequentialReadAsync() };
+                            Buffer cachedBuffer{ 64 * 1024 };
+                            for (;;)
+                            {
+                                cachedBuffer.Length(0);
+                                auto readBuffer = co_await cachedStream.ReadAsync(cachedBuffer, cachedBuffer.Capacity(), InputStreamOptions::None);
+                                if (readBuffer.Length() == 0)
+                                {
+                                    break;
+                                }
+                                params.checksumHash.Append(readBuffer);
+                            }
+                            cachedStream.Close();
+
+                            auto actualChecksum{ winrt::to_string(Cryptography::CryptographicBuffer::EncodeToHexString(params.checksumHash.GetValueAndReset())) };
+                            if (actualChecksum != params.expectedChecksum)
+                            {
+                                co_await cachedCopy.DeleteAsync();
+
+                                std::stringstream ss;
+                                ss << "EINTEGRITY: checksum mismatch for job '" << jobId << "', expected '" << params.expectedChecksum
+                                   << "' but got '" << actualChecksum << "' from the download cache";
+                                m_stats.Fail(Operation::DownloadFile, "EINTEGRITY");
+                                promise.Reject(RN::ReactError{ "EINTEGRITY", ss.str() });
+                                co_return;
+                            }
+                        }
+
+                        co_await cachedCopy.RenameAsync(fsFilePath.filename().wstring(), NameCollisionOption::ReplaceExisting);
+                        partialFile.committed = true;
+
+                        auto cachedSize{ (co_await cachedCopy.GetBasicPropertiesAsync()).Size() };
+                        ++m_cacheHits;
+                        m_cacheBytesServed += cachedSize;
+                        try
+                        {
+                            co_await RefreshDownloadCache(params.cacheFolder, params.cacheKey, response);
+                        }
+                        catch (const hresult_error&)
+                        {
+                            // The copy was served; its validators stay as they were
+                        }
+
+                        m_events.Flush(); // the progress events go out before the result
+                        promise.Resolve(RN::JSValueObject
+                            {
+                                { "jobId", jobId },
+                                { "statusCode", (int)response.StatusCode() },
+                                { "bytesWritten", cachedSize },
+                                { "bytesRead", 0 },
+                                { "fromCache", true },
+                                { "attempts", attempt },
+                            });
+                        co_return;
+                    }
+
+                    storageFile = co_await storageFolder.CreateFileAsync(tempFileName, CreationCollisionOption::ReplaceExisting);
+
+                    if (params.decompression)
+                    {
+                        inflater.emplace(*params.decompression);
+                    }
+
+                    // Reserve the announced length up front instead of growing the file 8K at a time, which
+                    // fragments large downloads and costs a metadata update per extension. The reservation only
+                    // lives as long as this handle, so it stays open until the download is complete.
+                    if (params.preallocate && !inflater && contentLength.Type() == PropertyType::UInt64 && contentLength.Value() > 0)
+                    {
+                        allocationHandle.reset(safe_handle(CreateFile2(partialFile.path.c_str(), GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, OPEN_EXISTING, nullptr)));
+                        if (allocationHandle)
+                        {
+                            FILE_ALLOCATION_INFO allocation{};
+                            allocation.AllocationSize.QuadPart = static_cast<LONGLONG>(contentLength.Value());
+                            SetFileInformationByHandle(allocationHandle.get(), FileAllocationInfo, &allocation, sizeof(allocation)); // best effort
+                        }
+                    }
+
+                    stream = co_await storageFile.OpenAsync(FileAccessMode::ReadWrite, StorageOpenOptions::AllowReadersAndWriters);
+                    outputStream = stream.GetOutputStreamAt(0);
+                }
+
+                auto contentLengthForProgress = contentLength.Type() == PropertyType::UInt64 ? contentLength.Value() : -1;
+                params.job->Progress(totalRead, contentLength.Type() == PropertyType::UInt64 ? contentLength.Value() : 0);
+                awaitingNetwork = true;
+                auto contentStream = co_await attemptResponse.Content().ReadAsInputStreamAsync();
+                awaitingNetwork = false;
 
-            if (progressInterval > 0)
+                for (;;)
+                {
+                    buffer.Length(0);
+                    auto readOperation{ contentStream.ReadAsync(buffer, buffer.Capacity(), InputStreamOptions::Partial) };
+                    watchdog.Watch(readOperation, params.readTimeout);
+                    awaitingNetwork = true;
+                    auto readBuffer = co_await readOperation;
+                    awaitingNetwork = false;
+                    read = readBuffer.Length();
+
+                    IBuffer chunk{ readBuffer };
+                    if (inflater)
+                    {
+                        inflated.clear();
+                        if (read == 0)
+                        {
+                            inflater->Finish(inflated);
+                        }
+                        else
+                        {
+                            inflater->Write(readBuffer.data(), read, inflated);
+                        }
+
+                        auto inflatedSize{ static_cast<uint32_t>(inflated.size()) };
+                        if (inflatedBuffer.Capacity() < inflatedSize)
+                        {
+                            inflatedBuffer = Buffer{ inflatedSize };
+                        }
+                        std::copy(inflated.begin(), inflated.end(), inflatedBuffer.data());
+                        inflatedBuffer.Length(inflatedSize);
+                        chunk = inflatedBuffer;
+                    }
+
+                    if (chunk.Length() > 0)
+                    {
+                        co_await outputStream.WriteAsync(chunk);
+                        totalWritten += chunk.Length();
+
+                        if (params.checksumHash)
+                        {
+                            params.checksumHash.Append(chunk);
+                        }
+                    }
+
+                    if (read == 0)
+                    {
+                        break;
+                    }
+                    totalRead += read;
+                    params.job->Progress(totalRead);
+
+                    // Bandwidth shaping: pay for what was just received before reading more
+                    auto throttleDelay{ m_bandwidth.Acquire(jobId, read) };
+                    if (throttleDelay.count() > 0)
+                    {
+                        co_await winrt::resume_after(throttleDelay);
+                    }
+
+                    if (params.progressInterval > 0)
+                    {
+                        currentProgressTime = winrt::clock::now().time_since_epoch().count() / 10000;
+                        if(currentProgressTime - initialProgressTime >= params.progressInterval)
+                        {
+                            emitProgress();
+                            initialProgressTime = winrt::clock::now().time_since_epoch().count() / 10000;
+                        }
+                    }
+                    else if (params.progressDivider <= 0)
+                    {
+                        emitProgress();
+                    }
+                    else
+                    {
+                        if (totalRead * 100 / contentLengthForProgress >= progressDividerUnsigned ||
+                            totalRead == contentLengthForProgress) {
+                            emitProgress();
+                        }
+                    }
+                }
+            }
+            catch (winrt::hresult_canceled const&)
             {
-                currentProgressTime = winrt::clock::now().time_since_epoch().count() / 10000;
-                if(currentProgressTime - initialProgressTime >= progressInterval)
+                if (!watchdog.Expired())
                 {
-                    m_reactContext.CallJSFunction(L"RCTDeviceEventEmitter", L"emit", L"DownloadProgress",
-                        RN::JSValueObject{
-                            { "jobId", jobId },
-                            { "contentLength", contentLength.Type() == PropertyType::UInt64 ? RN::JSValue(contentLength.Value()) : RN::JSValue{nullptr} },
-                            { "bytesWritten", totalRead },
-                        });
-                    initialProgressTime = winrt::clock::now().time_since_epoch().count() / 10000;
+                    throw;
                 }
+                failure = std::current_exception();
             }
-            else if (progressDivider <= 0)
+            catch (const hresult_error&)
             {
-                m_reactContext.CallJSFunction(L"RCTDeviceEventEmitter", L"emit", L"DownloadProgress",
-                    RN::JSValueObject{
-                        { "jobId", jobId },
-                        { "contentLength", contentLength.Type() == PropertyType::UInt64 ? RN::JSValue(contentLength.Value()) : RN::JSValue{nullptr} },
-                        { "bytesWritten", totalRead },
-                    });
+                if (!awaitingNetwork)
+                {
+                    throw;
+                }
+                failure = std::current_exception();
             }
-            else
+
+            if (!failure)
             {
-                if (totalRead * 100 / contentLengthForProgress >= progressDividerUnsigned ||
-                    totalRead == contentLengthForProgress) {
-                    m_reactContext.CallJSFunction(L"RCTDeviceEventEmitter", L"emit", L"DownloadProgress",
-                        RN::JSValueObject{
-                            { "jobId", jobId },
-                            { "contentLength", contentLength.Type() == PropertyType::UInt64 ? RN::JSValue(contentLength.Value()) : RN::JSValue{nullptr} },
-                            { "bytesWritten", totalRead },
-                        });
+                break;
+            }
+            retryDelay = params.retry.Delay(attempt, std::nullopt);
+            if (!retryDelay)
+            {
+                std::rethrow_exception(failure);
+            }
+        }
+
+        co_await outputStream.FlushAsync();
+        if (allocationHandle)
+        {
+            // Give back whatever the server announced but never sent
+            FILE_ALLOCATION_INFO allocation{};
+            allocation.AllocationSize.QuadPart = static_cast<LONGLONG>(totalWritten);
+            SetFileInformationByHandle(allocationHandle.get(), FileAllocationInfo, &allocation, sizeof(allocation));
+            allocationHandle.reset();
+        }
+        outputStream.Close();
+        stream.Close();
+
+        if (params.checksumHash)
+        {
+            auto actualChecksum{ winrt::to_string(Cryptography::CryptographicBuffer::EncodeToHexString(params.checksumHash.GetValueAndReset())) };
+            if (actualChecksum != params.expectedChecksum)
+            {
+                // The previous contents of filePath, if any, are left untouched
+                co_await storageFile.DeleteAsync();
+
+                std::stringstream ss;
+                ss << "EINTEGRITY: checksum mismatch for job '" << jobId << "', expected '" << params.expectedChecksum
+                   << "' but got '" << actualChecksum << "'";
+                m_stats.Fail(Operation::DownloadFile, "EINTEGRITY");
+                promise.Reject(RN::ReactError{ "EINTEGRITY", ss.str() });
+                co_return;
+            }
+        }
+
+        co_await storageFile.RenameAsync(fsFilePath.filename().wstring(), NameCollisionOption::ReplaceExisting);
+        partialFile.committed = true;
+
+        if (params.cacheFolder)
+        {
+            ++m_cacheMisses;
+            if (response.StatusCode() == HttpStatusCode::Ok)
+            {
+                try
+                {
+                    co_await StoreInDownloadCache(params.cacheFolder, params.cacheKey, storageFile, response);
+                }
+                catch (const hresult_error&)
+                {
+                    // A failure to cache must not fail a download that succeeded
                 }
             }
         }
 
+        m_stats.AddBytes(Operation::DownloadFile, totalRead, totalWritten);
+        m_events.Flush();
         promise.Resolve(RN::JSValueObject
             {
                 { "jobId", jobId },
                 { "statusCode", (int)response.StatusCode() },
-                { "bytesWritten", totalRead },
+                { "bytesWritten", totalWritten },
+                { "bytesRead", totalRead },
+                { "fromCache", false },
+                { "attempts", attempt },
             });
     }
     catch (winrt::hresult_canceled const& ex)
     {
         std::stringstream ss;
-        ss << "CANCELLED: job '" << jobId << "' to file '" << to_string(filePath) << "'";
-        promise.Reject(RN::ReactError{ std::to_string(ex.code()), ss.str(), RN::JSValueObject{} });
+        if (watchdog.Expired())
+        {
+            ss << "ETIMEDOUT: job '" << jobId << "' to file '" << to_string(filePath) << "' stopped receiving data";
+            m_stats.Fail(Operation::DownloadFile, "ETIMEDOUT");
+            promise.Reject(RN::ReactError{ "ETIMEDOUT", ss.str() });
+        }
+        else
+        {
+            ss << "CANCELLED: job '" << jobId << "' to file '" << to_string(filePath) << "'";
+            m_stats.Fail(Operation::DownloadFile, "CANCELLED");
+            promise.Reject(RN::ReactError{ std::to_string(ex.code()), ss.str(), RN::JSValueObject{} });
+        }
     }
     catch (const hresult_error& ex)
     {
+        m_stats.Fail(Operation::DownloadFile, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
+    catch (const DeflateError& ex)
+    {
+        // "Failed to decompress download."
+        m_stats.Fail(Operation::DownloadFile, "Error");
+        promise.Reject(ex.what());
+    }
 }
 
 
-IAsyncAction RNFSManager::ProcessUploadRequestAsync(RN::ReactPromise<RN::JSValueObject> promise, RN::JSValueObject& options,
-    winrt::Windows::Web::Http::HttpMethod httpMethod, RN::JSValueArray const& files, int32_t jobId, uint64_t totalUploadSize)
+//
+// For fetchToMemory: whether a body may be handed to JavaScript as a utf8 string
+//
+static bool is_valid_utf8(std::vector<uint8_t> const& bytes) noexcept
 {
+    return bytes.empty() || MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, reinterpret_cast<char const*>(bytes.data()),
+        static_cast<int>(bytes.size()), nullptr, 0) != 0;
+}
+
+IAsyncAction RNFSManager::ProcessFetchRequestAsync(RN::ReactPromise<RN::JSValueObject> promise,
+    winrt::Windows::Web::Http::HttpRequestMessage request, DownloadParams params, uint64_t maxSize, bool base64)
+{
+    auto jobId{ params.jobId };
+    auto bandwidth{ m_bandwidth.Track(jobId, params.maxBytesPerSecond) };
+    TransferWatchdog watchdog;
     try
     {
-        winrt::hstring boundary{ L"-----" };
-        std::string toUrl{ options["toUrl"].AsString() };
-        std::wstring URLForURI(toUrl.begin(), toUrl.end());
-        Uri uri{ URLForURI };
+        HttpResponseMessage response{ nullptr };
+        std::vector<uint8_t> body;
+        bool tooLarge{ false };
+        Buffer buffer{ 64 * 1024 };
 
-        winrt::Windows::Web::Http::HttpRequestMessage requestMessage{ httpMethod, uri };
-        winrt::Windows::Web::Http::HttpMultipartFormDataContent requestContent{ boundary };
-
-        auto const& headers{ options["headers"].AsObject() };
-        
-        for (auto const& entry : headers)
+        uint32_t attempt{ 0 };
+        std::optional<std::chrono::milliseconds> retryDelay;
+        for (;;)
         {
-            if (!requestMessage.Headers().TryAppendWithoutValidation(winrt::to_hstring(entry.first), winrt::to_hstring(entry.second.AsString())))
+            if (retryDelay)
             {
-                requestContent.Headers().TryAppendWithoutValidation(winrt::to_hstring(entry.first), winrt::to_hstring(entry.second.AsString()));
+                params.job->SetState(JobState::Paused);
+                co_await winrt::resume_after(*retryDelay);
+                params.job->SetState(JobState::Running);
+                retryDelay.reset();
             }
-        }
-
-        auto const& fields{ options["fields"].AsObject() }; // placed in the header
-        std::stringstream attempt;
-        attempt << "form-data";
-        for (auto const& field : fields)
-        {
-            attempt << "; " << field.first << "=" << field.second.AsString();
-        }
-
-        requestContent.Headers().ContentDisposition(Headers::HttpContentDispositionHeaderValue::Parse(winrt::to_hstring(attempt.str())));
-
-        m_reactContext.CallJSFunction(L"RCTDeviceEventEmitter", L"emit", L"UploadBegin",
-            RN::JSValueObject{
-                { "jobId", jobId },
-            });
-
-        uint64_t totalUploaded{ 0 };
-
-        for (const auto& fileInfo : files)
-        {
-            auto const& fileObj{ fileInfo.AsObject() };
-            auto name{ winrt::to_hstring(fileObj["name"].AsString()) }; // name to be sent via http request
-            auto filename{ winrt::to_hstring(fileObj["filename"].AsString()) }; // filename to be sent via http request
-            auto filepath{ fileObj["filepath"].AsString()}; // accessing the file
+            ++attempt;
 
+            // Nothing was kept from a failed attempt, so every retry starts over
+            std::exception_ptr failure;
+            bool awaitingNetwork{ false };
             try
             {
-                winrt::hstring directoryPath, fileName;
-                splitPath(filepath, directoryPath, fileName);
-                StorageFolder folder{ co_await StorageFolder::GetFolderFromPathAsync(directoryPath) };
-                StorageFile file{ co_await folder.GetFileAsync(fileName) };
-                auto properties{ co_await file.GetBasicPropertiesAsync() };
+                body.clear();
+                watchdog.Reset();
+                awaitingNetwork = true;
+                auto sendOperation{ m_httpClients.Get(params.priority).SendRequestAsync(copy_request(request), HttpCompletionOption::ResponseHeadersRead) };
+                watchdog.Watch(sendOperation, header_timeout(params));
+                response = co_await sendOperation;
+                awaitingNetwork = false;
+
+                if (params.retry.IsRetryableStatus(int32_t(response.StatusCode())))
+                {
+                    retryDelay = params.retry.Delay(attempt, retry_after(response));
+                    if (retryDelay)
+                    {
+                        response.Close();
+                        continue;
+                    }
+                }
 
-                HttpBufferContent entry{ co_await FileIO::ReadBufferAsync(file) };
-                requestContent.Add(entry, name, filename);
+                // Refuse before reading anything when the server announces more than we may hold
+                auto contentLength{ response.Content().Headers().ContentLength() };
+                if (contentLength && contentLength.Value() > maxSize)
+                {
+                    tooLarge = true;
+                    break;
+                }
+                body.reserve(contentLength ? static_cast<size_t>(contentLength.Value()) : buffer.Capacity());
 
-                totalUploaded += properties.Size();
-                m_reactContext.CallJSFunction(L"RCTDeviceEventEmitter", L"emit", L"UploadProgress",
-                    RN::JSValueObject{
-                        { "jobId", jobId },
-                        { "totalBytesExpectedToSend", totalUploadSize },   // The total number of bytes that will be sent to the server
-                        { "totalBytesSent", totalUploaded },
-                    });
+                awaitingNetwork = true;
+                auto contentStream{ co_await response.Content().ReadAsInputStreamAsync() };
+                awaitingNetwork = false;
+                for (;;)
+                {
+                    buffer.Length(0);
+                    auto readOperation{ contentStream.ReadAsync(buffer, buffer.Capacity(), InputStreamOptions::Partial) };
+                    watchdog.Watch(readOperation, params.readTimeout);
+                    awaitingNetwork = true;
+                    auto readBuffer{ co_await readOperation };
+                    awaitingNetwork = false;
+
+                    uint32_t read{ readBuffer.Length() };
+                    if (read == 0)
+                    {
+                        break;
+                    }
+                    if (body.size() + read > maxSize)
+                    {
+                        tooLarge = true;
+                        break;
+                    }
+                    body.insert(body.end(), readBuffer.data(), readBuffer.data() + read);
+                    params.job->Progress(body.size());
+
+                    // Bandwidth shaping: pay for what was just received before reading more
+                    auto throttleDelay{ m_bandwidth.Acquire(jobId, read) };
+                    if (throttleDelay.count() > 0)
+                    {
+                        co_await winrt::resume_after(throttleDelay);
+                    }
+                }
             }
-            catch (...)
+            catch (winrt::hresult_canceled const&)
             {
-                continue;
+                if (!watchdog.Expired())
+                {
+                    throw;
+                }
+                failure = std::current_exception();
+            }
+            catch (const hresult_error&)
+            {
+                if (!awaitingNetwork)
+                {
+                    throw;
+                }
+                failure = std::current_exception();
+            }
+
+            if (!failure)
+            {
+                break;
+            }
+            retryDelay = params.retry.Delay(attempt, std::nullopt);
+            if (!retryDelay)
+            {
+                std::rethrow_exception(failure);
             }
         }
 
-        requestMessage.Content(requestContent);
-        HttpResponseMessage response = co_await m_httpClient.SendRequestAsync(requestMessage, HttpCompletionOption::ResponseHeadersRead);
+        if (tooLarge)
+        {
+            response.Close();
+            std::stringstream ss;
+            ss << "EFBIG: job '" << jobId << "' response is larger than " << maxSize << " bytes";
+            m_stats.Fail(Operation::FetchToMemory, "EFBIG");
+            promise.Reject(RN::ReactError{ "EFBIG", ss.str() });
+            co_return;
+        }
 
-        auto statusCode{ std::to_string(int(response.StatusCode())) };
-        auto resultHeaders{ winrt::to_string(response.Headers().ToString()) };
-        auto resultContent{ winrt::to_string(co_await response.Content().ReadAsStringAsync()) };
+        RN::JSValueObject headers;
+        for (auto const& header : response.Headers())
+        {
+            headers[to_string(header.Key())] = to_string(header.Value());
+        }
+        for (auto const& header : response.Content().Headers())
+        {
+            headers[to_string(header.Key())] = to_string(header.Value());
+        }
+
+        std::string content;
+        if (base64)
+        {
+            content = winrt::to_string(Cryptography::CryptographicBuffer::EncodeToBase64String(
+                Cryptography::CryptographicBuffer::CreateFromByteArray(body)));
+        }
+        else if (is_valid_utf8(body))
+        {
+            content.assign(body.begin(), body.end());
+        }
+        else
+        {
+            // Passing the bytes on would garble them on the way to JavaScript
+            std::stringstream ss;
+            ss << "Job '" << jobId << "' response is not valid UTF-8, fetch it with the base64 encoding instead";
+            m_stats.Fail(Operation::FetchToMemory, "Error");
+            promise.Reject(RN::ReactError{ "Error", ss.str() });
+            co_return;
+        }
+
+        m_stats.AddBytes(Operation::FetchToMemory, body.size(), 0);
+        promise.Resolve(RN::JSValueObject
+            {
+                { "jobId", jobId },
+                { "statusCode", (int)response.StatusCode() },
+                { "headers", std::move(headers) },
+                { "body", std::move(content) },
+                { "bytesRead", static_cast<uint64_t>(body.size()) },
+                { "attempts", attempt },
+            });
+    }
+    catch (winrt::hresult_canceled const& ex)
+    {
+        std::stringstream ss;
+        if (watchdog.Expired())
+        {
+            ss << "ETIMEDOUT: job '" << jobId << "' stopped receiving data";
+            m_stats.Fail(Operation::FetchToMemory, "ETIMEDOUT");
+            promise.Reject(RN::ReactError{ "ETIMEDOUT", ss.str() });
+        }
+        else
+        {
+            ss << "CANCELLED: job '" << jobId << "'";
+            m_stats.Fail(Operation::FetchToMemory, "CANCELLED");
+            promise.Reject(RN::ReactError{ std::to_string(ex.code()), ss.str(), RN::JSValueObject{} });
+        }
+    }
+    catch (const hresult_error& ex)
+    {
+        m_stats.Fail(Operation::FetchToMemory, "Error");
+        promise.Reject(winrt::to_string(ex.message()).c_str());
+    }
+}
+
+
+// One "<header>: <value>" line for each validator the response carries, as the .meta file keeps them
+static std::vector<winrt::hstring> cache_validators(HttpResponseMessage const& response)
+{
+    std::vector<winrt::hstring> validators;
+    if (response.Headers().HasKey(L"ETag"))
+    {
+        validators.push_back(L"ETag: " + response.Headers().Lookup(L"ETag"));
+    }
+    if (response.Content() && response.Content().Headers().HasKey(L"Last-Modified"))
+    {
+        validators.push_back(L"Last-Modified: " + response.Content().Headers().Lookup(L"Last-Modified"));
+    }
+    return validators;
+}
+
+IAsyncAction RNFSManager::StoreInDownloadCache(StorageFolder cacheFolder, winrt::hstring cacheKey, StorageFile file, HttpResponseMessage response)
+{
+    winrt::hstring metaName{ cacheKey + L".meta" };
+    winrt::hstring bodyName{ cacheKey + L".body" };
+
+    // Drop the old validators first so they can never be paired with a different body
+    if (auto oldMeta{ co_await cacheFolder.TryGetItemAsync(metaName) })
+    {
+        co_await oldMeta.DeleteAsync();
+    }
+
+    auto validators{ cache_validators(response) };
+    if (validators.empty())
+    {
+        co_return; // nothing to revalidate with, so nothing worth keeping
+    }
+
+    co_await file.CopyAsync(cacheFolder, bodyName, NameCollisionOption::ReplaceExisting);
+    StorageFile meta{ co_await cacheFolder.CreateFileAsync(metaName, CreationCollisionOption::ReplaceExisting) };
+    co_await FileIO::WriteLinesAsync(meta, std::move(validators));
+}
+
+IAsyncAction RNFSManager::RefreshDownloadCache(StorageFolder cacheFolder, winrt::hstring cacheKey, HttpResponseMessage response)
+{
+    // A 304 may carry newer validators for the same body; those it leaves out are kept
+    auto validators{ cache_validators(response) };
+    if (validators.empty())
+    {
+        co_return;
+    }
+
+    StorageFile meta{ co_await cacheFolder.GetFileAsync(cacheKey + L".meta") };
+    for (auto const& line : co_await FileIO::ReadLinesAsync(meta))
+    {
+        std::wstring_view entry{ line };
+        auto name{ entry.substr(0, entry.find(L": ") + 1) };
+        if (std::none_of(validators.begin(), validators.end(), [name](auto const& validator) { return std::wstring_view{ validator }.substr(0, name.size()) == name; }))
+        {
+            validators.push_back(line);
+        }
+    }
+    co_await FileIO::WriteLinesAsync(meta, std::move(validators));
+}
+
+
+void RNFSManager::configureHttpClient(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
+{
+    auto priority{ ParseTransferPriority(options["priority"].AsString()) };
+    if (!priority)
+    {
+        promise.Reject(RN::ReactError{ "Error", "Invalid priority " + options["priority"].AsString() });
+        return;
+    }
+
+    // Only the settings given are changed
+    auto settings{ m_httpClients.Settings(*priority) };
+    if (!options["maxConnectionsPerServer"].IsNull())
+    {
+        settings.maxConnectionsPerServer = static_cast<uint32_t>(std::clamp<int64_t>(options["maxConnectionsPerServer"].AsInt64(), 1, 128));
+    }
+    if (!options["httpVersion"].IsNull())
+    {
+        auto version{ options["httpVersion"].AsString() };
+        if (version != "1.1" && version != "2")
+        {
+            promise.Reject(RN::ReactError{ "Error", "Invalid HTTP version " + version });
+            return;
+        }
+        settings.preferHttp2 = version == "2";
+    }
+    if (!options["bypassCache"].IsNull())
+    {
+        settings.bypassCache = options["bypassCache"].AsBoolean();
+    }
+    if (!options["keepAlive"].IsNull())
+    {
+        settings.keepAlive = options["keepAlive"].AsBoolean();
+    }
+
+    m_httpClients.Configure(*priority, settings);
+    promise.Resolve();
+}
+
+void RNFSManager::configureAppendCoalescing(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
+{
+    // Only the settings given are changed
+    auto settings{ m_appends.Current() };
+    if (!options["maxDelay"].IsNull())
+    {
+        settings.maxDelay = std::chrono::milliseconds{ std::clamp<int64_t>(options["maxDelay"].AsInt64(), 0, MaxAppendDelay) };
+    }
+    if (!options["maxBytes"].IsNull())
+    {
+        settings.maxBytes = static_cast<size_t>(std::clamp<int64_t>(options["maxBytes"].AsInt64(), 1, MaxAppendRunSize));
+    }
+
+    m_appends.Configure(settings);
+    promise.Resolve();
+}
+
+void RNFSManager::setBandwidthLimit(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
+{
+    auto maxBytesPerSecond{ static_cast<uint64_t>(std::max<int64_t>(options["maxBytesPerSecond"].AsInt64(), 0)) };
+    if (options["jobId"].IsNull())
+    {
+        m_bandwidth.SetGlobalLimit(maxBytesPerSecond);
+    }
+    else
+    {
+        // Kept from now until the job is removed, so it also holds for a job that has not started transferring yet
+        auto jobId{ options["jobId"].AsInt32() };
+        if (!m_jobs.Find(jobId))
+        {
+            promise.Reject(RN::ReactError{ "ESRCH", "ESRCH: no job " + std::to_string(jobId) });
+            return;
+        }
+        m_bandwidth.SetJobLimit(jobId, maxBytesPerSecond);
+        if (!m_jobs.Find(jobId))
+        {
+            m_bandwidth.Forget(jobId); // removed meanwhile, before its remover could forget the limit
+        }
+    }
+    promise.Resolve();
+}
+
+void RNFSManager::configureDownloadCache(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
+{
+    // An empty folder goes back to the default; downloads already running keep the folder they opened
+    auto folder{ winrt::to_hstring(options["folder"].AsString()) };
+    if (!folder.empty() && std::filesystem::path{ folder.c_str() }.is_relative())
+    {
+        promise.Reject(RN::ReactError{ "Error", "Invalid cache folder " + options["folder"].AsString() + ", it must be an absolute path" });
+        return;
+    }
+
+    std::lock_guard lock{ m_foldersMutex };
+    m_cacheFolderPath = folder;
+    promise.Resolve();
+}
+
+void RNFSManager::configureUploadJournal(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept
+{
+    // An empty folder goes back to the default; uploads already running keep the folder they opened
+    auto folder{ winrt::to_hstring(options["folder"].AsString()) };
+    if (!folder.empty() && std::filesystem::path{ folder.c_str() }.is_relative())
+    {
+        promise.Reject(RN::ReactError{ "Error", "Invalid journal folder " + options["folder"].AsString() + ", it must be an absolute path" });
+        return;
+    }
+
+    std::lock_guard lock{ m_foldersMutex };
+    m_journalFolderPath = folder;
+    promise.Resolve();
+}
+
+void RNFSManager::getDownloadCacheStats(RN::ReactPromise<RN::JSValueObject> promise) noexcept
+{
+    promise.Resolve(RN::JSValueObject
+        {
+            { "hits", m_cacheHits.load() },
+            { "misses", m_cacheMisses.load() },
+            { "bytesServed", m_cacheBytesServed.load() },
+        });
+}
+
+void RNFSManager::getStats(RN::ReactPromise<RN::JSValueObject> promise) noexcept
+{
+    RN::JSValueObject operations;
+    for (size_t i = 0; i < static_cast<size_t>(Operation::Count); ++i)
+    {
+        auto operation{ static_cast<Operation>(i) };
+        auto counters{ m_stats.Snapshot(operation) };
+        if (counters.calls == 0 && counters.inFlight == 0)
+        {
+            continue;
+        }
+
+        RN::JSValueArray histogram;
+        for (auto count : counters.latency)
+        {
+            histogram.push_back(count);
+        }
+        RN::JSValueObject errorCodes;
+        for (size_t code = 0; code < OperationStats::ErrorCodes.size(); ++code)
+        {
+            if (counters.errorCodes[code])
+            {
+                errorCodes[std::string{ OperationStats::ErrorCodes[code] }] = counters.errorCodes[code];
+            }
+        }
+
+        operations[std::string{ OperationStats::Name(operation) }] = RN::JSValueObject
+            {
+                { "calls", counters.calls },
+                { "inFlight", counters.inFlight },
+                { "errors", counters.errors },
+                { "errorCodes", std::move(errorCodes) },
+                { "bytesIn", counters.bytesIn },
+                { "bytesOut", counters.bytesOut },
+                { "meanMs", counters.calls ? counters.totalMicroseconds / 1000.0 / counters.calls : 0.0 },
+                { "p50Ms", counters.Percentile(0.50) / 1000.0 },
+                { "p99Ms", counters.Percentile(0.99) / 1000.0 },
+                { "histogram", std::move(histogram) },
+            };
+    }
+
+    //Events handed to JS, and the batches that carried them
+    auto events{ m_events.Snapshot() };
+
+    //Read and write sessions, including those closed for being idle
+    auto writeSessions{ m_writeSessions.Snapshot() };
+    auto readSessions{ m_readSessions.Snapshot() };
+
+    //Appends, and the writes they were coalesced into
+    auto appends{ m_appends.Snapshot() };
+
+    //Queue wait of the I/O scheduler, per priority lane
+    RN::JSValueObject lanes;
+    constexpr std::array<std::pair<TransferPriority, char const*>, IoScheduler::LaneCount> laneNames{ {
+        { TransferPriority::Interactive, "interactive" },
+        { TransferPriority::Normal, "normal" },
+        { TransferPriority::Background, "background" } } };
+    for (auto const& [priority, name] : laneNames)
+    {
+        auto lane{ m_io.Snapshot(priority) };
+        lanes[name] = RN::JSValueObject
+            {
+                { "scheduled", lane.scheduled },
+                { "queued", lane.queued },
+                { "meanWaitMs", lane.scheduled ? lane.totalWaitMicroseconds / 1000.0 / lane.scheduled : 0.0 },
+                { "p50WaitMs", OperationStats::Percentile(lane.wait, 0.50) / 1000.0 },
+                { "p99WaitMs", OperationStats::Percentile(lane.wait, 0.99) / 1000.0 },
+                { "maxWaitMs", lane.maxWaitMicroseconds / 1000.0 },
+            };
+    }
+
+    promise.Resolve(RN::JSValueObject
+        {
+            { "since", std::chrono::duration_cast<std::chrono::milliseconds>(m_stats.Since().time_since_epoch()).count() },
+            { "operations", std::move(operations) },
+            { "io", RN::JSValueObject{ { "workers", m_io.Workers() }, { "lanes", std::move(lanes) } } },
+            { "writeSessions", RN::JSValueObject
+                {
+                    { "open", static_cast<uint64_t>(m_writeSessions.Size()) },
+                    { "opened", writeSessions.opened },
+                    { "expired", writeSessions.expired },
+                } },
+            { "readSessions", RN::JSValueObject
+                {
+                    { "open", static_cast<uint64_t>(m_readSessions.Size()) },
+                    { "opened", readSessions.opened },
+                    { "expired", readSessions.expired },
+                } },
+            { "appends", RN::JSValueObject
+                {
+                    { "appends", appends.appends },
+                    { "writes", appends.writes },
+                    { "bytes", appends.bytes },
+                    { "pending", static_cast<uint64_t>(m_appends.Pending()) },
+                } },
+            { "events", RN::JSValueObject
+                {
+                    { "posted", events.posted },
+                    { "superseded", events.superseded },
+                    { "delivered", events.delivered },
+                    { "batches", events.batches },
+                } },
+        });
+}
+
+void RNFSManager::resetStats(RN::ReactPromise<void> promise) noexcept
+{
+    m_stats.Reset();
+    m_io.Reset();
+    m_events.Reset();
+    m_writeSessions.Reset();
+    m_readSessions.Reset();
+    m_appends.Reset();
+    promise.Resolve();
+}
+
+void RNFSManager::getJobs(RN::ReactPromise<RN::JSValue> promise) noexcept
+{
+    auto jobs{ m_jobs.Jobs() };
+    std::sort(jobs.begin(), jobs.end(), [](auto const& left, auto const& right) { return left->Id() < right->Id(); });
+
+    RN::JSValueArray result;
+    for (auto const& job : jobs)
+    {
+        char const* state{ "done" };
+        switch (job->State())
+        {
+        case JobState::Queued: state = "queued"; break;
+        case JobState::Running: state = "running"; break;
+        case JobState::Paused: state = "paused"; break;
+        case JobState::Done: break;
+        }
+
+        result.push_back(RN::JSValueObject
+            {
+                { "jobId", job->Id() },
+                { "state", state },
+                { "bytesTransferred", job->BytesTransferred() },
+                { "bytesExpected", job->BytesExpected() },
+            });
+    }
+    promise.Resolve(RN::JSValue{ std::move(result) });
+}
+
+
+//
+// For multipart uploads
+//
+static std::vector<std::pair<winrt::hstring, winrt::hstring>> upload_headers(RN::JSValueObject const& options)
+{
+    std::vector<std::pair<winrt::hstring, winrt::hstring>> headers;
+    for (auto const& entry : options["headers"].AsObject())
+    {
+        headers.emplace_back(winrt::to_hstring(entry.first), winrt::to_hstring(entry.second.AsString()));
+    }
+    return headers;
+}
+
+static winrt::hstring form_data_disposition(RN::JSValueObject const& options)
+{
+    auto const& fields{ options["fields"].AsObject() }; // placed in the header
+    std::stringstream attempt;
+    attempt << "form-data";
+    for (auto const& field : fields)
+    {
+        attempt << "; " << field.first << "=" << field.second.AsString();
+    }
+    return winrt::to_hstring(attempt.str());
+}
+
+// Attaches an empty multipart body to `request`; the caller adds the file parts
+static HttpMultipartFormDataContent create_multipart_content(HttpRequestMessage const& request,
+    std::vector<std::pair<winrt::hstring, winrt::hstring>> const& headers, winrt::hstring const& disposition)
+{
+    // A fixed boundary could occur inside a file; a random one practically cannot
+    winrt::hstring boundary{ L"----RNFSFormBoundary" +
+        Cryptography::CryptographicBuffer::EncodeToHexString(Cryptography::CryptographicBuffer::GenerateRandom(16)) };
+    HttpMultipartFormDataContent content{ boundary };
+
+    for (auto const& [name, value] : headers)
+    {
+        if (!request.Headers().TryAppendWithoutValidation(name, value))
+        {
+            content.Headers().TryAppendWithoutValidation(name, value);
+        }
+    }
+    content.Headers().ContentDisposition(Headers::HttpContentDispositionHeaderValue::Parse(disposition));
+
+    request.Content(content);
+    return content;
+}
+
+// Reads an in-memory part as a stream, so it is shaped the same way as a file
+static IAsyncOperation<IInputStream> upload_part_stream(IBuffer data)
+{
+    InMemoryRandomAccessStream stream;
+    co_await stream.WriteAsync(data);
+    co_return stream.GetInputStreamAt(0);
+}
+
+IAsyncAction RNFSManager::ProcessUploadRequestAsync(RN::ReactPromise<RN::JSValueObject> promise, RN::JSValueObject& options,
+    winrt::Windows::Web::Http::HttpMethod httpMethod, RN::JSValueArray const& files, std::vector<IBuffer> const& partData,
+    std::shared_ptr<JobTable::Job> job, uint64_t totalUploadSize)
+{
+    auto jobId{ job->Id() };
+    try
+    {
+        std::string toUrl{ options["toUrl"].AsString() };
+        std::wstring URLForURI(toUrl.begin(), toUrl.end());
+        Uri uri{ URLForURI };
+
+        bool hasProgressCallback{ options["hasProgressCallback"].AsBoolean() };
+        int64_t progressInterval{ options["progressInterval"].AsInt64() };
+        if (progressInterval <= 0)
+        {
+            progressInterval = DefaultUploadProgressInterval;
+        }
+        bool compress{ options["compress"].AsString() == "gzip" };
+        auto bandwidth{ m_bandwidth.Track(jobId, static_cast<uint64_t>(std::max<int64_t>(options["maxBytesPerSecond"].AsInt64(), 0))) };
+
+        m_events.Post("UploadBegin",
+            RN::JSValueObject{
+                { "jobId", jobId },
+            });
+
+        auto httpClient{ m_httpClients.Get(*ParseTransferPriority(options["priority"].AsString())) };
+        auto retry{ retry_policy(options) };
+        HttpResponseMessage response{ nullptr };
+        uint32_t attempt{ 0 };
+        std::optional<std::chrono::milliseconds> retryDelay;
+        for (;;)
+        {
+            if (retryDelay)
+            {
+                job->SetState(JobState::Paused);
+                co_await winrt::resume_after(*retryDelay);
+                job->SetState(JobState::Running);
+                retryDelay.reset();
+            }
+            ++attempt;
+
+            // Parts are streamed from disk, so every attempt builds the request again
+            winrt::Windows::Web::Http::HttpRequestMessage requestMessage{ httpMethod, uri };
+            auto requestContent{ create_multipart_content(requestMessage, upload_headers(options), form_data_disposition(options)) };
+
+            for (size_t index = 0; index < files.size(); ++index)
+            {
+                auto const& fileObj{ files[index].AsObject() };
+                auto name{ winrt::to_hstring(fileObj["name"].AsString()) }; // name to be sent via http request
+                auto filename{ winrt::to_hstring(fileObj["filename"].AsString()) }; // filename to be sent via http request
+                auto filepath{ fileObj["filepath"].AsString()}; // accessing the file
+
+                try
+                {
+                    IInputStream source{ nullptr };
+                    uint64_t size{ 0 };
+                    if (auto const& data{ partData[index] })
+                    {
+                        source = co_await upload_part_stream(data);
+                        size = data.Length();
+                    }
+                    else
+                    {
+                        winrt::hstring directoryPath, fileName;
+                        splitPath(filepath, directoryPath, fileName);
+                        StorageFolder folder{ co_await StorageFolder::GetFolderFromPathAsync(directoryPath) };
+                        StorageFile file{ co_await folder.GetFileAsync(fileName) };
+                        size = (co_await file.GetBasicPropertiesAsync()).Size();
+
+                        // Stream each part straight from disk as the connection drains instead of
+                        // buffering every file in memory before the request can start
+                        source = co_await file.OpenSequentialReadAsync();
+                    }
+
+                    HttpStreamContent entry{ winrt::make<ThrottledInputStream>(source, m_bandwidth, jobId) };
+                    entry.Headers().ContentLength(size);
+                    requestContent.Add(entry, name, filename);
+                }
+                catch (...)
+                {
+                    continue;
+                }
+            }
+
+            // The whole body is compressed, so the server decodes it before parsing the parts
+            winrt::com_ptr<GzipContent> compressor;
+            if (compress)
+            {
+                compressor = winrt::make_self<GzipContent>(requestContent);
+                requestMessage.Content(compressor.as<IHttpContent>());
+            }
+
+            auto sendOperation{ httpClient.SendRequestAsync(requestMessage, HttpCompletionOption::ResponseHeadersRead) };
+
+            // Report what the connection has actually written rather than what has been read from disk
+            auto throttle{ std::make_shared<upload_progress_throttle>(progressInterval) };
+            sendOperation.Progress([this, job, hasProgressCallback, totalUploadSize, throttle, compressor](auto const&, HttpProgress const& progress)
+                {
+                    uint64_t totalBytesExpected{ progress.TotalBytesToSend ? progress.TotalBytesToSend.Value() : totalUploadSize };
+                    uint64_t totalBytesSent{ progress.BytesSent };
+                    if (compressor)
+                    {
+                        // The compressed size is unknown up front, so count the body bytes consumed instead;
+                        // they include the multipart framing, which is small next to the files
+                        totalBytesExpected = totalUploadSize;
+                        totalBytesSent = std::min(compressor->SourceBytesWritten(), totalUploadSize);
+                    }
+                    if (progress.Stage != HttpProgressStage::SendingContent)
+                    {
+                        return;
+                    }
+                    job->Progress(totalBytesSent, totalBytesExpected);
+                    if (!hasProgressCallback || !throttle->should_emit(totalBytesSent, totalBytesExpected))
+                    {
+                        return;
+                    }
+
+                    m_events.PostProgress("UploadProgress", job->Id(),
+                        RN::JSValueObject{
+                            { "jobId", job->Id() },
+                            { "totalBytesExpectedToSend", totalBytesExpected },   // The total number of bytes that will be sent to the server
+                            { "totalBytesSent", totalBytesSent },
+                        });
+                });
+
+            try
+            {
+                response = co_await sendOperation;
+            }
+            catch (winrt::hresult_canceled const&)
+            {
+                throw;
+            }
+            catch (const hresult_error&)
+            {
+                retryDelay = retry.Delay(attempt, std::nullopt);
+                if (!retryDelay)
+                {
+                    throw;
+                }
+                continue;
+            }
+
+            if (retry.IsRetryableStatus(int32_t(response.StatusCode())))
+            {
+                retryDelay = retry.Delay(attempt, retry_after(response));
+                if (retryDelay)
+                {
+                    response.Close();
+                    continue;
+                }
+            }
+            break;
+        }
+
+        auto statusCode{ std::to_string(int(response.StatusCode())) };
+        auto resultHeaders{ winrt::to_string(response.Headers().ToString()) };
+        auto resultContent{ winrt::to_string(co_await response.Content().ReadAsStringAsync()) };
+
+        m_stats.AddBytes(Operation::UploadFiles, resultContent.size(), totalUploadSize);
+        m_events.Flush();
+        promise.Resolve(RN::JSValueObject
+            {
+                { "jobId", jobId },
+                { "statusCode", statusCode},
+                { "headers", resultHeaders},
+                { "body", resultContent},
+                { "attempts", attempt },
+            });
+    }
+    catch (winrt::hresult_canceled const& ex)
+    {
+        std::stringstream ss;
+        ss << "CANCELLED: job '" << jobId << "' to '" << options["toUrl"].AsString() << "'";
+        m_stats.Fail(Operation::UploadFiles, "CANCELLED");
+        promise.Reject(RN::ReactError{ std::to_string(ex.code()), ss.str(), RN::JSValueObject{} });
+    }
+    catch (const hresult_error& ex)
+    {
+        m_stats.Fail(Operation::UploadFiles, "Error");
+        promise.Reject(winrt::to_string(ex.message()).c_str());
+    }
+}
+
+//
+// Parallel uploads: every file is its own multipart request, and a fixed number of workers
+// take the next file from a shared index until none are left
+//
+struct ParallelUploadState
+{
+    struct File
+    {
+        winrt::hstring name;     // name to be sent via http request
+        winrt::hstring filename; // filename to be sent via http request
+        std::string filepath;
+        IBuffer data{ nullptr }; // sent instead of the file at filepath when set
+    };
+
+    int32_t jobId{ 0 };
+    std::shared_ptr<JobTable::Job> job;
+    HttpClient client{ nullptr };
+    HttpMethod method{ nullptr };
+    Uri uri{ nullptr };
+    std::vector<std::pair<winrt::hstring, winrt::hstring>> headers;
+    winrt::hstring disposition;
+    std::vector<File> files;
+    RetryPolicy retry;
+    bool compress{ false };
+    bool hasProgressCallback{ false };
+    int64_t progressInterval{ 0 };
+    uint64_t totalUploadSize{ 0 };
+
+    std::atomic<size_t> next{ 0 };
+    std::unique_ptr<std::atomic<uint64_t>[]> sent; // bytes of each file on the wire so far
+    std::vector<RN::JSValueObject> results;        // one per file, each written by the worker that uploaded it
+};
+
+IAsyncAction RNFSManager::ProcessParallelUploadAsync(RN::ReactPromise<RN::JSValueObject> promise, RN::JSValueObject& options,
+    winrt::Windows::Web::Http::HttpMethod httpMethod, RN::JSValueArray const& files, std::vector<IBuffer> const& partData,
+    std::shared_ptr<JobTable::Job> job, uint64_t totalUploadSize)
+{
+    auto jobId{ job->Id() };
+    std::vector<IAsyncAction> workers;
+    try
+    {
+        // Stopping the job aborts the upload being awaited; the catch below stops the others
+        auto cancellation{ co_await winrt::get_cancellation_token() };
+        cancellation.enable_propagation();
+
+        auto state{ std::make_shared<ParallelUploadState>() };
+        state->jobId = jobId;
+        state->job = job;
+        job->Progress(0, totalUploadSize);
+        state->client = m_httpClients.Get(*ParseTransferPriority(options["priority"].AsString()));
+        state->method = httpMethod;
+        state->uri = Uri{ winrt::to_hstring(options["toUrl"].AsString()) };
+        state->headers = upload_headers(options);
+        state->disposition = form_data_disposition(options);
+
+        // `retries` predates the retry option: a fixed count, any server error, 250ms doubling up to 8s
+        RetryPolicy legacyRetry;
+        legacyRetry.maxAttempts = static_cast<uint32_t>(std::clamp<int64_t>(options["retries"].AsInt64(), 0, 99)) + 1;
+        legacyRetry.initialDelay = std::chrono::milliseconds{ 250 };
+        legacyRetry.maxDelay = std::chrono::milliseconds{ 8000 };
+        for (int32_t code = 501; code < 600; ++code)
+        {
+            if (!legacyRetry.IsRetryableStatus(code))
+            {
+                legacyRetry.retryableStatusCodes.push_back(code);
+            }
+        }
+        state->retry = retry_policy(options, std::move(legacyRetry));
+        state->compress = options["compress"].AsString() == "gzip";
+        auto bandwidth{ m_bandwidth.Track(jobId, static_cast<uint64_t>(std::max<int64_t>(options["maxBytesPerSecond"].AsInt64(), 0))) };
+        state->hasProgressCallback = options["hasProgressCallback"].AsBoolean();
+        state->progressInterval = options["progressInterval"].AsInt64();
+        if (state->progressInterval <= 0)
+        {
+            state->progressInterval = DefaultUploadProgressInterval;
+        }
+        state->totalUploadSize = totalUploadSize;
+
+        for (size_t index = 0; index < files.size(); ++index)
+        {
+            auto const& fileObj{ files[index].AsObject() };
+            state->files.push_back({
+                winrt::to_hstring(fileObj["name"].AsString()),
+                winrt::to_hstring(fileObj["filename"].AsString()),
+                fileObj["filepath"].AsString(),
+                partData[index] });
+        }
+        state->sent = std::make_unique<std::atomic<uint64_t>[]>(state->files.size());
+        state->results.resize(state->files.size());
+
+        int64_t maxConcurrent{ options["maxConcurrent"].AsInt64() };
+        if (maxConcurrent <= 0)
+        {
+            maxConcurrent = DefaultMaxConcurrentUploads;
+        }
+        maxConcurrent = std::min<int64_t>(maxConcurrent, state->files.size());
+
+        m_events.Post("UploadBegin",
+            RN::JSValueObject{
+                { "jobId", jobId },
+            });
+
+        for (int64_t i = 0; i < maxConcurrent; ++i)
+        {
+            workers.push_back(ParallelUploadWorkerAsync(state));
+        }
+        for (auto const& worker : workers)
+        {
+            co_await worker;
+        }
+
+        RN::JSValueArray results;
+        for (auto& result : state->results)
+        {
+            results.push_back(std::move(result));
+        }
+
+        m_stats.AddBytes(Operation::UploadFiles, 0, state->totalUploadSize);
+        m_events.Flush();
+        promise.Resolve(RN::JSValueObject
+            {
+                { "jobId", jobId },
+                { "files", std::move(results) },
+            });
+    }
+    catch (winrt::hresult_canceled const& ex)
+    {
+        for (auto const& worker : workers)
+        {
+            worker.Cancel();
+        }
+
+        std::stringstream ss;
+        ss << "CANCELLED: job '" << jobId << "' to '" << options["toUrl"].AsString() << "'";
+        m_stats.Fail(Operation::UploadFiles, "CANCELLED");
+        promise.Reject(RN::ReactError{ std::to_string(ex.code()), ss.str(), RN::JSValueObject{} });
+    }
+    catch (const hresult_error& ex)
+    {
+        for (auto const& worker : workers)
+        {
+            worker.Cancel();
+        }
+
+        m_stats.Fail(Operation::UploadFiles, "Error");
+        promise.Reject(winrt::to_string(ex.message()).c_str());
+    }
+}
+
+IAsyncAction RNFSManager::ParallelUploadWorkerAsync(std::shared_ptr<ParallelUploadState> state)
+{
+    // Cancelling the worker aborts the request it is sending
+    auto cancellation{ co_await winrt::get_cancellation_token() };
+    cancellation.enable_propagation();
+
+    for (size_t index{ state->next++ }; index < state->files.size(); index = state->next++)
+    {
+        auto const& entry{ state->files[index] };
+        RN::JSValueObject result{
+            { "index", static_cast<int64_t>(index) },
+            { "filepath", entry.filepath },
+        };
+
+        StorageFile file{ nullptr };
+        uint64_t size{ 0 };
+        try
+        {
+            if (entry.data)
+            {
+                size = entry.data.Length();
+            }
+            else
+            {
+                winrt::hstring directoryPath, fileName;
+                splitPath(entry.filepath, directoryPath, fileName);
+                StorageFolder folder{ co_await StorageFolder::GetFolderFromPathAsync(directoryPath) };
+                file = co_await folder.GetFileAsync(fileName);
+                size = (co_await file.GetBasicPropertiesAsync()).Size();
+            }
+        }
+        catch (winrt::hresult_canceled const&)
+        {
+            throw;
+        }
+        catch (hresult_error const& ex)
+        {
+            result["attempts"] = 0;
+            result["error"] = winrt::to_string(ex.message());
+            state->results[index] = std::move(result);
+            continue;
+        }
+
+        for (int64_t attempt = 1;; ++attempt)
+        {
+            state->sent[index] = 0;
+            HttpResponseMessage response{ nullptr };
+            std::string responseBody;
+            winrt::hstring failure;
+            try
+            {
+                HttpRequestMessage request{ state->method, state->uri };
+                auto content{ create_multipart_content(request, state->headers, state->disposition) };
+                IInputStream source{ entry.data ? co_await upload_part_stream(entry.data) : co_await file.OpenSequentialReadAsync() };
+                HttpStreamContent part{ winrt::make<ThrottledInputStream>(source, m_bandwidth, state->jobId) };
+                part.Headers().ContentLength(size);
+                content.Add(part, entry.name, entry.filename);
+                winrt::com_ptr<GzipContent> compressor;
+                if (state->compress)
+                {
+                    compressor = winrt::make_self<GzipContent>(content);
+                    request.Content(compressor.as<IHttpContent>());
+                }
+
+                auto sendOperation{ state->client.SendRequestAsync(request, HttpCompletionOption::ResponseHeadersRead) };
+                auto throttle{ std::make_shared<upload_progress_throttle>(state->progressInterval) };
+                sendOperation.Progress([this, state, index, size, throttle, compressor](auto const&, HttpProgress const& progress)
+                    {
+                        if (progress.Stage != HttpProgressStage::SendingContent)
+                        {
+                            return;
+                        }
+
+                        // Scale the wire bytes, which include the multipart framing, to the file's size;
+                        // compressed bodies report how much of the body has been consumed instead
+                        uint64_t wireTotal{ progress.TotalBytesToSend ? progress.TotalBytesToSend.Value() : size };
+                        uint64_t fileSent{ compressor ? std::min(compressor->SourceBytesWritten(), size) : wireTotal == 0 ? size :
+                            static_cast<uint64_t>(static_cast<double>(std::min(progress.BytesSent, wireTotal)) / wireTotal * size) };
+                        state->sent[index] = fileSent;
+                        uint64_t totalSent{ 0 };
+                        for (size_t i = 0; i < state->files.size(); ++i)
+                        {
+                            totalSent += state->sent[i];
+                        }
+                        state->job->Progress(totalSent);
+                        if (!state->hasProgressCallback || !throttle->should_emit(fileSent, size))
+                        {
+                            return;
+                        }
+
+                        m_events.PostProgress("UploadProgress", state->jobId,
+                            RN::JSValueObject{
+                                { "jobId", state->jobId },
+                                { "totalBytesExpectedToSend", state->totalUploadSize },
+                                { "totalBytesSent", totalSent },
+                                { "fileIndex", static_cast<int64_t>(index) },
+                                { "fileBytesExpectedToSend", size },
+                                { "fileBytesSent", fileSent },
+                            });
+                    });
+
+                response = co_await sendOperation;
+                responseBody = winrt::to_string(co_await response.Content().ReadAsStringAsync());
+            }
+            catch (winrt::hresult_canceled const&)
+            {
+                throw;
+            }
+            catch (hresult_error const& ex)
+            {
+                response = nullptr;
+                failure = ex.message();
+            }
+
+            int statusCode{ response ? int(response.StatusCode()) : 0 };
+            std::optional<std::chrono::milliseconds> retryDelay;
+            if (!response || state->retry.IsRetryableStatus(statusCode))
+            {
+                retryDelay = state->retry.Delay(static_cast<uint32_t>(attempt), response ? retry_after(response) : std::nullopt);
+            }
+            if (!retryDelay)
+            {
+                result["attempts"] = attempt;
+                if (response)
+                {
+                    result["statusCode"] = std::to_string(statusCode);
+                    result["headers"] = winrt::to_string(response.Headers().ToString());
+                    result["body"] = std::move(responseBody);
+                }
+                else
+                {
+                    result["error"] = winrt::to_string(failure);
+                }
+                break;
+            }
+
+            // Back off before retrying this file; the other workers keep going
+            co_await winrt::resume_after(*retryDelay);
+        }
+        state->results[index] = std::move(result);
+    }
+}
+
+//
+// Resumable uploads (tus 1.0.0): each file is created on the server with a POST, then sent in
+// PATCH chunks tagged with their offset. The upload URL is journaled so a later call for the
+// same url and file continues where the server says the previous attempt stopped.
+//
+static void apply_upload_headers(HttpRequestMessage const& request, RN::JSValueObject const& headers)
+{
+    request.Headers().TryAppendWithoutValidation(L"Tus-Resumable", L"1.0.0");
+    for (auto const& entry : headers)
+    {
+        request.Headers().TryAppendWithoutValidation(winrt::to_hstring(entry.first), winrt::to_hstring(entry.second.AsString()));
+    }
+}
+
+static std::optional<uint64_t> upload_offset(HttpResponseMessage const& response)
+{
+    if (!response.Headers().HasKey(L"Upload-Offset"))
+    {
+        return std::nullopt;
+    }
+    return _wcstoui64(response.Headers().Lookup(L"Upload-Offset").c_str(), nullptr, 10);
+}
+
+static winrt::hstring upload_metadata_value(winrt::hstring const& value)
+{
+    return Cryptography::CryptographicBuffer::EncodeToBase64String(
+        Cryptography::CryptographicBuffer::ConvertStringToBinary(value, Cryptography::BinaryStringEncoding::Utf8));
+}
+
+// Sends a request of a resumable upload other than a chunk, built anew by `makeRequest` for each attempt;
+// one that fails without a response or with a retryable status is tried again as `retry` allows
+IAsyncOperation<HttpResponseMessage> RNFSManager::SendUploadRequestAsync(HttpClient httpClient,
+    std::function<HttpRequestMessage()> makeRequest, RetryPolicy retry, std::shared_ptr<JobTable::Job> job)
+{
+    uint32_t attempt{ 0 };
+    std::optional<std::chrono::milliseconds> retryDelay;
+    for (;;)
+    {
+        if (retryDelay)
+        {
+            job->SetState(JobState::Paused);
+            co_await winrt::resume_after(*retryDelay);
+            job->SetState(JobState::Running);
+            retryDelay.reset();
+        }
+        ++attempt;
+
+        HttpResponseMessage response{ nullptr };
+        try
+        {
+            response = co_await httpClient.SendRequestAsync(makeRequest());
+        }
+        catch (winrt::hresult_canceled const&)
+        {
+            throw;
+        }
+        catch (const hresult_error&)
+        {
+            retryDelay = retry.Delay(attempt, std::nullopt);
+            if (!retryDelay)
+            {
+                throw;
+            }
+            continue;
+        }
+
+        if (retry.IsRetryableStatus(int32_t(response.StatusCode())))
+        {
+            retryDelay = retry.Delay(attempt, retry_after(response));
+            if (retryDelay)
+            {
+                response.Close();
+                continue;
+            }
+        }
+        co_return response;
+    }
+}
+
+IAsyncOperation<int64_t> RNFSManager::QueryUploadOffsetAsync(HttpClient httpClient, Uri uploadUri, RN::JSValueObject const& headers,
+    RetryPolicy retry, std::shared_ptr<JobTable::Job> job)
+{
+    HttpResponseMessage response{ co_await SendUploadRequestAsync(httpClient, [&uploadUri, &headers]()
+        {
+            HttpRequestMessage request{ HttpMethod::Head(), uploadUri };
+            apply_upload_headers(request, headers);
+            return request;
+        }, std::move(retry), std::move(job)) };
+    auto status{ response.StatusCode() };
+    if (status == HttpStatusCode::NotFound || status == HttpStatusCode::Gone || status == HttpStatusCode::Forbidden)
+    {
+        co_return -1; // the server no longer knows this upload
+    }
+
+    // Any other failure leaves the offset unknown rather than the upload lost
+    response.EnsureSuccessStatusCode();
+    auto offset{ upload_offset(response) };
+    co_return offset ? static_cast<int64_t>(*offset) : -1;
+}
+
+IAsyncAction RNFSManager::ProcessResumableUploadAsync(RN::ReactPromise<RN::JSValueObject> promise, RN::JSValueObject& options,
+    RN::JSValueArray const& files, std::shared_ptr<JobTable::Job> job, uint64_t totalUploadSize)
+{
+    auto jobId{ job->Id() };
+    try
+    {
+        std::string toUrl{ options["toUrl"].AsString() };
+        Uri createUri{ winrt::to_hstring(toUrl) };
+        auto httpClient{ m_httpClients.Get(*ParseTransferPriority(options["priority"].AsString())) };
+        auto const& headers{ options["headers"].AsObject() };
+        auto const& fields{ options["fields"].AsObject() };
+
+        uint32_t chunkSize{ static_cast<uint32_t>(std::clamp<int64_t>(options["chunkSize"].AsInt64(), 0, MaxUploadChunkSize)) };
+        if (chunkSize == 0)
+        {
+            chunkSize = DefaultUploadChunkSize;
+        }
+
+        bool hasProgressCallback{ options["hasProgressCallback"].AsBoolean() };
+        int64_t progressInterval{ options["progressInterval"].AsInt64() };
+        if (progressInterval <= 0)
+        {
+            progressInterval = DefaultUploadProgressInterval;
+        }
+        auto throttle{ std::make_shared<upload_progress_throttle>(progressInterval) };
+        auto bandwidth{ m_bandwidth.Track(jobId, static_cast<uint64_t>(std::max<int64_t>(options["maxBytesPerSecond"].AsInt64(), 0))) };
+
+        // Without a retry option a failed request is sent again after a growing delay, up to MaxUploadChunkRetries times in a row
+        RetryPolicy chunkRetry;
+        chunkRetry.maxAttempts = MaxUploadChunkRetries + 1;
+        auto retry{ retry_policy(options, std::move(chunkRetry)) };
+        uint32_t retries{ 0 }; // chunks resent over the whole job
+
+        std::wstring journalFolderPath;
+        {
+            std::lock_guard lock{ m_foldersMutex };
+            journalFolderPath = m_journalFolderPath;
+        }
+        StorageFolder journalFolder{ co_await open_state_folder(std::move(journalFolderPath),
+            [] { return ApplicationData::Current().LocalFolder(); }, L"RNFSUploadJournal") };
+
+        m_events.Post("UploadBegin",
+            RN::JSValueObject{
+                { "jobId", jobId },
+            });
+
+        RN::JSValueArray uploadUrls;
+        HttpResponseMessage lastResponse{ nullptr };
+        uint64_t completedBytes{ 0 };
+
+        for (auto const& fileInfo : files)
+        {
+            auto const& fileObj{ fileInfo.AsObject() };
+            auto filepath{ fileObj["filepath"].AsString() };
+
+            winrt::hstring directoryPath, fileName;
+            splitPath(filepath, directoryPath, fileName);
+            StorageFolder folder{ co_await StorageFolder::GetFolderFromPathAsync(directoryPath) };
+            StorageFile file{ co_await folder.GetFileAsync(fileName) };
+            auto properties{ co_await file.GetBasicPropertiesAsync() };
+            uint64_t size{ properties.Size() };
+            int64_t modified{ properties.DateModified().time_since_epoch().count() };
+
+            auto keyBuffer{ Cryptography::CryptographicBuffer::ConvertStringToBinary(winrt::to_hstring(toUrl + "\n" + filepath), Cryptography::BinaryStringEncoding::Utf8) };
+            winrt::hstring journalName{ Cryptography::CryptographicBuffer::EncodeToHexString(availableHashes.at("sha256")().HashData(keyBuffer)) + L".journal" };
+
+            //Journal: pick up the upload URL of an earlier attempt if the file has not changed since
+            Uri uploadUri{ nullptr };
+            uint64_t offset{ 0 };
+            if (auto journalItem{ co_await journalFolder.TryGetItemAsync(journalName) })
+            {
+                winrt::hstring location;
+                uint64_t journaledLength{ 0 };
+                int64_t journaledModified{ 0 };
+
+                // One "<key>: <value>" entry per line
+                auto lines{ co_await FileIO::ReadLinesAsync(journalItem.as<StorageFile>()) };
+                for (auto const& line : lines)
+                {
+                    std::wstring_view entry{ line };
+                    auto separator{ entry.find(L": ") };
+                    if (separator == std::wstring_view::npos)
+                    {
+                        continue;
+                    }
+
+                    auto name{ entry.substr(0, separator) };
+                    winrt::hstring value{ entry.substr(separator + 2) };
+                    if (name == L"Location")
+                    {
+                        location = value;
+                    }
+                    else if (name == L"Upload-Length")
+                    {
+                        journaledLength = _wcstoui64(value.c_str(), nullptr, 10);
+                    }
+                    else if (name == L"Modified")
+                    {
+                        journaledModified = _wcstoi64(value.c_str(), nullptr, 10);
+                    }
+                }
+
+                if (!location.empty() && journaledLength == size && journaledModified == modified)
+                {
+                    Uri journaledUri{ location };
+                    int64_t recovered{ co_await QueryUploadOffsetAsync(httpClient, journaledUri, headers, retry, job) };
+                    if (recovered >= 0 && static_cast<uint64_t>(recovered) <= size)
+                    {
+                        uploadUri = journaledUri;
+                        offset = static_cast<uint64_t>(recovered);
+                    }
+                }
+            }
+
+            //Create: announce the file to the server and journal where it lives
+            if (!uploadUri)
+            {
+                std::wstring metadata{ L"filename " };
+                metadata += upload_metadata_value(winrt::to_hstring(fileObj["filename"].AsString()));
+                if (!fileObj["filetype"].AsString().empty())
+                {
+                    metadata += L",filetype ";
+                    metadata += upload_metadata_value(winrt::to_hstring(fileObj["filetype"].AsString()));
+                }
+                for (auto const& field : fields)
+                {
+                    metadata += L"," + winrt::to_hstring(field.first) + L" ";
+                    metadata += upload_metadata_value(winrt::to_hstring(field.second.AsString()));
+                }
+
+                HttpResponseMessage response{ co_await SendUploadRequestAsync(httpClient, [&createUri, &headers, &metadata, size]()
+                    {
+                        HttpRequestMessage create{ HttpMethod::Post(), createUri };
+                        apply_upload_headers(create, headers);
+                        create.Headers().TryAppendWithoutValidation(L"Upload-Length", winrt::to_hstring(size));
+                        create.Headers().TryAppendWithoutValidation(L"Upload-Metadata", metadata);
+                        create.Content(HttpBufferContent{ Buffer{ 0u } });
+                        return create;
+                    }, retry, job) };
+                if (response.StatusCode() != HttpStatusCode::Created || !response.Headers().HasKey(L"Location"))
+                {
+                    std::stringstream ss;
+                    ss << "EUPLOAD: job '" << jobId << "' could not create an upload for '" << filepath
+                       << "', server answered " << int(response.StatusCode());
+                    m_stats.Fail(Operation::UploadFiles, "EUPLOAD");
+                    promise.Reject(RN::ReactError{ "EUPLOAD", ss.str() });
+                    co_return;
+                }
+                uploadUri = createUri.CombineUri(response.Headers().Lookup(L"Location"));
+                lastResponse = response;
+
+                StorageFile journal{ co_await journalFolder.CreateFileAsync(journalName, CreationCollisionOption::ReplaceExisting) };
+                co_await FileIO::WriteLinesAsync(journal, std::vector<winrt::hstring>{
+                    L"Location: " + uploadUri.AbsoluteUri(),
+                    L"Upload-Length: " + winrt::to_hstring(size),
+                    L"Modified: " + winrt::to_hstring(modified),
+                });
+            }
+
+            //Chunks: PATCH from the server's offset, resynchronising with HEAD after a failed chunk
+            IRandomAccessStreamWithContentType stream{ co_await file.OpenReadAsync() };
+            uint32_t failures{ 0 };
+            bool resync{ false };
+            while (offset < size)
+            {
+                if (resync)
+                {
+                    bool reached{ false };
+                    int64_t recovered{ -1 };
+                    try
+                    {
+                        recovered = co_await QueryUploadOffsetAsync(httpClient, uploadUri, headers, RetryPolicy{}, job);
+                        reached = true;
+                    }
+                    catch (winrt::hresult_canceled const&)
+                    {
+                        throw;
+                    }
+                    catch (hresult_error const&)
+                    {
+                        // No answer, or one that leaves the offset unknown; counted as one more failed attempt below
+                    }
+
+                    if (!reached)
+                    {
+                        auto retryDelay{ retry.Delay(++failures, std::nullopt) };
+                        if (!retryDelay)
+                        {
+                            std::stringstream ss;
+                            ss << "EUPLOAD: job '" << jobId << "' could not resume '" << filepath << "' at offset " << offset
+                               << ", its offset could not be queried";
+                            m_stats.Fail(Operation::UploadFiles, "EUPLOAD");
+                            promise.Reject(RN::ReactError{ "EUPLOAD", ss.str() });
+                            co_return;
+                        }
+                        if (retryDelay->count() > 0)
+                        {
+                            job->SetState(JobState::Paused);
+                            co_await winrt::resume_after(*retryDelay);
+                            job->SetState(JobState::Running);
+                        }
+                        continue;
+                    }
+
+                    if (recovered < 0 || static_cast<uint64_t>(recovered) > size)
+                    {
+                        if (auto journalItem{ co_await journalFolder.TryGetItemAsync(journalName) })
+                        {
+                            co_await journalItem.DeleteAsync();
+                        }
+
+                        std::stringstream ss;
+                        ss << "EUPLOAD: job '" << jobId << "', the server discarded the upload of '" << filepath << "'";
+                        m_stats.Fail(Operation::UploadFiles, "EUPLOAD");
+                        promise.Reject(RN::ReactError{ "EUPLOAD", ss.str() });
+                        co_return;
+                    }
+                    offset = static_cast<uint64_t>(recovered);
+                    resync = false;
+                    continue;
+                }
+
+                uint32_t length{ static_cast<uint32_t>(std::min<uint64_t>(chunkSize, size - offset)) };
+                stream.Seek(offset);
+                auto chunk{ co_await stream.ReadAsync(Buffer{ length }, length, InputStreamOptions::None) };
+                if (chunk.Length() != length)
+                {
+                    throw winrt::hresult_error(E_UNEXPECTED, L"File was truncated during upload");
+                }
+
+                // Bandwidth shaping: a chunk is paid for up front since it goes out in one request
+                auto throttleDelay{ m_bandwidth.Acquire(jobId, length) };
+                if (throttleDelay.count() > 0)
+                {
+                    co_await winrt::resume_after(throttleDelay);
+                }
+
+                HttpRequestMessage patch{ HttpMethod::Patch(), uploadUri };
+                apply_upload_headers(patch, headers);
+                patch.Headers().TryAppendWithoutValidation(L"Upload-Offset", winrt::to_hstring(offset));
+                HttpBufferContent content{ chunk };
+                content.Headers().ContentType(Headers::HttpMediaTypeHeaderValue{ L"application/offset+octet-stream" });
+                patch.Content(content);
+
+                auto sendOperation{ httpClient.SendRequestAsync(patch) };
+                uint64_t sentBefore{ completedBytes + offset };
+                sendOperation.Progress([this, job, hasProgressCallback, totalUploadSize, sentBefore, throttle](auto const&, HttpProgress const& progress)
+                    {
+                        uint64_t sent{ sentBefore + progress.BytesSent };
+                        if (progress.Stage != HttpProgressStage::SendingContent)
+                        {
+                            return;
+                        }
+                        job->Progress(sent, totalUploadSize);
+                        if (!hasProgressCallback || !throttle->should_emit(sent, totalUploadSize))
+                        {
+                            return;
+                        }
+
+                        m_events.PostProgress("UploadProgress", job->Id(),
+                            RN::JSValueObject{
+                                { "jobId", job->Id() },
+                                { "totalBytesExpectedToSend", totalUploadSize },
+                                { "totalBytesSent", sent },
+                            });
+                    });
+
+                HttpResponseMessage response{ nullptr };
+                try
+                {
+                    response = co_await sendOperation;
+                }
+                catch (winrt::hresult_canceled const&)
+                {
+                    throw;
+                }
+                catch (hresult_error const&)
+                {
+                    // Connection dropped mid-chunk; the server may have kept part of it
+                }
+
+                auto acknowledged{ response ? upload_offset(response) : std::nullopt };
+                if (response && response.IsSuccessStatusCode() && acknowledged && *acknowledged > offset)
+                {
+                    offset = *acknowledged;
+                    failures = 0;
+                    lastResponse = response;
+                    continue;
+                }
+
+                std::optional<std::chrono::milliseconds> retryDelay;
+                if (!response || response.StatusCode() == HttpStatusCode::Conflict || retry.IsRetryableStatus(int32_t(response.StatusCode())))
+                {
+                    retryDelay = retry.Delay(++failures, response ? retry_after(response) : std::nullopt);
+                }
+                if (!retryDelay)
+                {
+                    std::stringstream ss;
+                    ss << "EUPLOAD: job '" << jobId << "' failed to send '" << filepath << "' at offset " << offset;
+                    if (response)
+                    {
+                        ss << ", server answered " << int(response.StatusCode());
+                    }
+                    m_stats.Fail(Operation::UploadFiles, "EUPLOAD");
+                    promise.Reject(RN::ReactError{ "EUPLOAD", ss.str() });
+                    co_return;
+                }
+                ++retries;
+                if (retryDelay->count() > 0)
+                {
+                    job->SetState(JobState::Paused);
+                    co_await winrt::resume_after(*retryDelay);
+                    job->SetState(JobState::Running);
+                }
+                resync = true;
+            }
+            stream.Close();
+
+            if (auto journalItem{ co_await journalFolder.TryGetItemAsync(journalName) })
+            {
+                co_await journalItem.DeleteAsync();
+            }
+
+            completedBytes += size;
+            uploadUrls.push_back(winrt::to_string(uploadUri.AbsoluteUri()));
+        }
+
+        std::string statusCode, resultHeaders, resultContent;
+        if (lastResponse)
+        {
+            statusCode = std::to_string(int(lastResponse.StatusCode()));
+            resultHeaders = winrt::to_string(lastResponse.Headers().ToString());
+            resultContent = winrt::to_string(co_await lastResponse.Content().ReadAsStringAsync());
+        }
 
+        m_stats.AddBytes(Operation::UploadFiles, resultContent.size(), totalUploadSize);
+        m_events.Flush();
         promise.Resolve(RN::JSValueObject
             {
                 { "jobId", jobId },
                 { "statusCode", statusCode},
                 { "headers", resultHeaders},
                 { "body", resultContent},
+                { "uploadUrls", std::move(uploadUrls) },
+                { "retries", retries },
             });
     }
     catch (winrt::hresult_canceled const& ex)
     {
         std::stringstream ss;
-        ss << "CANCELLED: job '" << jobId << "' to file '" << "'";
+        ss << "CANCELLED: job '" << jobId << "', the upload can be resumed by starting it again";
+        m_stats.Fail(Operation::UploadFiles, "CANCELLED");
         promise.Reject(RN::ReactError{ std::to_string(ex.code()), ss.str(), RN::JSValueObject{} });
     }
     catch (const hresult_error& ex)
     {
+        m_stats.Fail(Operation::UploadFiles, "Error");
         promise.Reject(winrt::to_string(ex.message()).c_str());
     }
 }
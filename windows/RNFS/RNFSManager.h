@@ -2,52 +2,55 @@
 
 #pragma once
 #include "NativeModules.h"
+#include "AppendCoalescer.h"
+#include "BandwidthLimiter.h"
+#include "Deflate.h"
+#include "EventBus.h"
+#include "HttpClientPool.h"
+#include "IoScheduler.h"
+#include "JobTable.h"
+#include "OperationStats.h"
+#include "ReadSession.h"
+#include "RetryPolicy.h"
+#include "WriteSession.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
 #include <string>
 #include <mutex>
+#include <vector>
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.Security.Cryptography.h>
 #include <winrt/Windows.Security.Cryptography.Core.h>
+#include <winrt/Windows.Storage.h>
+#include <winrt/Windows.Storage.Streams.h>
 #include <winrt/Windows.Web.Http.h>
 
 namespace Cryptography = winrt::Windows::Security::Cryptography;
 namespace CryptographyCore = winrt::Windows::Security::Cryptography::Core;
 namespace RN = winrt::Microsoft::ReactNative;
 
-struct CancellationDisposable final
-{
-    CancellationDisposable() = default;
-    CancellationDisposable(winrt::Windows::Foundation::IAsyncInfo const& async, std::function<void()>&& onCancel) noexcept;
-
-    CancellationDisposable(CancellationDisposable&& other) noexcept;
-    CancellationDisposable& operator=(CancellationDisposable&& other) noexcept;
-
-    CancellationDisposable(CancellationDisposable const&) = delete;
-    CancellationDisposable& operator=(CancellationDisposable const&) = delete;
-
-    ~CancellationDisposable() noexcept;
-
-    void Cancel() noexcept;
-private:
-    winrt::Windows::Foundation::IAsyncInfo m_async{ nullptr };
-    std::function<void()> m_onCancel;
-};
+struct ParallelUploadState;
 
-struct TaskCancellationManager final
+struct DownloadParams final
 {
-    using JobId = int32_t;
-
-    TaskCancellationManager() = default;
-    ~TaskCancellationManager() noexcept;
-
-    TaskCancellationManager(TaskCancellationManager const&) = delete;
-    TaskCancellationManager& operator=(TaskCancellationManager const&) = delete;
-
-    winrt::Windows::Foundation::IAsyncAction Add(JobId jobId, winrt::Windows::Foundation::IAsyncAction const& asyncAction) noexcept;
-    void Cancel(JobId jobId) noexcept;
-
-private:
-    std::mutex m_mutex; // to protect m_pendingTasks
-    std::map<JobId, CancellationDisposable> m_pendingTasks;
+    int32_t jobId{ 0 };
+    std::shared_ptr<JobTable::Job> job; // byte counts and state, readable by anyone holding the job
+    int64_t progressInterval{ 0 };
+    int64_t progressDivider{ 0 };
+    CryptographyCore::CryptographicHash checksumHash{ nullptr }; // when set, the written bytes must hash to expectedChecksum
+    std::string expectedChecksum;
+    std::optional<StreamingInflater::Format> decompression;
+    bool preallocate{ true }; // reserve Content-Length bytes on disk before streaming
+    uint64_t maxBytesPerSecond{ 0 }; // 0 leaves the download limited only by the global limit
+    TransferPriority priority{ TransferPriority::Normal };
+    std::chrono::milliseconds connectionTimeout{ 0 }; // added to readTimeout for the wait for the response headers, see header_timeout
+    std::chrono::milliseconds readTimeout{ 0 }; // 0 waits indefinitely
+    RetryPolicy retry; // failed attempts resume from the last byte received when the server allows it
+    winrt::Windows::Storage::StorageFolder cacheFolder{ nullptr }; // set when the HTTP cache is enabled for this download
+    winrt::hstring cacheKey;
+    bool cacheValidatorsSent{ false }; // a 304 can only be served from the cache if we asked for one
 };
 
 REACT_MODULE(RNFSManager, L"RNFSManager");
@@ -80,13 +83,14 @@ struct RNFSManager final
     winrt::fire_and_forget copyFolder(
         std::string src,
         std::string dest,
+        RN::JSValueObject options,
         RN::ReactPromise<void> promise) noexcept;
 
     REACT_METHOD(getFSInfo); // Implemented, no unit tests but cannot be tested
     winrt::fire_and_forget getFSInfo(RN::ReactPromise<RN::JSValueObject> promise) noexcept;
 
     REACT_METHOD(unlink); // Implemented
-    winrt::fire_and_forget unlink(std::string filePath, RN::ReactPromise<void> promise) noexcept;
+    winrt::fire_and_forget unlink(std::string filePath, RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept;
 
     REACT_METHOD(exists); // Implemented
     winrt::fire_and_forget exists(std::string fullpath, RN::ReactPromise<bool> promise) noexcept;
@@ -97,14 +101,20 @@ struct RNFSManager final
     REACT_METHOD(stopUpload); // DOWNLOADER
     void stopUpload(int jobID) noexcept;
 
+    REACT_METHOD(cancelJob); // Implemented
+    void cancelJob(int jobID) noexcept;
+
     REACT_METHOD(readDir); // Implemented
-    winrt::fire_and_forget readDir(std::string directory, RN::ReactPromise<RN::JSValueArray> promise) noexcept;
+    winrt::fire_and_forget readDir(std::string directory, RN::JSValueObject options, RN::ReactPromise<RN::JSValue> promise) noexcept;
 
     REACT_METHOD(stat); // Implemented, unit tests incomplete
     winrt::fire_and_forget stat(std::string filepath, RN::ReactPromise<RN::JSValueObject> promise) noexcept;
 
+    REACT_METHOD(statBatch); // Implemented
+    winrt::fire_and_forget statBatch(RN::JSValueArray filepaths, RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept;
+
     REACT_METHOD(readFile); // Implemented
-    winrt::fire_and_forget readFile(std::string filePath, RN::ReactPromise<std::string> promise) noexcept;
+    winrt::fire_and_forget readFile(std::string filePath, RN::JSValueObject options, RN::ReactPromise<std::string> promise) noexcept;
 
     REACT_METHOD(read); // Implemented
     winrt::fire_and_forget read(
@@ -114,7 +124,7 @@ struct RNFSManager final
         RN::ReactPromise<std::string> promise) noexcept;
 
     REACT_METHOD(hash); // Implemented
-    winrt::fire_and_forget hash(std::string filepath, std::string algorithm, RN::ReactPromise<std::string> promise) noexcept;
+    winrt::fire_and_forget hash(std::string filepath, std::string algorithm, RN::JSValueObject options, RN::ReactPromise<std::string> promise) noexcept;
 
     REACT_METHOD(writeFile); // Implemented
     winrt::fire_and_forget writeFile(
@@ -123,7 +133,7 @@ struct RNFSManager final
         RN::JSValueObject options,
         RN::ReactPromise<void> promise) noexcept;
 
-    REACT_METHOD(appendFile); // Implemented, no unit tests
+    REACT_METHOD(appendFile); // Implemented
     winrt::fire_and_forget appendFile(
         std::string filepath,
         std::string base64Content,
@@ -138,13 +148,61 @@ struct RNFSManager final
         int position,
         RN::ReactPromise<void> promise) noexcept;
 
+    REACT_METHOD(openWrite); // Implemented
+    winrt::fire_and_forget openWrite(std::string filepath, RN::JSValueObject options, RN::ReactPromise<int32_t> promise) noexcept;
+
+    REACT_METHOD(writeChunk); // Implemented
+    winrt::fire_and_forget writeChunk(int32_t sessionId, std::string base64Content, RN::ReactPromise<void> promise) noexcept;
+
+    REACT_METHOD(closeWrite); // Implemented
+    winrt::fire_and_forget closeWrite(int32_t sessionId, RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept;
+
+    REACT_METHOD(openRead); // Implemented
+    winrt::fire_and_forget openRead(std::string filepath, RN::JSValueObject options, RN::ReactPromise<int32_t> promise) noexcept;
+
+    REACT_METHOD(readChunk); // Implemented
+    void readChunk(int32_t sessionId, RN::ReactPromise<RN::JSValueObject> promise) noexcept;
+
+    REACT_METHOD(closeRead); // Implemented
+    void closeRead(int32_t sessionId, RN::ReactPromise<void> promise) noexcept;
+
 
     REACT_METHOD(downloadFile); // DOWNLOADER
     winrt::fire_and_forget downloadFile(RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept;
 
+    REACT_METHOD(fetchToMemory); // DOWNLOADER
+    winrt::fire_and_forget fetchToMemory(RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept;
+
+    REACT_METHOD(getDownloadCacheStats); // DOWNLOADER
+    void getDownloadCacheStats(RN::ReactPromise<RN::JSValueObject> promise) noexcept;
+
+    REACT_METHOD(configureDownloadCache); // DOWNLOADER
+    void configureDownloadCache(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept;
+
+    REACT_METHOD(getStats); // Implemented
+    void getStats(RN::ReactPromise<RN::JSValueObject> promise) noexcept;
+
+    REACT_METHOD(resetStats); // Implemented
+    void resetStats(RN::ReactPromise<void> promise) noexcept;
+
+    REACT_METHOD(getJobs); // Implemented
+    void getJobs(RN::ReactPromise<RN::JSValue> promise) noexcept;
+
+    REACT_METHOD(configureHttpClient); // DOWNLOADER
+    void configureHttpClient(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept;
+
+    REACT_METHOD(configureAppendCoalescing); // Implemented
+    void configureAppendCoalescing(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept;
+
+    REACT_METHOD(setBandwidthLimit); // DOWNLOADER
+    void setBandwidthLimit(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept;
+
     REACT_METHOD(uploadFiles); // DOWNLOADER
     winrt::fire_and_forget uploadFiles(RN::JSValueObject options, RN::ReactPromise<RN::JSValueObject> promise) noexcept;
 
+    REACT_METHOD(configureUploadJournal); // DOWNLOADER
+    void configureUploadJournal(RN::JSValueObject options, RN::ReactPromise<void> promise) noexcept;
+
     REACT_METHOD(touch); // Implemented
     void touch(std::string filepath, int64_t mtime, int64_t ctime, bool modifyCreationTime, RN::ReactPromise<std::string> promise) noexcept;
 
@@ -155,16 +213,49 @@ private:
     void splitPath(const std::string& fullPath, winrt::hstring& directoryPath, winrt::hstring& fileName) noexcept;
 
     winrt::Windows::Foundation::IAsyncAction ProcessDownloadRequestAsync(RN::ReactPromise<RN::JSValueObject> promise,
-        winrt::Windows::Web::Http::HttpRequestMessage request, std::wstring_view filePath, int32_t jobId, int64_t progressInterval, int64_t progressDivider);
+        winrt::Windows::Web::Http::HttpRequestMessage request, std::wstring_view filePath, DownloadParams params);
+
+    winrt::Windows::Foundation::IAsyncAction ProcessFetchRequestAsync(RN::ReactPromise<RN::JSValueObject> promise,
+        winrt::Windows::Web::Http::HttpRequestMessage request, DownloadParams params, uint64_t maxSize, bool base64);
+
+    winrt::Windows::Foundation::IAsyncAction StoreInDownloadCache(winrt::Windows::Storage::StorageFolder cacheFolder, winrt::hstring cacheKey,
+        winrt::Windows::Storage::StorageFile file, winrt::Windows::Web::Http::HttpResponseMessage response);
+
+    winrt::Windows::Foundation::IAsyncAction RefreshDownloadCache(winrt::Windows::Storage::StorageFolder cacheFolder, winrt::hstring cacheKey,
+        winrt::Windows::Web::Http::HttpResponseMessage response);
 
     winrt::Windows::Foundation::IAsyncAction ProcessUploadRequestAsync(RN::ReactPromise<RN::JSValueObject> promise, RN::JSValueObject& options,
-        winrt::Windows::Web::Http::HttpMethod httpMethod, RN::JSValueArray const& files, int32_t jobId, uint64_t totalUploadSize);
+        winrt::Windows::Web::Http::HttpMethod httpMethod, RN::JSValueArray const& files, std::vector<winrt::Windows::Storage::Streams::IBuffer> const& partData,
+        std::shared_ptr<JobTable::Job> job, uint64_t totalUploadSize);
+
+    winrt::Windows::Foundation::IAsyncAction ProcessParallelUploadAsync(RN::ReactPromise<RN::JSValueObject> promise, RN::JSValueObject& options,
+        winrt::Windows::Web::Http::HttpMethod httpMethod, RN::JSValueArray const& files, std::vector<winrt::Windows::Storage::Streams::IBuffer> const& partData,
+        std::shared_ptr<JobTable::Job> job, uint64_t totalUploadSize);
+
+    winrt::Windows::Foundation::IAsyncAction ParallelUploadWorkerAsync(std::shared_ptr<ParallelUploadState> state);
+
+    winrt::Windows::Foundation::IAsyncAction ProcessResumableUploadAsync(RN::ReactPromise<RN::JSValueObject> promise, RN::JSValueObject& options,
+        RN::JSValueArray const& files, std::shared_ptr<JobTable::Job> job, uint64_t totalUploadSize);
+
+    winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Web::Http::HttpResponseMessage> SendUploadRequestAsync(winrt::Windows::Web::Http::HttpClient httpClient,
+        std::function<winrt::Windows::Web::Http::HttpRequestMessage()> makeRequest, RetryPolicy retry, std::shared_ptr<JobTable::Job> job);
 
-    winrt::fire_and_forget copyFolderHelper(
-        winrt::Windows::Storage::StorageFolder src,
-        winrt::Windows::Storage::StorageFolder dest) noexcept;
+    winrt::Windows::Foundation::IAsyncOperation<int64_t> QueryUploadOffsetAsync(winrt::Windows::Web::Http::HttpClient httpClient,
+        winrt::Windows::Foundation::Uri uploadUri, RN::JSValueObject const& headers, RetryPolicy retry, std::shared_ptr<JobTable::Job> job);
 
     constexpr static int64_t UNIX_EPOCH_IN_WINRT_INTERVAL = 11644473600 * 10000000;
+    constexpr static int64_t DefaultUploadProgressInterval = 100; // ms between UploadProgress events unless the caller asks otherwise
+    constexpr static uint32_t DefaultUploadChunkSize = 4 * 1024 * 1024; // bytes per PATCH in resumable uploads
+    constexpr static uint32_t MaxUploadChunkSize = 64 * 1024 * 1024; // largest PATCH, since a chunk is held in memory while it is sent
+    constexpr static int64_t DefaultMaxConcurrentUploads = 4; // requests in flight for parallel uploads
+    constexpr static uint32_t CancellableChunkSize = 1024 * 1024; // bytes readFile and hash read between checks for cancelJob
+    constexpr static uint64_t DefaultFetchMaxSize = 10 * 1024 * 1024; // largest body fetchToMemory holds unless the caller allows more
+    constexpr static int64_t MaxWriteSessionBufferSize = 64 * 1024 * 1024; // largest buffer openWrite gives a session
+    constexpr static int64_t MaxReadSessionChunkSize = 16 * 1024 * 1024; // largest chunk readChunk returns
+    constexpr static int64_t MaxReadSessionReadAhead = 16; // chunks a read session may hold beyond the one taken
+    constexpr static int64_t MaxAppendDelay = 1000; // ms an append may wait for others to share its write
+    constexpr static int64_t MaxAppendRunSize = 16 * 1024 * 1024; // largest write appends are coalesced into
+    constexpr static int MaxUploadChunkRetries = 3; // consecutive failed requests before a resumable upload without a retry option gives up
      
     const std::unordered_map<std::string, std::function<CryptographyCore::HashAlgorithmProvider()>> availableHashes{
         {"md5", []() { return CryptographyCore::HashAlgorithmProvider::OpenAlgorithm(CryptographyCore::HashAlgorithmNames::Md5()); } },
@@ -175,6 +266,22 @@ private:
     };
 
     RN::ReactContext m_reactContext;
-    winrt::Windows::Web::Http::HttpClient m_httpClient;
-    TaskCancellationManager m_tasks;
+    HttpClientPool m_httpClients;
+    BandwidthLimiter m_bandwidth; // declared before m_jobs so it outlives the transfers using it
+    OperationStats m_stats; // likewise
+    EventBus m_events; // likewise
+    JobTable m_jobs;
+    WriteSessionTable m_writeSessions;
+    ReadSessionTable m_readSessions; // its sessions read through m_io, which rejects their queued reads first
+    AppendCoalescer m_appends; // likewise, and writes what was submitted when destroyed
+    IoScheduler m_io; // declared last so operations still queued are rejected while the members above exist
+
+    std::mutex m_foldersMutex; // to protect the folders below
+    std::wstring m_cacheFolderPath; // empty keeps the download cache in the app's local cache folder
+    std::wstring m_journalFolderPath; // empty keeps the tus journal in the app's local folder
+
+    // HTTP download cache statistics
+    std::atomic<uint64_t> m_cacheHits{ 0 };
+    std::atomic<uint64_t> m_cacheMisses{ 0 };
+    std::atomic<uint64_t> m_cacheBytesServed{ 0 };
 };
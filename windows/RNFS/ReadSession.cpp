@@ -0,0 +1,311 @@
+#include "pch.h"
+
+#include "ReadSession.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace winrt::Windows::System::Threading;
+
+static constexpr winrt::hresult Aborted{ HRESULT_FROM_WIN32(ERROR_OPERATION_ABORTED) };
+
+std::shared_ptr<ReadSession> ReadSession::Open(std::filesystem::path const& path, IoScheduler& io,
+    size_t chunkSize, size_t readAhead, TransferPriority priority)
+{
+    auto session{ std::make_shared<ReadSession>(path, io, chunkSize, readAhead, priority) };
+    session->StartReading();
+    return session;
+}
+
+ReadSession::ReadSession(std::filesystem::path const& path, IoScheduler& io, size_t chunkSize, size_t readAhead, TransferPriority priority)
+    : m_io{ io },
+      m_chunkSize{ std::max<size_t>(chunkSize, 1) },
+      m_readAhead{ readAhead },
+      m_priority{ priority },
+      m_file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr) }
+{
+    if (!m_file)
+    {
+        winrt::throw_last_error();
+    }
+
+    LARGE_INTEGER size{};
+    winrt::check_bool(GetFileSizeEx(m_file.get(), &size));
+    m_size = static_cast<uint64_t>(size.QuadPart);
+}
+
+void ReadSession::Next(Completion done)
+{
+    Chunk chunk;
+    bool waiting{ false };
+    {
+        std::lock_guard lock{ m_mutex };
+        m_lastUsed = std::chrono::steady_clock::now();
+        if (m_closed)
+        {
+            chunk.eof = true;
+            chunk.error = Aborted;
+        }
+        else if (!m_ready.empty())
+        {
+            chunk = std::move(m_ready.front());
+            m_ready.pop_front();
+        }
+        else if (m_finished)
+        {
+            chunk.eof = true;
+        }
+        else
+        {
+            m_waiting.push_back(std::move(done));
+            waiting = true;
+        }
+    }
+
+    // Taking a chunk leaves room for another, and a waiting call needs one
+    StartReading();
+    if (!waiting)
+    {
+        done(std::move(chunk));
+    }
+}
+
+void ReadSession::Close() noexcept
+{
+    std::deque<Completion> waiting;
+    {
+        std::lock_guard lock{ m_mutex };
+        m_closed = true;
+        m_ready.clear();
+        waiting.swap(m_waiting);
+    }
+    for (auto& done : waiting)
+    {
+        done(Chunk{ {}, true, Aborted });
+    }
+}
+
+bool ReadSession::CloseIfIdle(std::chrono::steady_clock::time_point since) noexcept
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        if (!m_waiting.empty() || m_lastUsed >= since)
+        {
+            return false;
+        }
+    }
+    Close();
+    return true;
+}
+
+uint64_t ReadSession::Size() const noexcept
+{
+    return m_size;
+}
+
+uint64_t ReadSession::BytesRead() const noexcept
+{
+    std::lock_guard lock{ m_mutex };
+    return m_bytesRead;
+}
+
+size_t ReadSession::Buffered() const noexcept
+{
+    std::lock_guard lock{ m_mutex };
+    return m_ready.size();
+}
+
+bool ReadSession::WantsRead() const noexcept
+{
+    // Waiting calls take the chunks as they come, so only ReadAhead more are kept
+    return !m_closed && !m_finished && m_ready.size() < m_readAhead + m_waiting.size();
+}
+
+void ReadSession::StartReading()
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        if (m_reading || !WantsRead())
+        {
+            return;
+        }
+        m_reading = true;
+    }
+    ReadAhead(shared_from_this()); // runs until its first co_await, which always suspends
+}
+
+winrt::fire_and_forget ReadSession::ReadAhead(std::shared_ptr<ReadSession> self)
+{
+    for (;;)
+    {
+        auto priority{ TransferPriority::Background };
+        {
+            std::lock_guard lock{ self->m_mutex };
+            if (!self->WantsRead())
+            {
+                self->m_reading = false;
+                break;
+            }
+            if (!self->m_waiting.empty())
+            {
+                priority = self->m_priority;
+            }
+        }
+
+        Chunk chunk;
+        try
+        {
+            auto slot{ co_await self->m_io.Schedule(priority) };
+            chunk = self->Read();
+        }
+        catch (winrt::hresult_error const& ex)
+        {
+            chunk.eof = true;
+            chunk.error = ex.code();
+        }
+        self->Deliver(std::move(chunk));
+    }
+}
+
+ReadSession::Chunk ReadSession::Read()
+{
+    Chunk chunk;
+    chunk.bytes.resize(static_cast<size_t>(std::min<uint64_t>(m_chunkSize, m_size - m_position)));
+
+    size_t filled{ 0 };
+    while (filled < chunk.bytes.size())
+    {
+        DWORD read{ 0 };
+        auto wanted{ static_cast<DWORD>(std::min<size_t>(chunk.bytes.size() - filled, MAXDWORD)) };
+        winrt::check_bool(ReadFile(m_file.get(), chunk.bytes.data() + filled, wanted, &read, nullptr));
+        if (read == 0)
+        {
+            break; // the file was truncated since it was opened
+        }
+        filled += read;
+    }
+    chunk.bytes.resize(filled);
+
+    m_position += filled;
+    chunk.eof = m_position >= m_size || filled == 0;
+    return chunk;
+}
+
+void ReadSession::Deliver(Chunk chunk)
+{
+    Completion done;
+    {
+        std::lock_guard lock{ m_mutex };
+        m_bytesRead += chunk.bytes.size();
+        if (chunk.eof)
+        {
+            m_finished = true;
+        }
+        if (m_closed)
+        {
+            return;
+        }
+        if (m_waiting.empty())
+        {
+            m_ready.push_back(std::move(chunk));
+            return;
+        }
+        done = std::move(m_waiting.front());
+        m_waiting.pop_front();
+    }
+    done(std::move(chunk));
+}
+
+ReadSessionTable::~ReadSessionTable() noexcept
+{
+    if (m_timer)
+    {
+        m_timer.Cancel();
+    }
+}
+
+ReadSessionTable::SessionId ReadSessionTable::Add(std::shared_ptr<ReadSession> session, std::chrono::milliseconds idleTimeout)
+{
+    std::lock_guard lock{ m_state->mutex };
+    auto sessionId{ ++m_state->nextId };
+    m_state->sessions.emplace(sessionId, Entry{ std::move(session), idleTimeout });
+    ++m_state->counters.opened;
+
+    if (!m_timer)
+    {
+        m_timer = ThreadPoolTimer::CreatePeriodicTimer([state = m_state](ThreadPoolTimer const&)
+            {
+                Sweep(*state, std::chrono::steady_clock::now());
+            }, SweepInterval);
+    }
+    return sessionId;
+}
+
+std::shared_ptr<ReadSession> ReadSessionTable::Find(SessionId sessionId) const noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    auto found{ m_state->sessions.find(sessionId) };
+    return found != m_state->sessions.end() ? found->second.session : nullptr;
+}
+
+bool ReadSessionTable::Remove(SessionId sessionId) noexcept
+{
+    std::shared_ptr<ReadSession> session;
+    {
+        std::lock_guard lock{ m_state->mutex };
+        auto found{ m_state->sessions.find(sessionId) };
+        if (found == m_state->sessions.end())
+        {
+            return false;
+        }
+        session = std::move(found->second.session);
+        m_state->sessions.erase(found);
+    }
+    session->Close();
+    return true;
+}
+
+size_t ReadSessionTable::Sweep(std::chrono::steady_clock::time_point now) noexcept
+{
+    return Sweep(*m_state, now);
+}
+
+size_t ReadSessionTable::Sweep(State& state, std::chrono::steady_clock::time_point now) noexcept
+{
+    std::lock_guard lock{ state.mutex };
+    size_t expired{ 0 };
+    for (auto it = state.sessions.begin(); it != state.sessions.end();)
+    {
+        // Nothing is waiting, so closing under the table lock calls back nobody
+        if (it->second.session->CloseIfIdle(now - it->second.idleTimeout))
+        {
+            it = state.sessions.erase(it);
+            ++expired;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    state.counters.expired += expired;
+    return expired;
+}
+
+size_t ReadSessionTable::Size() const noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    return m_state->sessions.size();
+}
+
+ReadSessionTable::Counters ReadSessionTable::Snapshot() const noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    return m_state->counters;
+}
+
+void ReadSessionTable::Reset() noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    m_state->counters = {};
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.System.Threading.h>
+#include "IoScheduler.h"
+
+//
+// A file kept open for reading it front to back in chunks. The caller pulls
+// chunks with Next, in order; meanwhile the session reads up to ReadAhead
+// chunks past the last one taken, in slots of the I/O scheduler, and stops
+// there until the caller takes another, so a slow consumer holds at most
+// ReadAhead chunks in memory. A read the caller is waiting for runs at the
+// session's priority, one only read ahead in the background lane. The file is
+// read up to the size it had when it was opened.
+//
+struct ReadSession final : std::enable_shared_from_this<ReadSession>
+{
+    struct Chunk
+    {
+        std::vector<uint8_t> bytes;
+        bool eof{ false }; // no chunk follows this one
+        winrt::hresult error; // S_OK, or why the chunk could not be read
+    };
+
+    using Completion = std::function<void(Chunk)>;
+
+    static constexpr size_t DefaultChunkSize = 256 * 1024;
+    static constexpr size_t DefaultReadAhead = 2;
+
+    // Opens path and starts reading ahead
+    static std::shared_ptr<ReadSession> Open(std::filesystem::path const& path, IoScheduler& io,
+        size_t chunkSize = DefaultChunkSize, size_t readAhead = DefaultReadAhead, TransferPriority priority = TransferPriority::Normal);
+
+    ReadSession(std::filesystem::path const& path, IoScheduler& io, size_t chunkSize, size_t readAhead, TransferPriority priority);
+    ReadSession(ReadSession const&) = delete;
+    ReadSession& operator=(ReadSession const&) = delete;
+
+    // `done` gets the chunk after the one of the previous call, on this thread when it was read already;
+    // past the end it gets an empty chunk with eof set
+    void Next(Completion done);
+
+    // Stops reading ahead; waiting and later Next calls get ERROR_OPERATION_ABORTED
+    void Close() noexcept;
+
+    // Closes the session when nobody waits for a chunk and nothing was taken since `since`
+    bool CloseIfIdle(std::chrono::steady_clock::time_point since) noexcept;
+
+    uint64_t Size() const noexcept;
+    uint64_t BytesRead() const noexcept;
+    size_t Buffered() const noexcept; // chunks read but not taken yet
+
+private:
+    static winrt::fire_and_forget ReadAhead(std::shared_ptr<ReadSession> self);
+
+    bool WantsRead() const noexcept; // under m_mutex
+    void StartReading();
+    Chunk Read(); // only by the ReadAhead running
+    void Deliver(Chunk chunk);
+
+    IoScheduler& m_io;
+    size_t const m_chunkSize;
+    size_t const m_readAhead;
+    TransferPriority const m_priority;
+    winrt::file_handle m_file; // only read by the ReadAhead running
+    uint64_t m_size{ 0 };
+    uint64_t m_position{ 0 }; // likewise
+
+    mutable std::mutex m_mutex; // to protect everything below
+    std::deque<Chunk> m_ready;
+    std::deque<Completion> m_waiting; // Next calls in call order
+    bool m_reading{ false }; // a ReadAhead is running
+    bool m_finished{ false }; // the last chunk was read, or failed
+    bool m_closed{ false };
+    uint64_t m_bytesRead{ 0 };
+    std::chrono::steady_clock::time_point m_lastUsed{ std::chrono::steady_clock::now() };
+};
+
+//
+// The read sessions opened from JS, by session id. Like write sessions, those
+// left unused for their idle timeout are closed by a periodic sweep.
+//
+struct ReadSessionTable final
+{
+    using SessionId = int32_t;
+
+    struct Counters
+    {
+        uint64_t opened{ 0 };
+        uint64_t expired{ 0 }; // closed by the sweep rather than by closeRead
+    };
+
+    static constexpr std::chrono::milliseconds DefaultIdleTimeout{ 60000 };
+    static constexpr std::chrono::milliseconds SweepInterval{ 1000 };
+
+    ReadSessionTable() = default;
+    ~ReadSessionTable() noexcept;
+
+    ReadSessionTable(ReadSessionTable const&) = delete;
+    ReadSessionTable& operator=(ReadSessionTable const&) = delete;
+
+    SessionId Add(std::shared_ptr<ReadSession> session, std::chrono::milliseconds idleTimeout = DefaultIdleTimeout);
+    std::shared_ptr<ReadSession> Find(SessionId sessionId) const noexcept;
+
+    // Forgets the session and closes it; false when there was none
+    bool Remove(SessionId sessionId) noexcept;
+
+    // Closes the sessions idle for longer than their timeout at `now`, returns how many
+    size_t Sweep(std::chrono::steady_clock::time_point now) noexcept;
+
+    size_t Size() const noexcept;
+    Counters Snapshot() const noexcept;
+    void Reset() noexcept;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<ReadSession> session;
+        std::chrono::milliseconds idleTimeout;
+    };
+
+    struct State
+    {
+        mutable std::mutex mutex; // to protect everything below
+        std::unordered_map<SessionId, Entry> sessions;
+        SessionId nextId{ 0 };
+        Counters counters;
+    };
+
+    static size_t Sweep(State& state, std::chrono::steady_clock::time_point now) noexcept;
+
+    std::shared_ptr<State> m_state{ std::make_shared<State>() }; // shared with the sweep timer
+    winrt::Windows::System::Threading::ThreadPoolTimer m_timer{ nullptr };
+};
@@ -0,0 +1,43 @@
+#include "pch.h"
+
+#include "RetryPolicy.h"
+
+#include <algorithm>
+#include <random>
+
+bool RetryPolicy::IsRetryableStatus(int32_t statusCode) const noexcept
+{
+    return std::find(retryableStatusCodes.begin(), retryableStatusCodes.end(), statusCode) != retryableStatusCodes.end();
+}
+
+std::optional<std::chrono::milliseconds> RetryPolicy::Delay(uint32_t attempt,
+    std::optional<std::chrono::milliseconds> retryAfter) const noexcept
+{
+    thread_local std::minstd_rand random{ std::random_device{}() };
+    return Delay(attempt, retryAfter, std::uniform_real_distribution<double>{ 0.0, 1.0 }(random));
+}
+
+std::optional<std::chrono::milliseconds> RetryPolicy::Delay(uint32_t attempt,
+    std::optional<std::chrono::milliseconds> retryAfter, double jitter) const noexcept
+{
+    if (attempt >= maxAttempts || (retryAfter && *retryAfter > maxDelay))
+    {
+        return std::nullopt;
+    }
+
+    // initialDelay * 2^(attempt - 1), saturating at maxDelay
+    auto ceiling{ std::max<int64_t>(initialDelay.count(), 0) };
+    for (uint32_t i = 1; i < attempt && ceiling < maxDelay.count(); ++i)
+    {
+        ceiling *= 2;
+    }
+    ceiling = std::min<int64_t>(ceiling, maxDelay.count());
+
+    auto const half{ static_cast<double>(ceiling) / 2 };
+    std::chrono::milliseconds delay{ static_cast<int64_t>(half + half * std::clamp(jitter, 0.0, 1.0)) };
+    if (retryAfter)
+    {
+        delay = std::max(delay, *retryAfter);
+    }
+    return delay;
+}
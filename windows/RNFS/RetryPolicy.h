@@ -0,0 +1,32 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+//
+// Decides whether a failed transfer attempt is tried again and how long to
+// wait first. Delays grow exponentially from initialDelay up to maxDelay, and
+// each one is drawn from the upper half of its range so that clients failing
+// together do not retry together. A server's Retry-After is honoured as a
+// lower bound on the wait.
+//
+struct RetryPolicy final
+{
+    uint32_t maxAttempts{ 1 }; // 1 never retries
+    std::chrono::milliseconds initialDelay{ 500 };
+    std::chrono::milliseconds maxDelay{ 30000 };
+    std::vector<int32_t> retryableStatusCodes{ 408, 429, 500, 502, 503, 504 };
+
+    bool IsRetryableStatus(int32_t statusCode) const noexcept;
+
+    // How long to wait after `attempt` (1 based) failed, or nullopt when it
+    // must not be retried: no attempts are left, or the server asked to wait
+    // longer than maxDelay.
+    std::optional<std::chrono::milliseconds> Delay(uint32_t attempt,
+        std::optional<std::chrono::milliseconds> retryAfter) const noexcept;
+
+    // As above with the random part fixed; `jitter` is in [0, 1]
+    std::optional<std::chrono::milliseconds> Delay(uint32_t attempt,
+        std::optional<std::chrono::milliseconds> retryAfter, double jitter) const noexcept;
+};
@@ -0,0 +1,17 @@
+#pragma once
+#ifdef RNFS_TEST_HOOKS
+#include <cstdint>
+#include <functional>
+
+//
+// Places where the unit tests can step into the module. They are only compiled
+// in when RNFS_TEST_HOOKS is defined, which RNFSWinUnitTest does; the module
+// itself and RNFS.Bench never see them.
+//
+namespace TestHooks
+{
+    // Called on the job's own thread whenever a job reports progress, so that a
+    // test can cancel a file operation at a point where it is known to be running
+    inline std::function<void(int32_t jobId)> JobProgress;
+}
+#endif
@@ -0,0 +1,32 @@
+#include "pch.h"
+
+#include "ThrottledInputStream.h"
+
+using namespace winrt;
+using namespace winrt::Windows::Foundation;
+using namespace winrt::Windows::Storage::Streams;
+
+ThrottledInputStream::ThrottledInputStream(IInputStream const& source, BandwidthLimiter& limiter, BandwidthLimiter::JobId jobId) noexcept
+    : m_source{ source },
+      m_limiter{ limiter },
+      m_jobId{ jobId }
+{
+}
+
+IAsyncOperationWithProgress<IBuffer, uint32_t> ThrottledInputStream::ReadAsync(IBuffer buffer, uint32_t count, InputStreamOptions options)
+{
+    auto strong{ get_strong() };
+
+    auto result{ co_await m_source.ReadAsync(buffer, count, options) };
+    auto delay{ m_limiter.Acquire(m_jobId, result.Length()) };
+    if (delay.count() > 0)
+    {
+        co_await winrt::resume_after(delay);
+    }
+    co_return result;
+}
+
+void ThrottledInputStream::Close()
+{
+    m_source.Close();
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "BandwidthLimiter.h"
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.Storage.Streams.h>
+
+//
+// An input stream that paces reads from another one through a BandwidthLimiter,
+// for request bodies whose upload should be rate limited.
+//
+struct ThrottledInputStream : winrt::implements<ThrottledInputStream, winrt::Windows::Storage::Streams::IInputStream>
+{
+    ThrottledInputStream(winrt::Windows::Storage::Streams::IInputStream const& source, BandwidthLimiter& limiter, BandwidthLimiter::JobId jobId) noexcept;
+
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<winrt::Windows::Storage::Streams::IBuffer, uint32_t> ReadAsync(
+        winrt::Windows::Storage::Streams::IBuffer buffer, uint32_t count, winrt::Windows::Storage::Streams::InputStreamOptions options);
+    void Close();
+
+private:
+    winrt::Windows::Storage::Streams::IInputStream m_source;
+    BandwidthLimiter& m_limiter;
+    BandwidthLimiter::JobId m_jobId;
+};
@@ -0,0 +1,55 @@
+#include "pch.h"
+
+#include "TransferWatchdog.h"
+
+#include <algorithm>
+
+using namespace winrt::Windows::Foundation;
+using namespace winrt::Windows::System::Threading;
+
+TransferWatchdog::~TransferWatchdog() noexcept
+{
+    if (m_timer)
+    {
+        m_timer.Cancel();
+    }
+}
+
+void TransferWatchdog::Watch(IAsyncInfo const& operation, std::chrono::milliseconds timeout)
+{
+    {
+        std::scoped_lock lock{ m_state->mutex };
+        m_state->operation = timeout.count() > 0 ? operation : nullptr;
+        m_state->deadline = std::chrono::steady_clock::now() + timeout;
+    }
+
+    if (!m_timer && timeout.count() > 0)
+    {
+        // Checking a few times per timeout keeps the overshoot small without waking up per read
+        auto period{ std::clamp(timeout / 4, std::chrono::milliseconds{ 50 }, std::chrono::milliseconds{ 1000 }) };
+        m_timer = ThreadPoolTimer::CreatePeriodicTimer([state = m_state](ThreadPoolTimer const&)
+            {
+                std::scoped_lock lock{ state->mutex };
+                if (state->operation && state->operation.Status() == AsyncStatus::Started &&
+                    std::chrono::steady_clock::now() > state->deadline)
+                {
+                    state->expired = true;
+                    state->operation.Cancel();
+                    state->operation = nullptr;
+                }
+            }, period);
+    }
+}
+
+bool TransferWatchdog::Expired() const noexcept
+{
+    std::scoped_lock lock{ m_state->mutex };
+    return m_state->expired;
+}
+
+void TransferWatchdog::Reset() noexcept
+{
+    std::scoped_lock lock{ m_state->mutex };
+    m_state->operation = nullptr;
+    m_state->expired = false;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.System.Threading.h>
+
+//
+// Enforces connection and read timeouts for a transfer. The operation the
+// transfer is currently waiting on is cancelled once it has been running longer
+// than the timeout it was watched with, so a stalled connection fails instead
+// of hanging. One timer serves the whole transfer rather than one per read.
+//
+struct TransferWatchdog final
+{
+    TransferWatchdog() = default;
+    ~TransferWatchdog() noexcept;
+
+    TransferWatchdog(TransferWatchdog const&) = delete;
+    TransferWatchdog& operator=(TransferWatchdog const&) = delete;
+
+    // Replaces the watched operation; a zero timeout stops watching
+    void Watch(winrt::Windows::Foundation::IAsyncInfo const& operation, std::chrono::milliseconds timeout);
+
+    // True once an operation was cancelled for exceeding its timeout
+    bool Expired() const noexcept;
+
+    // Stops watching and clears Expired, before a transfer is attempted again
+    void Reset() noexcept;
+
+private:
+    struct State
+    {
+        std::mutex mutex; // to protect everything below
+        winrt::Windows::Foundation::IAsyncInfo operation{ nullptr };
+        std::chrono::steady_clock::time_point deadline;
+        bool expired{ false };
+    };
+
+    std::shared_ptr<State> m_state{ std::make_shared<State>() }; // shared with the timer callback
+    winrt::Windows::System::Threading::ThreadPoolTimer m_timer{ nullptr };
+};
@@ -0,0 +1,302 @@
+#include "pch.h"
+
+#include "WriteSession.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace winrt::Windows::System::Threading;
+
+WriteSession::WriteSession(std::filesystem::path const& path, bool append, size_t bufferSize)
+    : m_bufferSize{ std::max<size_t>(bufferSize, 1) },
+      m_file{ CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, append ? OPEN_ALWAYS : CREATE_ALWAYS,
+          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr) }
+{
+    if (!m_file)
+    {
+        winrt::throw_last_error();
+    }
+    if (append)
+    {
+        winrt::check_bool(SetFilePointerEx(m_file.get(), LARGE_INTEGER{}, nullptr, FILE_END));
+    }
+    m_buffer.reserve(m_bufferSize);
+}
+
+WriteSession::~WriteSession() noexcept
+{
+    std::lock_guard drain{ m_drainMutex };
+    if (m_file && m_error == S_OK)
+    {
+        try
+        {
+            Flush();
+        }
+        catch (winrt::hresult_error const&)
+        {
+            // Nobody is left to tell
+        }
+    }
+}
+
+WriteSession::Ticket WriteSession::Reserve() noexcept
+{
+    std::lock_guard lock{ m_mutex };
+    m_lastUsed = std::chrono::steady_clock::now();
+    return m_nextTicket++;
+}
+
+void WriteSession::Submit(Ticket ticket, std::vector<uint8_t> bytes, Completion done)
+{
+    Enqueue(ticket, Entry{ std::move(bytes), std::move(done) });
+}
+
+void WriteSession::Skip(Ticket ticket)
+{
+    Enqueue(ticket, Entry{});
+}
+
+void WriteSession::SubmitClose(Ticket ticket, bool fsync, Completion done)
+{
+    Enqueue(ticket, Entry{ {}, std::move(done), true, fsync });
+}
+
+void WriteSession::Enqueue(Ticket ticket, Entry entry)
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        m_ready.emplace(ticket, std::move(entry));
+        m_lastUsed = std::chrono::steady_clock::now();
+    }
+    Drain();
+}
+
+void WriteSession::Drain()
+{
+    for (;;)
+    {
+        {
+            // Whoever drains already will write our entry too, or see it below once done
+            std::unique_lock drain{ m_drainMutex, std::try_to_lock };
+            if (!drain)
+            {
+                return;
+            }
+
+            for (;;)
+            {
+                Entry entry;
+                {
+                    std::lock_guard lock{ m_mutex };
+                    auto next{ m_ready.find(m_nextToWrite) };
+                    if (next == m_ready.end())
+                    {
+                        break;
+                    }
+                    entry = std::move(next->second);
+                    m_ready.erase(next);
+                    ++m_nextToWrite;
+                }
+
+                if (m_error == S_OK)
+                {
+                    try
+                    {
+                        if (entry.close)
+                        {
+                            Close(entry.fsync);
+                        }
+                        else
+                        {
+                            Write(entry.bytes.data(), entry.bytes.size());
+                        }
+                    }
+                    catch (winrt::hresult_error const& ex)
+                    {
+                        m_error = ex.code();
+                    }
+                }
+                if (entry.close)
+                {
+                    m_file.close();
+                }
+                if (entry.done)
+                {
+                    entry.done(m_error);
+                }
+            }
+        }
+
+        // An entry submitted while we were finishing found the drain mutex taken
+        std::lock_guard lock{ m_mutex };
+        if (m_ready.find(m_nextToWrite) == m_ready.end())
+        {
+            return;
+        }
+    }
+}
+
+void WriteSession::Write(uint8_t const* data, size_t size)
+{
+    if (m_buffer.size() + size > m_bufferSize)
+    {
+        Flush();
+    }
+
+    if (size >= m_bufferSize)
+    {
+        WriteAll(data, size);
+    }
+    else
+    {
+        m_buffer.insert(m_buffer.end(), data, data + size);
+    }
+}
+
+void WriteSession::WriteAll(uint8_t const* data, size_t size)
+{
+    while (size > 0)
+    {
+        DWORD written{ 0 };
+        winrt::check_bool(WriteFile(m_file.get(), data, static_cast<DWORD>(std::min<size_t>(size, MAXDWORD)), &written, nullptr));
+        m_bytesWritten.fetch_add(written, std::memory_order_relaxed);
+        data += written;
+        size -= written;
+    }
+}
+
+void WriteSession::Flush()
+{
+    WriteAll(m_buffer.data(), m_buffer.size());
+    m_buffer.clear(); // keeps the capacity for the next bytes
+}
+
+void WriteSession::Close(bool fsync)
+{
+    Flush();
+    if (fsync)
+    {
+        winrt::check_bool(FlushFileBuffers(m_file.get()));
+    }
+}
+
+bool WriteSession::Idle(std::chrono::steady_clock::time_point since) const noexcept
+{
+    std::lock_guard lock{ m_mutex };
+    return m_nextToWrite == m_nextTicket && m_lastUsed < since;
+}
+
+uint64_t WriteSession::BytesWritten() const noexcept
+{
+    return m_bytesWritten.load(std::memory_order_relaxed);
+}
+
+WriteSessionTable::~WriteSessionTable() noexcept
+{
+    if (m_timer)
+    {
+        m_timer.Cancel();
+    }
+}
+
+WriteSessionTable::SessionId WriteSessionTable::Add(std::shared_ptr<WriteSession> session, std::chrono::milliseconds idleTimeout)
+{
+    std::lock_guard lock{ m_state->mutex };
+    auto sessionId{ ++m_state->nextId };
+    m_state->sessions.emplace(sessionId, Entry{ std::move(session), idleTimeout });
+    ++m_state->counters.opened;
+
+    if (!m_timer)
+    {
+        m_timer = ThreadPoolTimer::CreatePeriodicTimer([state = m_state](ThreadPoolTimer const&)
+            {
+                Sweep(*state, std::chrono::steady_clock::now());
+            }, SweepInterval);
+    }
+    return sessionId;
+}
+
+WriteSessionTable::Lease WriteSessionTable::Reserve(SessionId sessionId) noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    auto found{ m_state->sessions.find(sessionId) };
+    if (found == m_state->sessions.end())
+    {
+        return {};
+    }
+    return { found->second.session, found->second.session->Reserve() };
+}
+
+WriteSessionTable::Lease WriteSessionTable::Remove(SessionId sessionId) noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    auto found{ m_state->sessions.find(sessionId) };
+    if (found == m_state->sessions.end())
+    {
+        return {};
+    }
+    Lease lease{ std::move(found->second.session) };
+    lease.ticket = lease.session->Reserve();
+    m_state->sessions.erase(found);
+    return lease;
+}
+
+size_t WriteSessionTable::Sweep(std::chrono::steady_clock::time_point now) noexcept
+{
+    return Sweep(*m_state, now);
+}
+
+size_t WriteSessionTable::Sweep(State& state, std::chrono::steady_clock::time_point now) noexcept
+{
+    // Idle and Reserve are both checked under the table lock, so no write can slip in before the close
+    std::vector<Lease> expired;
+    {
+        std::lock_guard lock{ state.mutex };
+        for (auto it = state.sessions.begin(); it != state.sessions.end();)
+        {
+            if (it->second.session->Idle(now - it->second.idleTimeout))
+            {
+                Lease lease{ std::move(it->second.session) };
+                lease.ticket = lease.session->Reserve();
+                expired.push_back(std::move(lease));
+                it = state.sessions.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        state.counters.expired += expired.size();
+    }
+
+    for (auto& lease : expired)
+    {
+        try
+        {
+            lease.session->SubmitClose(lease.ticket, false, nullptr);
+        }
+        catch (...)
+        {
+            // The session is gone either way
+        }
+    }
+    return expired.size();
+}
+
+size_t WriteSessionTable::Size() const noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    return m_state->sessions.size();
+}
+
+WriteSessionTable::Counters WriteSessionTable::Snapshot() const noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    return m_state->counters;
+}
+
+void WriteSessionTable::Reset() noexcept
+{
+    std::lock_guard lock{ m_state->mutex };
+    m_state->counters = {};
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <winrt/Windows.Foundation.h>
+#include <winrt/Windows.System.Threading.h>
+
+//
+// A file kept open for a sequence of writes. Each write takes a ticket when it
+// is called and submits its bytes once they are ready, which may be out of
+// order; whoever submits writes every ticket that is next in line, so the file
+// receives the bytes in call order however the submissions race. Bytes are
+// gathered in a buffer and written once the next chunk would overflow it; a
+// chunk at least as large as the buffer goes to the file directly. Once a write fails every later
+// one, and the close, fails with the same error.
+//
+struct WriteSession final
+{
+    using Ticket = uint64_t;
+    using Completion = std::function<void(winrt::hresult)>; // S_OK or the error the write failed with
+
+    static constexpr size_t DefaultBufferSize = 1024 * 1024;
+
+    // Opens path for writing, at its end when append is set and truncated otherwise
+    WriteSession(std::filesystem::path const& path, bool append, size_t bufferSize = DefaultBufferSize);
+    WriteSession(WriteSession const&) = delete;
+    WriteSession& operator=(WriteSession const&) = delete;
+
+    // Writes what is buffered and closes the file, unless a close was submitted
+    ~WriteSession() noexcept;
+
+    Ticket Reserve() noexcept;
+
+    // `done` runs once the bytes are buffered or written, on the thread writing them
+    void Submit(Ticket ticket, std::vector<uint8_t> bytes, Completion done);
+
+    // Gives up a ticket whose bytes could not be prepared
+    void Skip(Ticket ticket);
+
+    // Writes what is buffered, flushes it to the disk when fsync is set and closes the file
+    void SubmitClose(Ticket ticket, bool fsync, Completion done);
+
+    // True when every ticket was submitted and nothing was used since `since`
+    bool Idle(std::chrono::steady_clock::time_point since) const noexcept;
+
+    uint64_t BytesWritten() const noexcept;
+
+private:
+    struct Entry
+    {
+        std::vector<uint8_t> bytes;
+        Completion done;
+        bool close{ false };
+        bool fsync{ false };
+    };
+
+    void Enqueue(Ticket ticket, Entry entry);
+    void Drain();
+    void Write(uint8_t const* data, size_t size);
+    void WriteAll(uint8_t const* data, size_t size);
+    void Flush();
+    void Close(bool fsync);
+
+    size_t const m_bufferSize;
+    winrt::file_handle m_file; // only touched while draining
+
+    std::mutex m_drainMutex; // held while entries are written, so one thread writes at a time
+    std::vector<uint8_t> m_buffer; // guarded by m_drainMutex
+    winrt::hresult m_error; // likewise, the first write that failed
+
+    mutable std::mutex m_mutex; // to protect everything below
+    Ticket m_nextTicket{ 0 };
+    Ticket m_nextToWrite{ 0 }; // the ticket whose entry the drain takes next
+    std::map<Ticket, Entry> m_ready; // submitted entries not written yet
+    std::chrono::steady_clock::time_point m_lastUsed{ std::chrono::steady_clock::now() };
+
+    std::atomic<uint64_t> m_bytesWritten{ 0 };
+};
+
+//
+// The write sessions opened from JS, by session id. Sessions left unused for
+// their idle timeout are closed by a periodic sweep, so a script that never
+// calls closeWrite does not keep the file open and locked for good.
+//
+struct WriteSessionTable final
+{
+    using SessionId = int32_t;
+
+    struct Counters
+    {
+        uint64_t opened{ 0 };
+        uint64_t expired{ 0 }; // closed by the sweep rather than by closeWrite
+    };
+
+    // A session with a ticket taken for the caller's write or close
+    struct Lease
+    {
+        std::shared_ptr<WriteSession> session; // null for an unknown or closed session
+        WriteSession::Ticket ticket{ 0 };
+    };
+
+    static constexpr std::chrono::milliseconds DefaultIdleTimeout{ 60000 };
+    static constexpr std::chrono::milliseconds SweepInterval{ 1000 };
+
+    WriteSessionTable() = default;
+    ~WriteSessionTable() noexcept;
+
+    WriteSessionTable(WriteSessionTable const&) = delete;
+    WriteSessionTable& operator=(WriteSessionTable const&) = delete;
+
+    SessionId Add(std::shared_ptr<WriteSession> session, std::chrono::milliseconds idleTimeout = DefaultIdleTimeout);
+
+    // Takes a ticket for a write in the session
+    Lease Reserve(SessionId sessionId) noexcept;
+
+    // Forgets the session and takes the ticket for its close
+    Lease Remove(SessionId sessionId) noexcept;
+
+    // Closes the sessions idle for longer than their timeout at `now`, returns how many
+    size_t Sweep(std::chrono::steady_clock::time_point now) noexcept;
+
+    size_t Size() const noexcept;
+    Counters Snapshot() const noexcept;
+    void Reset() noexcept;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<WriteSession> session;
+        std::chrono::milliseconds idleTimeout;
+    };
+
+    struct State
+    {
+        mutable std::mutex mutex; // to protect everything below
+        std::unordered_map<SessionId, Entry> sessions;
+        SessionId nextId{ 0 };
+        Counters counters;
+    };
+
+    static size_t Sweep(State& state, std::chrono::steady_clock::time_point now) noexcept;
+
+    std::shared_ptr<State> m_state{ std::make_shared<State>() }; // shared with the sweep timer
+    winrt::Windows::System::Threading::ThreadPoolTimer m_timer{ nullptr };
+};